@@ -1108,6 +1108,9 @@ bool CallFunc_SetLineTexture(ACSVM::Thread *thread, const ACSVM::Word *argV, ACS
 
 	texId = R_TextureNumForName(texName);
 
+	// Start building it now so the first frame showing it doesn't have to
+	R_RequestTexture(R_GetTextureNum(texId));
+
 	TAG_ITER_LINES(tag, lineId)
 	{
 		line_t *line = &lines[lineId];
@@ -1178,6 +1181,7 @@ bool CallFunc_SetLineSpecial(ACSVM::Thread *thread, const ACSVM::Word *argV, ACS
 		}
 
 		line->special = spec;
+		Taglist_InvalidateLineSpecials();
 
 		for (i = 0; i < numArgs; i++)
 		{
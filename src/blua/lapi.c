@@ -941,6 +941,11 @@ LUA_API int lua_gc (lua_State *L, int what, int data) {
       g->gcstepmul = data;
       break;
     }
+    case LUA_GCDEFER: {
+      /* no automatic step until another `data' Kbytes are allocated */
+      g->GCthreshold = g->totalbytes + (cast(lu_mem, data) << 10);
+      break;
+    }
     default: res = -1;  /* invalid option */
   }
   lua_unlock(L);
@@ -0,0 +1,231 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#include "log_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <tracy/tracy/Tracy.hpp>
+
+using namespace srb2;
+
+// How long the writer thread sleeps between batches, unless the ring
+// is filling up faster than that.
+static constexpr auto kWakeInterval = std::chrono::milliseconds(25);
+
+// flush() gives up after this many tries if another thread is
+// draining and never finishes (e.g. it crashed mid-write).
+static constexpr int kFlushAttempts = 1000;
+
+LogWriter::LogWriter(std::FILE* file, std::size_t slots) : file_(file), enqueue_(0)
+{
+	capacity_ = 1;
+	while (capacity_ < slots)
+	{
+		capacity_ <<= 1;
+	}
+
+	slots_ = std::make_unique<Slot[]>(capacity_);
+
+	// A slot is free for position pos when its sequence is pos,
+	// and ready to read when it is pos + 1.
+	for (std::size_t i = 0; i < capacity_; i++)
+	{
+		slots_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	batch_.reserve(capacity_ * kSlotData);
+
+	thread_ = std::thread {[this] { run(); }};
+}
+
+LogWriter::~LogWriter()
+{
+	stop();
+}
+
+bool LogWriter::write(const char* text, std::size_t length) noexcept
+{
+	if (length == 0)
+	{
+		return true;
+	}
+
+	const std::size_t count = (length + kSlotData - 1) / kSlotData;
+	const std::size_t mask = capacity_ - 1;
+
+	std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		if (count > capacity_ / 2)
+		{
+			break; // would starve everyone else
+		}
+
+		// Slots are freed in order, so if the last one this message
+		// needs is free, so are all the ones before it.
+		const std::size_t last = pos + count - 1;
+		const std::size_t seq = slots_[last & mask].sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(last);
+
+		if (diff == 0)
+		{
+			if (enqueue_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					Slot& slot = slots_[(pos + i) & mask];
+					const std::size_t n = std::min(length - i * kSlotData, kSlotData);
+
+					std::memcpy(slot.data, text + i * kSlotData, n);
+					slot.length = static_cast<std::uint16_t>(n);
+					slot.sequence.store(pos + i + 1, std::memory_order_release);
+				}
+
+				written_.fetch_add(1, std::memory_order_relaxed);
+
+				if (pos + count - dequeue_.load(std::memory_order_relaxed) >= capacity_ / 2)
+				{
+					wake_.notify_one();
+				}
+
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			break; // full
+		}
+		else
+		{
+			pos = enqueue_.load(std::memory_order_relaxed);
+		}
+	}
+
+	dropped_.fetch_add(1, std::memory_order_relaxed);
+	dropped_bytes_.fetch_add(length, std::memory_order_relaxed);
+	wake_.notify_one();
+
+	return false;
+}
+
+std::size_t LogWriter::queued() const noexcept
+{
+	return enqueue_.load(std::memory_order_relaxed) - dequeue_.load(std::memory_order_relaxed);
+}
+
+bool LogWriter::drain() noexcept
+{
+	if (draining_.test_and_set(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	const std::size_t mask = capacity_ - 1;
+	std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+
+	batch_.clear();
+
+	const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+
+	if (dropped != reported_dropped_)
+	{
+		const std::string note = "[log: " + std::to_string(dropped - reported_dropped_) + " messages dropped]\n";
+
+		batch_.insert(batch_.end(), note.begin(), note.end());
+		reported_dropped_ = dropped;
+	}
+
+	// Stop at the first slot a producer is still filling. Its
+	// message, and anything queued after it, goes in the next batch.
+	for (;;)
+	{
+		Slot& slot = slots_[pos & mask];
+
+		if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+		{
+			break;
+		}
+
+		batch_.insert(batch_.end(), slot.data, slot.data + slot.length);
+		slot.sequence.store(pos + capacity_, std::memory_order_release);
+		pos++;
+	}
+
+	dequeue_.store(pos, std::memory_order_relaxed);
+
+	if (!batch_.empty())
+	{
+		std::fwrite(batch_.data(), 1, batch_.size(), file_);
+		std::fflush(file_);
+	}
+
+	draining_.clear(std::memory_order_release);
+
+	return true;
+}
+
+void LogWriter::flush() noexcept
+{
+	for (int i = 0; i < kFlushAttempts; i++)
+	{
+		if (drain())
+		{
+			return;
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+void LogWriter::stop() noexcept
+{
+	if (thread_.joinable())
+	{
+		running_.store(false, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex_);
+			wake_.notify_one();
+		}
+
+		thread_.join();
+	}
+
+	flush();
+}
+
+LogWriter::Stats LogWriter::stats() const noexcept
+{
+	return {
+		written_.load(std::memory_order_relaxed),
+		dropped_.load(std::memory_order_relaxed),
+		dropped_bytes_.load(std::memory_order_relaxed),
+	};
+}
+
+void LogWriter::run()
+{
+	tracy::SetThreadName("Log Writer");
+
+	std::unique_lock<std::mutex> lock(wake_mutex_);
+
+	while (running_.load(std::memory_order_relaxed))
+	{
+		wake_.wait_for(lock, kWakeInterval, [this] { return !running_.load(std::memory_order_relaxed) || queued() >= capacity_ / 2; });
+
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+}
@@ -0,0 +1,101 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#ifndef __SRB2_CORE_LOG_WRITER_HPP__
+#define __SRB2_CORE_LOG_WRITER_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace srb2
+{
+
+/// @brief Writes text to a FILE from a background thread, in batches.
+///
+/// Any thread can call write(). Messages go into a fixed ring of slots
+/// that producers claim with a compare-exchange, so they never block
+/// and never touch the disk. When the ring is full the message is
+/// dropped and counted, and the next batch says how many were lost.
+class LogWriter
+{
+public:
+	struct Stats
+	{
+		std::uint64_t written; ///< Messages queued for the file
+		std::uint64_t dropped; ///< Messages thrown away because the ring was full
+		std::uint64_t dropped_bytes;
+	};
+
+	static constexpr std::size_t kSlotSize = 128;
+	static constexpr std::size_t kDefaultSlots = 8192; // 1 MiB
+
+	explicit LogWriter(std::FILE* file, std::size_t slots = kDefaultSlots);
+	LogWriter(const LogWriter&) = delete;
+	~LogWriter();
+
+	LogWriter& operator=(const LogWriter&) = delete;
+
+	/// @return false if the message was dropped
+	bool write(const char* text, std::size_t length) noexcept;
+
+	/// @brief Write out everything queued so far on the calling thread.
+	/// Safe while the writer thread is running, and from the crash handler.
+	void flush() noexcept;
+
+	/// @brief Flush and stop the writer thread. write() still queues
+	/// afterwards, but nothing drains it until flush() is called.
+	void stop() noexcept;
+
+	Stats stats() const noexcept;
+
+private:
+	struct Slot
+	{
+		std::atomic<std::size_t> sequence;
+		std::uint16_t length;
+		char data[kSlotSize - sizeof(std::atomic<std::size_t>) - sizeof(std::uint16_t)];
+	};
+
+	static constexpr std::size_t kSlotData = sizeof(Slot::data);
+
+	std::FILE* file_;
+	std::unique_ptr<Slot[]> slots_;
+	std::size_t capacity_;
+
+	alignas(64) std::atomic<std::size_t> enqueue_;
+	alignas(64) std::atomic<std::size_t> dequeue_ {0}; // only advanced while holding draining_
+
+	std::atomic_flag draining_ = ATOMIC_FLAG_INIT;
+	std::vector<char> batch_;
+
+	std::atomic<std::uint64_t> written_ {0};
+	std::atomic<std::uint64_t> dropped_ {0};
+	std::atomic<std::uint64_t> dropped_bytes_ {0};
+	std::uint64_t reported_dropped_ = 0;
+
+	std::atomic<bool> running_ {true};
+	std::mutex wake_mutex_;
+	std::condition_variable wake_;
+	std::thread thread_;
+
+	std::size_t queued() const noexcept;
+	bool drain() noexcept;
+	void run();
+};
+
+} // namespace srb2
+
+#endif // __SRB2_CORE_LOG_WRITER_HPP__
@@ -22,6 +22,7 @@
 
 #include "../cxxutil.hpp"
 #include "../m_argv.h"
+#include "trace.h"
 
 using namespace srb2;
 
@@ -56,6 +57,7 @@ static void pool_executor(
 	{
 		std::string thread_name = fmt::format("Thread Pool Thread {}", thread_index);
 		tracy::SetThreadName(thread_name.c_str());
+		trace::set_thread_name("Thread Pool");
 	}
 
 	int spins = 0;
@@ -0,0 +1,364 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "../command.h"
+#include "../d_main.h" // srb2home
+#include "../doomdef.h"
+
+using namespace srb2;
+
+namespace
+{
+
+enum class EventType : uint8_t
+{
+	kBegin,
+	kEnd,
+	kCounter,
+};
+
+struct Event
+{
+	int64_t time;
+	const char* name;
+	int64_t value;
+	EventType type;
+};
+
+// An Event as it sits in the ring. The dump reads slots while their
+// thread keeps writing them, so every field is atomic, and seq says
+// which event the slot holds: 2n + 1 while event n is being written,
+// 2n + 2 once it's done.
+struct Slot
+{
+	std::atomic<uint64_t> seq {0};
+	std::atomic<int64_t> time;
+	std::atomic<const char*> name;
+	std::atomic<int64_t> value;
+	std::atomic<EventType> type;
+};
+
+// Per thread, so about 2.5 MiB each. Only allocated once a thread
+// records something.
+constexpr uint64_t kEventsPerThread = 1 << 16;
+
+struct ThreadBuffer
+{
+	std::unique_ptr<Slot[]> events {new Slot[kEventsPerThread]};
+	std::atomic<uint64_t> head {0}; // only written by the owning thread
+	uint32_t id;
+	const char* name;
+};
+
+std::mutex g_buffers_mutex;
+
+// Never freed, a thread may still be recording while the game exits.
+std::vector<ThreadBuffer*>& buffers()
+{
+	static auto* list = new std::vector<ThreadBuffer*>;
+	return *list;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local const char* t_name = nullptr;
+
+std::atomic<int64_t> g_start_time {0};
+
+int64_t now() noexcept
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadBuffer* thread_buffer()
+{
+	if (t_buffer == nullptr)
+	{
+		auto* buffer = new ThreadBuffer;
+		std::lock_guard<std::mutex> lock(g_buffers_mutex);
+
+		buffer->id = static_cast<uint32_t>(buffers().size() + 1);
+		buffer->name = t_name;
+		buffers().push_back(buffer);
+		t_buffer = buffer;
+	}
+
+	return t_buffer;
+}
+
+void record(EventType type, const char* name, int64_t value) noexcept
+{
+	ThreadBuffer* buffer;
+
+	try
+	{
+		buffer = thread_buffer();
+	}
+	catch (...)
+	{
+		return;
+	}
+
+	const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	Slot& slot = buffer->events[head & (kEventsPerThread - 1)];
+
+	slot.seq.store((head * 2) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.time.store(now(), std::memory_order_relaxed);
+	slot.name.store(name, std::memory_order_relaxed);
+	slot.value.store(value, std::memory_order_relaxed);
+	slot.type.store(type, std::memory_order_relaxed);
+
+	slot.seq.store((head * 2) + 2, std::memory_order_release);
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// Copy out what a thread has recorded without stopping it. A slot
+// whose seq isn't the finished event we expect, before and after
+// copying, was being overwritten, so it's thrown away.
+std::vector<Event> snapshot(const ThreadBuffer& buffer)
+{
+	const uint64_t head = buffer.head.load(std::memory_order_acquire);
+	const uint64_t first = head > kEventsPerThread ? head - kEventsPerThread : 0;
+	std::vector<Event> events;
+
+	events.reserve(head - first);
+
+	for (uint64_t i = first; i < head; i++)
+	{
+		const Slot& slot = buffer.events[i & (kEventsPerThread - 1)];
+		const uint64_t seq = (i * 2) + 2;
+
+		if (slot.seq.load(std::memory_order_acquire) != seq)
+		{
+			continue;
+		}
+
+		const Event ev = {
+			slot.time.load(std::memory_order_relaxed),
+			slot.name.load(std::memory_order_relaxed),
+			slot.value.load(std::memory_order_relaxed),
+			slot.type.load(std::memory_order_relaxed),
+		};
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (slot.seq.load(std::memory_order_relaxed) != seq)
+		{
+			continue;
+		}
+
+		events.push_back(ev);
+	}
+
+	return events;
+}
+
+bool dump(const std::string& path, size_t& count)
+{
+	std::FILE* f = std::fopen(path.c_str(), "w");
+
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	const int64_t start = g_start_time.load(std::memory_order_relaxed);
+	std::vector<ThreadBuffer*> list;
+
+	{
+		std::lock_guard<std::mutex> lock(g_buffers_mutex);
+		list = buffers();
+	}
+
+	fmt::print(f, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fmt::print(f, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{{\"name\":\"{}\"}}}}", SRB2APPLICATION);
+
+	count = 0;
+
+	for (const ThreadBuffer* buffer : list)
+	{
+		const uint32_t tid = buffer->id;
+		int depth = 0;
+
+		if (buffer->name)
+		{
+			fmt::print(f, ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", tid, buffer->name);
+		}
+
+		for (const Event& ev : snapshot(*buffer))
+		{
+			if (ev.time < start)
+			{
+				continue;
+			}
+
+			const double ts = (ev.time - start) / 1000.0;
+
+			switch (ev.type)
+			{
+			case EventType::kBegin:
+				fmt::print(f, ",\n{{\"name\":\"{}\",\"ph\":\"B\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", ev.name, ts, tid);
+				depth++;
+				break;
+			case EventType::kEnd:
+				// The matching begin fell off the ring
+				if (depth == 0)
+				{
+					continue;
+				}
+				fmt::print(f, ",\n{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", ts, tid);
+				depth--;
+				break;
+			case EventType::kCounter:
+				fmt::print(f, ",\n{{\"name\":\"{}\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"value\":{}}}}}", ev.name, ts, tid, ev.value);
+				break;
+			}
+
+			count++;
+		}
+	}
+
+	fmt::print(f, "\n]}}\n");
+
+	const bool ok = !std::ferror(f);
+
+	std::fclose(f);
+
+	return ok;
+}
+
+} // namespace
+
+std::atomic<bool> trace::g_enabled {false};
+
+void trace::begin(const char* name) noexcept
+{
+	record(EventType::kBegin, name, 0);
+}
+
+void trace::end() noexcept
+{
+	record(EventType::kEnd, nullptr, 0);
+}
+
+void trace::counter(const char* name, int64_t value) noexcept
+{
+	if (enabled())
+	{
+		record(EventType::kCounter, name, value);
+	}
+}
+
+void trace::set_thread_name(const char* name) noexcept
+{
+	t_name = name;
+
+	if (t_buffer)
+	{
+		t_buffer->name = name;
+	}
+}
+
+int TR_Enabled(void)
+{
+	return trace::enabled();
+}
+
+void TR_Begin(const char *name)
+{
+	if (trace::enabled())
+	{
+		trace::begin(name);
+	}
+}
+
+void TR_End(void)
+{
+	// Unlike a Zone, C callers can't remember whether their begin
+	// was recorded. An end without one is dropped when dumping.
+	if (trace::enabled())
+	{
+		trace::end();
+	}
+}
+
+void TR_Counter(const char *name, int64_t value)
+{
+	trace::counter(name, value);
+}
+
+void Command_Trace_f(void)
+{
+	const char* arg = COM_Argv(1);
+
+	if (!strcasecmp(arg, "on"))
+	{
+		if (!trace::enabled())
+		{
+			g_start_time.store(now(), std::memory_order_relaxed);
+			trace::g_enabled.store(true, std::memory_order_release);
+		}
+
+		CONS_Printf("Trace recording.\n");
+	}
+	else if (!strcasecmp(arg, "off"))
+	{
+		trace::g_enabled.store(false, std::memory_order_release);
+		CONS_Printf("Trace stopped.\n");
+	}
+	else if (!strcasecmp(arg, "dump"))
+	{
+		const std::string name = COM_Argc() > 2 ? COM_Argv(2) : "trace.json";
+		const std::string path = fmt::format("{}" PATHSEP "{}", srb2home, name);
+		size_t count = 0;
+
+		if (dump(path, count))
+		{
+			CONS_Printf("Wrote %s events to %s\n", sizeu1(count), path.c_str());
+		}
+		else
+		{
+			CONS_Alert(CONS_ERROR, "trace: could not write %s\n", path.c_str());
+		}
+	}
+	else if (!strcasecmp(arg, "status"))
+	{
+		std::lock_guard<std::mutex> lock(g_buffers_mutex);
+		uint64_t total = 0;
+
+		for (const ThreadBuffer* buffer : buffers())
+		{
+			total += buffer->head.load(std::memory_order_relaxed);
+		}
+
+		CONS_Printf("Trace is %s, %s threads, %s events recorded\n",
+			trace::enabled() ? "on" : "off", sizeu1(buffers().size()), sizeu2(static_cast<size_t>(total)));
+	}
+	else
+	{
+		CONS_Printf("trace on|off: record zones and perfstats counters\n");
+		CONS_Printf("trace dump [file]: save the last %s events of each thread, for Perfetto or chrome://tracing\n", sizeu1(kEventsPerThread));
+		CONS_Printf("trace status\n");
+	}
+}
@@ -0,0 +1,103 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#ifndef __SRB2_CORE_TRACE_H__
+#define __SRB2_CORE_TRACE_H__
+
+// Event trace that works without a Tracy build, mainly so dedicated
+// servers can be profiled. Every thread records into its own ring,
+// keeping the most recent events, and "trace dump" writes them out in
+// the Chrome trace format (Perfetto, chrome://tracing, Speedscope).
+//
+// C++ files get their ZoneScoped / ZoneScopedN sites recorded just by
+// including this header instead of Tracy.hpp. Zones still go to Tracy
+// as well when it is enabled.
+//
+// Sites run thousands of times a frame, like column and span drawers,
+// use ZoneScopedLeaf instead. That only goes to Tracy, so they neither
+// push the tics out of the ring nor cost anything without Tracy.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+#include <atomic>
+
+#include <tracy/tracy/Tracy.hpp>
+
+namespace srb2::trace
+{
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() noexcept
+{
+	return g_enabled.load(std::memory_order_relaxed);
+}
+
+void begin(const char* name) noexcept;
+void end() noexcept;
+void counter(const char* name, int64_t value) noexcept;
+
+/// @brief Name the calling thread in dumps. name must outlive the program.
+void set_thread_name(const char* name) noexcept;
+
+class Zone
+{
+	bool active_;
+
+public:
+	explicit Zone(const char* name) noexcept : active_(enabled())
+	{
+		if (active_)
+		{
+			begin(name);
+		}
+	}
+
+	Zone(const Zone&) = delete;
+	Zone& operator=(const Zone&) = delete;
+
+	~Zone()
+	{
+		if (active_)
+		{
+			end();
+		}
+	}
+};
+
+} // namespace srb2::trace
+
+#undef ZoneScoped
+#undef ZoneScopedN
+
+#define ZoneScoped ZoneNamed(___tracy_scoped_zone, true); ::srb2::trace::Zone ___srb2_trace_zone(__func__)
+#define ZoneScopedN(name) ZoneNamedN(___tracy_scoped_zone, name, true); ::srb2::trace::Zone ___srb2_trace_zone(name)
+#define ZoneScopedLeaf ZoneNamed(___tracy_scoped_zone, true)
+
+extern "C" {
+
+#endif // __cplusplus
+
+// For C code. name must be a string literal or otherwise
+// outlive the trace.
+int TR_Enabled(void);
+void TR_Begin(const char *name);
+void TR_End(void);
+void TR_Counter(const char *name, int64_t value);
+
+// trace on|off|dump [file]|status
+void Command_Trace_f(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // __SRB2_CORE_TRACE_H__
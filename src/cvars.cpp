@@ -391,7 +391,12 @@ static CV_PossibleValue_t ghost2_cons_t[] = {{0, "Hide"}, {1, "Show"}, {0, NULL}
 consvar_t cv_ghost_guest     = Player("ghost_guest",     "Show").values(ghost2_cons_t);
 consvar_t cv_ghost_staff     = Player("ghost_staff",     "Show").values(ghost2_cons_t);
 
+// Addons downloaded at once from a server's http_source
+consvar_t cv_httpconnections = Player("http_connections", "4").min_max(1, 16);
+
 void ItemFinder_OnChange(void);
+consvar_t cv_luahudinterp = Player("luahudinterp", "Off").on_off().description("Smooth the movement of Lua HUD graphics between game tics");
+
 consvar_t cv_itemfinder = Player("itemfinder", "Off").flags(CV_NOSHOWHELP).on_off().onchange(ItemFinder_OnChange).dont_save();
 
 consvar_t cv_maxportals = Player("maxportals", "2").values({{0, "MIN"}, {12, "MAX"}}); // lmao rendering 32 portals, you're a card
@@ -560,6 +565,14 @@ static constexpr const char* kNetDemoRecordDefault =
 
 consvar_t cv_recordmultiplayerdemos = Server("netdemo_record", kNetDemoRecordDefault).values({{0, "Disabled"}, {1, "Manual Save"}, {2, "Auto Save"}});
 
+// Save rewind points next to replays for faster seeking. Off by default,
+// since each file holds a netsave per point and can be several MB.
+consvar_t cv_replaykeyframes = Server("replaykeyframes", "Off").on_off();
+
+// Save replays in block-compressed form. Builds from before this can't
+// read those, even though they have the same demo version.
+consvar_t cv_replaycompression = Server("replaycompression", "Off").on_off();
+
 consvar_t cv_reducevfx = Server("reducevfx", "No").yes_no();
 consvar_t cv_screenshake = Server("screenshake", "Full").values({{0, "Off"}, {1, "Half"}, {2, "Full"}});
 
@@ -858,6 +871,7 @@ consvar_t cv_ufo_health = OnlineCheat("ufo_health", "-1").min_max(-1, 100).descr
 //
 
 consvar_t cv_botscanvote = ServerCheat("botscanvote", "No").yes_no();
+consvar_t cv_debugsubsectorgrid = ServerCheat("debugsubsectorgrid", "Off").on_off().description("Check every subsector grid lookup against a full BSP walk");
 
 void Gravity_OnChange(void);
 consvar_t cv_gravity = ServerCheat("gravity", "0.8").floating_point().onchange(Gravity_OnChange).description("Change the default gravity"); // change DEFAULT_GRAVITY if you change this
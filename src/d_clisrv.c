@@ -70,6 +70,7 @@
 #include "sanitize.h"
 #include "r_fps.h"
 #include "filesrch.h" // refreshdirmenu
+#include "core/trace.h"
 
 // cl loading screen
 #include "v_video.h"
@@ -1985,43 +1986,23 @@ static boolean CL_ServerConnectionTicker(const char *tmpsave, tic_t *oldtic, tic
 		case CL_PREPAREHTTPFILES:
 			if (http_source[0])
 			{
-				for (i = 0; i < fileneedednum; i++)
-					if (fileneeded[i].status == FS_NOTFOUND || fileneeded[i].status == FS_MD5SUMBAD)
-					{
-						curl_transfers++;
-					}
-
+				CURLStartDownloads(http_source);
 				cl_mode = CL_DOWNLOADHTTPFILES;
 			}
 			break;
 
 		case CL_DOWNLOADHTTPFILES:
-			waitmore = false;
-			for (i = 0; i < fileneedednum; i++)
-				if (fileneeded[i].status == FS_NOTFOUND || fileneeded[i].status == FS_MD5SUMBAD)
-				{
-					if (!curl_running)
-						CURLPrepareFile(http_source, i);
-					waitmore = true;
-					break;
-				}
-
-			if (curl_running)
-				CURLGetFile();
-
-			if (waitmore)
+			if (CURLUpdateDownloads())
 				break; // exit the case
 
-			if (curl_failedwebdownload && !curl_transfers)
+			if (curl_failedwebdownload)
 			{
 				CONS_Printf("One or more files failed to download, falling back to internal downloader\n");
 				cl_mode = CL_CHECKFILES;
 				break;
 			}
 
-			if (!curl_transfers)
-				cl_mode = CL_LOADFILES;
-
+			cl_mode = CL_LOADFILES;
 			break;
 #endif
 		case CL_DOWNLOADFILES:
@@ -2635,9 +2616,8 @@ void CL_Reset(void)
 	expectChallenge = false;
 
 #ifdef HAVE_CURL
+	CURLStopDownloads();
 	curl_failedwebdownload = false;
-	curl_transfers = 0;
-	curl_running = false;
 	http_source[0] = '\0';
 #endif
 
@@ -6103,6 +6083,7 @@ boolean TryRunTics(tic_t realtics)
 
 			ps_prevtictime = ps_tictime;
 			ps_tictime = I_GetPreciseTime();
+			TR_Begin("Tic");
 
 			dontRun = ExtraDataTicker();
 
@@ -6149,6 +6130,8 @@ boolean TryRunTics(tic_t realtics)
 			consistancy[gametic % BACKUPTICS] = Consistancy();
 
 			ps_tictime = I_GetPreciseTime() - ps_tictime;
+			TR_End();
+			PS_TraceTicCounters();
 
 			// Leave a certain amount of tics present in the net buffer as long as we've ran at least one tic this frame.
 			if (client && gamestate == GS_LEVEL && leveltime > 1 && neededtic <= gametic + cv_netticbuffer.value)
@@ -6574,6 +6557,9 @@ void NetKeepAlive(void)
 	Net_AckTicker();
 	HandleNodeTimeouts();
 	FileSendTicker();
+
+	if (I_NetFlush)
+		I_NetFlush();
 }
 
 // If a tree falls in the forest but nobody is around to hear it, does it make a tic?
@@ -6759,6 +6745,9 @@ void NetUpdate(void)
 	}
 
 	FileSendTicker();
+
+	if (I_NetFlush)
+		I_NetFlush();
 }
 
 /** Returns the number of players playing.
@@ -6801,64 +6790,157 @@ tic_t GetLag(INT32 node)
 	return gametic - nettics[node];
 }
 
-#define REWIND_POINT_INTERVAL 4*TICRATE + 16
 rewind_t *rewindhead;
 
+// P_SaveNetGame and P_LoadNetGame work on this, points only keep
+// the compressed copy.
+static UINT8 *rewindscratch;
+
+static void CL_FreeRewindPoint(rewind_t *rewind)
+{
+	free(rewind->savebuffer);
+	free(rewind);
+}
+
 void CL_ClearRewinds(void)
 {
 	rewind_t *head;
 	while ((head = rewindhead))
 	{
 		rewindhead = rewindhead->next;
-		free(head);
+		CL_FreeRewindPoint(head);
+	}
+}
+
+rewind_t *CL_GetRewindPoints(void)
+{
+	return rewindhead;
+}
+
+rewind_t *CL_FindRewindPoint(tic_t time)
+{
+	rewind_t *rewind = rewindhead;
+
+	while (rewind && rewind->leveltime > time)
+		rewind = rewind->next;
+
+	return rewind;
+}
+
+boolean CL_AddRewindPoint(rewind_t *rewind)
+{
+	rewind_t **link = &rewindhead;
+
+	while (*link && (*link)->leveltime > rewind->leveltime)
+		link = &(*link)->next;
+
+	if (*link && (*link)->leveltime == rewind->leveltime)
+	{
+		CL_FreeRewindPoint(rewind);
+		return false;
 	}
+
+	rewind->next = *link;
+	*link = rewind;
+
+	return true;
 }
 
 rewind_t *CL_SaveRewindPoint(size_t demopos)
 {
 	savebuffer_t save = {0};
-	rewind_t *rewind;
-
-	if (rewindhead && rewindhead->leveltime + REWIND_POINT_INTERVAL > leveltime)
+	rewind_t *rewind, *prev, *next;
+	UINT8 *packed;
+	size_t rawsize, packedsize;
+
+	// Points can come in out of order after seeking, or from a
+	// replay's saved keyframes, so check both neighbours.
+	prev = CL_FindRewindPoint(leveltime);
+	if (prev && prev->leveltime + REWIND_POINT_INTERVAL > leveltime)
 		return NULL;
 
-	rewind = (rewind_t *)malloc(sizeof (rewind_t));
-	if (!rewind)
+	for (next = rewindhead; next && next != prev; next = next->next)
+	{
+		if (next->leveltime < leveltime + REWIND_POINT_INTERVAL)
+			return NULL;
+	}
+
+	if (!rewindscratch && !(rewindscratch = (UINT8 *)malloc(NETSAVEGAMESIZE)))
 		return NULL;
 
-	P_SaveBufferFromExisting(&save, rewind->savebuffer, NETSAVEGAMESIZE);
+	P_SaveBufferFromExisting(&save, rewindscratch, NETSAVEGAMESIZE);
 	P_SaveNetGame(&save, false);
+	rawsize = save.p - save.buffer;
 
+	rewind = (rewind_t *)calloc(1, sizeof (rewind_t));
+	packed = (UINT8 *)malloc(rawsize);
+	if (!rewind || !packed)
+	{
+		free(rewind);
+		free(packed);
+		return NULL;
+	}
+
+	// Savegames are mostly zeroes and repeated fields, which lzf
+	// usually packs down to a third or less.
+	packedsize = lzf_compress(rewindscratch, rawsize, packed, rawsize - 1);
+	if (packedsize == 0)
+	{
+		M_Memcpy(packed, rewindscratch, rawsize);
+		packedsize = rawsize;
+	}
+	else
+	{
+		UINT8 *shrunk = (UINT8 *)realloc(packed, packedsize);
+		if (shrunk)
+			packed = shrunk;
+	}
+
+	rewind->savebuffer = packed;
+	rewind->savesize = packedsize;
+	rewind->rawsize = rawsize;
 	rewind->leveltime = leveltime;
-	rewind->next = rewindhead;
 	rewind->demopos = demopos;
-	rewindhead = rewind;
+
+	CL_AddRewindPoint(rewind);
 
 	return rewind;
 }
 
-rewind_t *CL_RewindToTime(tic_t time)
+boolean CL_LoadRewindPoint(const rewind_t *rewind)
 {
 	savebuffer_t save = {0};
-	rewind_t *rewind;
 
-	while (rewindhead && rewindhead->leveltime > time)
-	{
-		rewind = rewindhead->next;
-		free(rewindhead);
-		rewindhead = rewind;
-	}
+	if (rewind->rawsize > NETSAVEGAMESIZE)
+		return false;
 
-	if (!rewindhead)
-		return NULL;
+	if (!rewindscratch && !(rewindscratch = (UINT8 *)malloc(NETSAVEGAMESIZE)))
+		return false;
 
-	P_SaveBufferFromExisting(&save, rewindhead->savebuffer, NETSAVEGAMESIZE);
-	P_LoadNetGame(&save, false);
+	if (rewind->savesize == rewind->rawsize)
+		M_Memcpy(rewindscratch, rewind->savebuffer, rewind->rawsize);
+	else if (lzf_decompress(rewind->savebuffer, rewind->savesize, rewindscratch, NETSAVEGAMESIZE) != rewind->rawsize)
+		return false;
+
+	P_SaveBufferFromExisting(&save, rewindscratch, rewind->rawsize);
+	if (!P_LoadNetGame(&save, false))
+		return false;
 
 	wipegamestate = gamestate; // No fading back in!
 	timeinmap = leveltime;
 
-	return rewindhead;
+	return true;
+}
+
+rewind_t *CL_RewindToTime(tic_t time)
+{
+	rewind_t *rewind = CL_FindRewindPoint(time);
+
+	// Later points are kept, seeking forward again can use them.
+	if (!rewind || !CL_LoadRewindPoint(rewind))
+		return NULL;
+
+	return rewind;
 }
 
 void D_MD5PasswordPass(const UINT8 *buffer, size_t len, const char *salt, void *dest)
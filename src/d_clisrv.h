@@ -477,6 +477,7 @@ extern INT32 mapchangepending;
 extern doomdata_t *netbuffer;
 extern consvar_t cv_stunserver;
 extern consvar_t cv_httpsource;
+extern consvar_t cv_httpconnections;
 extern consvar_t cv_kicktime;
 
 extern consvar_t cv_showjoinaddress;
@@ -679,21 +680,38 @@ extern boolean hu_stopped;
 // SRB2Kart
 //
 
+#define REWIND_POINT_INTERVAL (4*TICRATE + 16)
+
 struct rewind_t {
-	UINT8 savebuffer[NETSAVEGAMESIZE];
+	UINT8 *savebuffer; // lzf compressed, unless savesize == rawsize
+	size_t savesize;
+	size_t rawsize;
 	tic_t leveltime;
 	size_t demopos;
 
 	ticcmd_t oldcmd[MAXPLAYERS];
 	mobj_t oldghost[MAXPLAYERS];
 
-	rewind_t *next;
+	rewind_t *next; // earlier leveltime
 };
 
 void CL_ClearRewinds(void);
 rewind_t *CL_SaveRewindPoint(size_t demopos);
 rewind_t *CL_RewindToTime(tic_t time);
 
+// Latest rewind point at or before time, NULL if there is none
+rewind_t *CL_FindRewindPoint(tic_t time);
+
+// Newest first
+rewind_t *CL_GetRewindPoints(void);
+
+// Takes ownership of a point made outside CL_SaveRewindPoint,
+// savebuffer must come from malloc. Returns false (and frees it)
+// if there is already a point at that time.
+boolean CL_AddRewindPoint(rewind_t *rewind);
+
+boolean CL_LoadRewindPoint(const rewind_t *rewind);
+
 void HandleSigfail(const char *string);
 
 void DoSayPacket(SINT8 target, UINT8 flags, UINT8 source, char *message);
@@ -16,7 +16,7 @@
 ///        plus functions to parse command line parameters, configure game
 ///        parameters, and call the startup functions.
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #if (defined (__unix__) && !defined (MSDOS)) || defined(__APPLE__) || defined (UNIXCOMMON)
 #include <sys/stat.h>
@@ -40,6 +40,7 @@
 #include "d_net.h"
 #include "f_finale.h"
 #include "g_game.h"
+#include "g_gamedata.h"
 #include "hu_stuff.h"
 #include "i_joy.h"
 #include "i_sound.h"
@@ -802,6 +803,10 @@ static bool D_Display(bool world)
 
 			s[sizeof s - 1] = '\0';
 
+			snprintf(s, sizeof s - 1, "pkts %.1f/%.1f tic", getpacketspertic, sendpacketspertic);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-60, V_YELLOWMAP, s);
+			snprintf(s, sizeof s - 1, "syscalls %.1f/tic", netsyscallspertic);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-50, V_YELLOWMAP, s);
 			snprintf(s, sizeof s - 1, "get %d b/s", getbps);
 			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-40, V_YELLOWMAP, s);
 			snprintf(s, sizeof s - 1, "send %d b/s", sendbps);
@@ -954,6 +959,8 @@ void D_SRB2Loop(void)
 				TryRunTics(realtics);
 			}
 
+			G_UpdateSaves();
+
 			if (lastdraw || singletics || gametic > rendergametic)
 			{
 				rendergametic = gametic;
@@ -1072,8 +1079,6 @@ void D_SRB2Loop(void)
 			S_TickSoundTest();
 		}
 
-		LUA_Step();
-
 #ifdef HAVE_DISCORDRPC
 		if (! dedicated)
 		{
@@ -1083,6 +1088,10 @@ void D_SRB2Loop(void)
 
 		Music_Tick();
 
+		// Spend whatever is left of this frame's budget on Lua garbage collection.
+		// Without a framerate cap there is no budget, so only the minimum is done.
+		LUA_Step(R_GetFramerateCap() > 0 ? enterprecise + capbudget : 0);
+
 		// Fully completed frame made.
 		finishprecise = I_GetPreciseTime();
 
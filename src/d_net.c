@@ -76,6 +76,7 @@ boolean (*I_NetGet)(void) = NULL;
 void (*I_NetSend)(void) = NULL;
 boolean (*I_NetCanSend)(void) = NULL;
 boolean (*I_NetCanGet)(void) = NULL;
+void (*I_NetFlush)(void) = NULL;
 void (*I_NetCloseSocket)(void) = NULL;
 void (*I_NetFreeNodenum)(INT32 nodenum) = NULL;
 SINT8 (*I_NetMakeNodewPort)(const char *address, const char* port) = NULL;
@@ -92,6 +93,8 @@ bannednode_t *bannednode = NULL;
 static tic_t statstarttic;
 INT32 getbytes = 0;
 INT64 sendbytes = 0;
+INT32 getpackets = 0, sendpackets = 0;
+INT32 netsyscalls = 0;
 static INT32 retransmit = 0, duppacket = 0;
 static INT32 sendackpacket = 0, getackpacket = 0;
 INT32 ticruned = 0, ticmiss = 0;
@@ -100,6 +103,7 @@ boolean packetloss[MAXPLAYERS][PACKETMEASUREWINDOW];
 
 // globals
 INT32 getbps, sendbps;
+float getpacketspertic, sendpacketspertic, netsyscallspertic;
 float lostpercent, duppercent, gamelostpercent;
 INT32 packetheaderlength;
 
@@ -113,6 +117,9 @@ boolean Net_GetNetStat(void)
 		const INT64 newsendbyte = sendbytes - oldsendbyte;
 		sendbps = (INT32)(newsendbyte*TICRATE)/df;
 		getbps = (getbytes*TICRATE)/df;
+		getpacketspertic = (float)getpackets/(float)df;
+		sendpacketspertic = (float)sendpackets/(float)df;
+		netsyscallspertic = (float)netsyscalls/(float)df;
 		if (sendackpacket)
 			lostpercent = 100.0f*(float)retransmit/(float)sendackpacket;
 		else
@@ -129,6 +136,7 @@ boolean Net_GetNetStat(void)
 		ticmiss = ticruned = 0;
 		oldsendbyte = sendbytes;
 		getbytes = 0;
+		getpackets = sendpackets = netsyscalls = 0;
 		sendackpacket = getackpacket = duppacket = retransmit = 0;
 		statstarttic = t;
 
@@ -1143,6 +1151,7 @@ boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlen
 
 	netbuffer->checksum = NetbufferChecksum();
 	sendbytes += packetheaderlength + doomcom->datalength; // For stat
+	sendpackets++;
 
 #ifdef PACKETDROP
 	// Simulate internet :)
@@ -1210,6 +1219,7 @@ boolean HGetPacket(void)
 			return false;
 
 		getbytes += packetheaderlength + doomcom->datalength; // For stat
+		getpackets++;
 
 		if (doomcom->remotenode >= MAXNETNODES)
 		{
@@ -1332,6 +1342,7 @@ boolean D_CheckNetGame(void)
 	I_NetGet = Internal_Get;
 	I_NetSend = Internal_Send;
 	I_NetCanSend = NULL;
+	I_NetFlush = NULL;
 	I_NetCloseSocket = NULL;
 	I_NetFreeNodenum = Internal_FreeNodenum;
 	I_NetMakeNodewPort = NULL;
@@ -1542,6 +1553,7 @@ void D_CloseConnection(void)
 		I_NetGet = Internal_Get;
 		I_NetSend = Internal_Send;
 		I_NetCanSend = NULL;
+		I_NetFlush = NULL;
 		I_NetCloseSocket = NULL;
 		I_NetFreeNodenum = Internal_FreeNodenum;
 		I_NetMakeNodewPort = NULL;
@@ -42,6 +42,9 @@ extern INT32 packetheaderlength;
 boolean Net_GetNetStat(void);
 extern INT32 getbytes;
 extern INT64 sendbytes; // Realtime updated
+extern INT32 getpackets, sendpackets; // Realtime updated
+extern INT32 netsyscalls; // Socket calls made by the network driver, realtime updated
+extern float getpacketspertic, sendpacketspertic, netsyscallspertic;
 
 #define PACKETMEASUREWINDOW (TICRATE*2)
 extern boolean packetloss[MAXPLAYERS][PACKETMEASUREWINDOW];
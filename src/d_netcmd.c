@@ -20,6 +20,7 @@
 #include "i_time.h"
 #include "i_system.h"
 #include "g_game.h"
+#include "g_gamedata.h" // Command_SaveBench_f
 #include "hu_stuff.h"
 #include "g_input.h"
 #include "k_menu.h"
@@ -46,6 +47,8 @@
 #include "z_zone.h"
 #include "lua_script.h"
 #include "lua_hook.h"
+#include "lua_alloc.h"
+#include "core/trace.h"
 #include "m_cond.h"
 #include "m_anigif.h"
 #include "md5.h"
@@ -61,6 +64,8 @@
 #include "k_follower.h"
 #include "doomstat.h"
 #include "deh_tables.h"
+#include "deh_lua.h" // Command_LuaEnumBench_f
+#include "deh_soc.h" // Command_SOCBench_f
 #include "m_perfstats.h"
 #include "k_specialstage.h"
 #include "k_race.h"
@@ -115,6 +120,7 @@ static void Got_Cheat(const UINT8 **cp, INT32 playernum);
 static void Command_Playdemo_f(void);
 static void Command_Timedemo_f(void);
 static void Command_Stopdemo_f(void);
+static void Command_Seekdemo_f(void);
 static void Command_StartMovie_f(void);
 static void Command_StartLossless_f(void);
 static void Command_StopMovie_f(void);
@@ -431,6 +437,13 @@ void D_RegisterServerCommands(void)
 #endif
 
 	COM_AddDebugCommand("downloads", Command_Downloads_f);
+	COM_AddDebugCommand("luaallocbench", Command_LuaAllocBench_f);
+	COM_AddDebugCommand("luafieldbench", Command_LuaFieldBench_f);
+	COM_AddDebugCommand("luaenumbench", Command_LuaEnumBench_f);
+	COM_AddDebugCommand("socbench", Command_SOCBench_f);
+	COM_AddDebugCommand("savebench", Command_SaveBench_f);
+	COM_AddDebugCommand("condbench", Command_CondBench_f);
+	COM_AddDebugCommand("netloadbench", Command_NetLoadBench_f);
 
 	COM_AddDebugCommand("give", Command_KartGiveItem_f);
 	COM_AddDebugCommand("give2", Command_KartGiveItem_f);
@@ -516,6 +529,9 @@ void D_RegisterClientCommands(void)
 	COM_AddCommand("playdemo", Command_Playdemo_f);
 	COM_AddCommand("timedemo", Command_Timedemo_f);
 	COM_AddCommand("stopdemo", Command_Stopdemo_f);
+	COM_AddCommand("seekdemo", Command_Seekdemo_f);
+	COM_AddCommand("convertreplay", Command_ConvertReplay_f);
+	COM_AddCommand("trace", Command_Trace_f);
 	COM_AddCommand("playintro", Command_Playintro_f);
 
 	COM_AddDebugCommand("resetcamera", Command_ResetCamera_f);
@@ -2178,6 +2194,28 @@ static void Command_Stopdemo_f(void)
 	CONS_Printf(M_GetText("Stopped demo.\n"));
 }
 
+// jump to a time in the current demo
+static void Command_Seekdemo_f(void)
+{
+	tic_t target;
+
+	if (COM_Argc() != 2)
+	{
+		CONS_Printf(M_GetText("seekdemo <seconds>: jump to a race time in the current demo\n"));
+		return;
+	}
+
+	if (!demo.playback || demo.attract || gamestate != GS_LEVEL)
+	{
+		CONS_Printf(M_GetText("You can only seek while watching a replay.\n"));
+		return;
+	}
+
+	target = starttime + (tic_t)(max(0.0, atof(COM_Argv(1))) * TICRATE);
+
+	G_ConfirmRewind(target);
+}
+
 static void Command_StartMovie_f(void)
 {
 	M_StartMovie(MM_AVRECORDER);
@@ -32,9 +32,6 @@
 #include <sys/utime.h>
 #endif
 
-#ifdef HAVE_CURL
-#include "curl/curl.h"
-#endif
 
 #include "doomdef.h"
 #include "doomstat.h"
@@ -54,6 +51,7 @@
 #include "k_menu.h"
 #include "md5.h"
 #include "filesrch.h"
+#include "w_filecache.h"
 #include "stun.h"
 
 #include <errno.h>
@@ -61,11 +59,6 @@
 // Prototypes
 static boolean AddFileToSendQueue(INT32 node, const char *filename, UINT8 fileid);
 
-#ifdef HAVE_CURL
-static size_t curlwrite_data(void *ptr, size_t size, size_t nmemb, FILE *stream);
-static int curlprogress_callback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
-#endif
-
 // Sender structure
 typedef struct filetx_s
 {
@@ -121,19 +114,6 @@ INT32 totalfilesrequestednum = 0;
 UINT32 totalfilesrequestedsize = 0;
 
 #ifdef HAVE_CURL
-static CURL *http_handle;
-static CURLM *multi_handle;
-boolean curl_running = false;
-boolean curl_failedwebdownload = false;
-static curl_off_t curl_dlnow;
-static curl_off_t curl_dltotal;
-static time_t curl_starttime;
-INT32 curl_transfers = 0;
-static int curl_runninghandles = 0;
-static UINT32 curl_origfilesize;
-static UINT32 curl_origtotalfilesize;
-static char *curl_realname = NULL;
-fileneeded_t *curl_curfile = NULL;
 HTTP_login *curl_logins;
 #endif
 
@@ -589,6 +569,20 @@ INT32 CL_CheckFiles(void)
 		return 1;
 	}
 
+	// Files are checked one per tic, but hash anything they might match
+	// all at once, across the thread pool, before the first.
+	if (fileneedednum && fileneeded[0].status == FS_NOTCHECKED)
+	{
+		static const char *names[MAX_WADFILES];
+		size_t count = 0;
+
+		for (i = 0; i < fileneedednum; i++)
+			if (fileneeded[i].status == FS_NOTCHECKED)
+				names[count++] = fileneeded[i].filename;
+
+		W_CacheIndexedMD5s(names, count);
+	}
+
 	for (i = 0; i < fileneedednum; i++)
 	{
 		if (fileneeded[i].status == FS_NOTFOUND || fileneeded[i].status == FS_MD5SUMBAD || fileneeded[i].status == FS_FALLBACK)
@@ -1721,17 +1715,13 @@ filestatus_t checkfilemd5(char *filename, const UINT8 *wantedmd5sum)
 	(void)wantedmd5sum;
 	(void)filename;
 #else
-	FILE *fhandle;
 	UINT8 md5sum[16];
 
 	if (!wantedmd5sum)
 		return FS_FOUND;
 
-	fhandle = fopen(filename, "rb");
-	if (fhandle)
+	if (W_CachedFileMD5(filename, md5sum))
 	{
-		md5_stream(fhandle,md5sum);
-		fclose(fhandle);
 		if (!memcmp(wantedmd5sum, md5sum, 16))
 			return FS_FOUND;
 		return FS_MD5SUMBAD;
@@ -1742,231 +1732,14 @@ filestatus_t checkfilemd5(char *filename, const UINT8 *wantedmd5sum)
 	return FS_FOUND; // will never happen, but makes the compiler shut up
 }
 
-// Rewritten by Monster Iestyn to be less stupid
 // Note: if completepath is true, "filename" is modified, but only if FS_FOUND is going to be returned
-// (Don't worry about WinCE's version of filesearch, nobody cares about that OS anymore)
+// Searches srb2home, then srb2path, then ".", through the index in w_filecache.cpp
 filestatus_t findfile(char *filename, const UINT8 *wantedmd5sum, boolean completepath)
 {
-	filestatus_t homecheck; // store result of last file search
-	boolean badmd5 = false; // store whether md5 was bad from either of the first two searches (if nothing was found in the third)
-
-	// first, check SRB2's "home" directory
-	homecheck = filesearch(filename, srb2home, wantedmd5sum, completepath, 10);
-
-	if (homecheck == FS_FOUND) // we found the file, so return that we have :)
-		return FS_FOUND;
-	else if (homecheck == FS_MD5SUMBAD) // file has a bad md5; move on and look for a file with the right md5
-		badmd5 = true;
-	// if not found at all, just move on without doing anything
-
-	// next, check SRB2's "path" directory
-	homecheck = filesearch(filename, srb2path, wantedmd5sum, completepath, 10);
-
-	if (homecheck == FS_FOUND) // we found the file, so return that we have :)
-		return FS_FOUND;
-	else if (homecheck == FS_MD5SUMBAD) // file has a bad md5; move on and look for a file with the right md5
-		badmd5 = true;
-	// if not found at all, just move on without doing anything
-
-	// finally check "." directory
-	homecheck = filesearch(filename, ".", wantedmd5sum, completepath, 10);
-
-	if (homecheck != FS_NOTFOUND) // if not found this time, fall back on the below return statement
-		return homecheck; // otherwise return the result we got
-
-	return (badmd5 ? FS_MD5SUMBAD : FS_NOTFOUND); // md5 sum bad or file not found
+	return W_FindIndexedFile(filename, wantedmd5sum, completepath);
 }
 
 #ifdef HAVE_CURL
-static size_t curlwrite_data(void *ptr, size_t size, size_t nmemb, FILE *stream)
-{
-    size_t written;
-    written = fwrite(ptr, size, nmemb, stream);
-    return written;
-}
-
-static int curlprogress_callback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
-{
-	time_t curtime;
-
-	(void)clientp;
-	(void)ultotal;
-	(void)ulnow; // Function prototype requires these but we won't use, so just discard
-
-	curtime = time(NULL);
-
-	curl_dlnow = dlnow;
-	curl_dltotal = dltotal;
-
-	if (curtime > curl_starttime)
-	{
-		getbytes = curl_dlnow / (curtime - curl_starttime); // To-do: Make this more accurate???
-	}
-	else
-	{
-		getbytes = 0;
-	}
-	return 0;
-}
-
-void CURLPrepareFile(const char* url, int dfilenum)
-{
-	HTTP_login *login;
-
-#ifdef PARANOIA
-	if (M_CheckParm("-nodownload"))
-		I_Error("Attempted to download files in -nodownload mode");
-#endif
-
-	curl_global_init(CURL_GLOBAL_ALL);
-
-	http_handle = curl_easy_init();
-	multi_handle = curl_multi_init();
-
-	if (http_handle && multi_handle)
-	{
-		I_mkdir(downloaddir, 0755);
-
-		curl_curfile = &fileneeded[dfilenum];
-		curl_realname = curl_curfile->filename;
-		nameonly(curl_realname);
-
-		curl_origfilesize = curl_curfile->currentsize;
-		curl_origtotalfilesize = curl_curfile->totalsize;
-
-		curl_easy_setopt(http_handle, CURLOPT_URL, va("%s/%s", url, curl_realname));
-
-		// Only allow HTTP and HTTPS
-#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
-		curl_easy_setopt(http_handle, CURLOPT_PROTOCOLS_STR, "http,https");
-#else
-		curl_easy_setopt(http_handle, CURLOPT_PROTOCOLS, CURLPROTO_HTTP|CURLPROTO_HTTPS); // deprecated in 7.85.0
-#endif
-
-		curl_easy_setopt(http_handle, CURLOPT_USERAGENT, va("Ring Racers/v%d.%d", VERSION, SUBVERSION)); // Set user agent as some servers won't accept invalid user agents.
-
-		// Authenticate if the user so wishes
-		login = CURLGetLogin(url, NULL);
-
-		if (login)
-		{
-			curl_easy_setopt(http_handle, CURLOPT_USERPWD, login->auth);
-		}
-
-		// Follow a redirect request, if sent by the server.
-		curl_easy_setopt(http_handle, CURLOPT_FOLLOWLOCATION, 1L);
-
-		curl_easy_setopt(http_handle, CURLOPT_FAILONERROR, 1L);
-
-		CONS_Printf("Downloading %s from %s\n", curl_realname, url);
-
-		strcatbf(curl_curfile->filename, downloaddir, "/");
-		curl_curfile->file = fopen(curl_curfile->filename, "wb");
-		curl_easy_setopt(http_handle, CURLOPT_WRITEDATA, curl_curfile->file);
-		curl_easy_setopt(http_handle, CURLOPT_WRITEFUNCTION, curlwrite_data);
-		curl_easy_setopt(http_handle, CURLOPT_NOPROGRESS, 0L);
-		curl_easy_setopt(http_handle, CURLOPT_XFERINFOFUNCTION, curlprogress_callback);
-
-		curl_curfile->status = FS_DOWNLOADING;
-		lastfilenum = dfilenum;
-		curl_multi_add_handle(multi_handle, http_handle);
-
-		curl_multi_perform(multi_handle, &curl_runninghandles);
-		curl_starttime = time(NULL);
-		curl_running = true;
-	}
-}
-
-void CURLGetFile(void)
-{
-	CURLMcode mc; /* return code used by curl_multi_wait() */
-	CURLcode easyres; /* Return from easy interface */
-	int numfds;
-	CURLMsg *m; /* for picking up messages with the transfer status */
-	CURL *e;
-	int msgs_left; /* how many messages are left */
-	const char *easy_handle_error;
-	long response_code = 0;
-	static char *filename;
-
-    if (curl_runninghandles)
-    {
-    	curl_multi_perform(multi_handle, &curl_runninghandles);
-
-		/* wait for activity, timeout or "nothing" */
-		mc = curl_multi_wait(multi_handle, NULL, 0, 1000, &numfds);
-
-		if (mc != CURLM_OK)
-		{
-			CONS_Alert(CONS_WARNING, "curl_multi_wait() failed, code %d.\n", mc);
-			return;
-		}
-		curl_curfile->currentsize = curl_dlnow;
-		curl_curfile->totalsize = curl_dltotal;
-    }
-
-    /* See how the transfers went */
-	while ((m = curl_multi_info_read(multi_handle, &msgs_left)))
-	{
-		if (m && (m->msg == CURLMSG_DONE))
-		{
-			e = m->easy_handle;
-			easyres = m->data.result;
-			filename = Z_StrDup(curl_realname);
-			nameonly(filename);
-			if (easyres != CURLE_OK)
-			{
-				if (easyres == CURLE_HTTP_RETURNED_ERROR)
-					curl_easy_getinfo(e, CURLINFO_RESPONSE_CODE, &response_code);
-
-				easy_handle_error = (response_code) ? va("HTTP reponse code %ld", response_code) : curl_easy_strerror(easyres);
-				curl_curfile->status = FS_FALLBACK;
-				curl_curfile->currentsize = curl_origfilesize;
-				curl_curfile->totalsize = curl_origtotalfilesize;
-				curl_failedwebdownload = true;
-				fclose(curl_curfile->file);
-				remove(curl_curfile->filename);
-				CONS_Printf(M_GetText("Failed to download %s (%s)\n"), filename, easy_handle_error);
-			}
-			else
-			{
-				fclose(curl_curfile->file);
-
-				if (checkfilemd5(curl_curfile->filename, curl_curfile->md5sum) == FS_MD5SUMBAD)
-				{
-					CONS_Alert(CONS_ERROR, M_GetText("HTTP Download of %s finished but is corrupt or has been modified\n"), filename);
-					curl_curfile->status = FS_FALLBACK;
-					curl_failedwebdownload = true;
-				}
-				else
-				{
-					CONS_Printf(M_GetText("Finished HTTP download of %s\n"), filename);
-					downloadcompletednum++;
-					downloadcompletedsize += curl_curfile->totalsize;
-					curl_curfile->status = FS_FOUND;
-				}
-			}
-
-
-			Z_Free(filename);
-			curl_curfile->file = NULL;
-			curl_running = false;
-			curl_transfers--;
-			curl_multi_remove_handle(multi_handle, e);
-			curl_easy_cleanup(e);
-
-			if (!curl_transfers)
-				break;
-		}
-	}
-
-    if (!curl_transfers)
-    {
-		curl_multi_cleanup(multi_handle);
-		curl_global_cleanup();
-    }
-}
-
 HTTP_login *
 CURLGetLogin (const char *url, HTTP_login ***return_prev_next)
 {
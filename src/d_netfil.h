@@ -74,8 +74,7 @@ extern UINT32 totalfilesrequestedsize;
 
 #ifdef HAVE_CURL
 extern boolean curl_failedwebdownload;
-extern boolean curl_running;
-extern INT32 curl_transfers;
+extern INT32 curl_transfers; // not yet finished
 
 extern struct HTTP_login
 {
@@ -165,8 +164,14 @@ void nameonly(char *s);
 size_t nameonlylength(const char *s);
 
 #ifdef HAVE_CURL
-void CURLPrepareFile(const char* url, int dfilenum);
-void CURLGetFile(void);
+// d_netfil_http.cpp
+// Every missing file downloads in the background, cv_httpconnections at a time.
+// CURLUpdateDownloads copies progress into fileneeded[] and returns false once
+// all of them are done.
+void CURLStartDownloads(const char *url);
+boolean CURLUpdateDownloads(void);
+void CURLStopDownloads(void);
+
 HTTP_login * CURLGetLogin (const char *url, HTTP_login ***return_prev_next);
 #endif
 
@@ -0,0 +1,498 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  d_netfil_http.cpp
+/// \brief Background HTTP downloads of server addons
+
+#ifdef HAVE_CURL
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "curl/curl.h"
+
+#include "doomdef.h"
+#include "console.h"
+#include "d_clisrv.h" // cv_httpconnections
+#include "d_net.h" // getbytes
+#include "d_netfil.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "md5.h"
+
+boolean curl_failedwebdownload = false;
+INT32 curl_transfers = 0;
+
+namespace
+{
+
+enum class TransferState
+{
+	kQueued,
+	kRunning,
+	kFinished,
+	kFailed, // file removed, error says why
+	kCorrupt, // downloaded, but the checksum is wrong
+};
+
+struct Transfer
+{
+	// Set up by the main thread before the worker starts
+	INT32 filenum;
+	std::string name;
+	std::string url;
+	std::string path;
+	UINT8 md5sum[16];
+	UINT32 origfilesize;
+	UINT32 origtotalfilesize;
+	const std::atomic<bool>* stop;
+
+	// Worker only
+	CURL* handle = nullptr;
+	FILE* file = nullptr;
+	md5_ctx md5;
+	std::string error; // published by state
+
+	// Progress, for the main thread to poll
+	std::atomic<UINT32> currentsize {0};
+	std::atomic<UINT32> totalsize {0};
+	std::atomic<TransferState> state {TransferState::kQueued};
+
+	// Main thread only
+	bool reported = false;
+};
+
+size_t write_data(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+	Transfer* t = static_cast<Transfer*>(userdata);
+	const size_t bytes = size * nmemb;
+
+	if (std::fwrite(ptr, 1, bytes, t->file) != bytes)
+	{
+		return 0; // Fails the transfer with CURLE_WRITE_ERROR
+	}
+
+	// Hash as it arrives, instead of reading it all back afterward
+	md5_process_bytes(ptr, bytes, &t->md5);
+	return bytes;
+}
+
+int transfer_progress(void* clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+	Transfer* t = static_cast<Transfer*>(clientp);
+
+	(void)ultotal;
+	(void)ulnow; // Function prototype requires these but we won't use, so just discard
+
+	t->currentsize.store(static_cast<UINT32>(dlnow), std::memory_order_relaxed);
+	t->totalsize.store(static_cast<UINT32>(dltotal), std::memory_order_relaxed);
+
+	// Nonzero aborts the transfer
+	return t->stop->load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+// Runs every transfer on its own thread, up to connections_ at a time.
+// The only thing shared with the main thread is each Transfer's atomics.
+class Downloader
+{
+public:
+	Downloader(std::vector<std::unique_ptr<Transfer>> transfers, std::string useragent, std::string auth, size_t connections)
+		: transfers_(std::move(transfers))
+		, useragent_(std::move(useragent))
+		, auth_(std::move(auth))
+		, connections_(connections)
+	{
+		for (auto& t : transfers_)
+		{
+			t->stop = &stop_;
+		}
+
+		thread_ = std::thread {[this] { run(); }};
+	}
+
+	~Downloader()
+	{
+		stop_.store(true, std::memory_order_relaxed);
+
+		if (thread_.joinable())
+		{
+			thread_.join();
+		}
+	}
+
+	Downloader(const Downloader&) = delete;
+	Downloader& operator=(const Downloader&) = delete;
+
+	const std::vector<std::unique_ptr<Transfer>>& transfers() const { return transfers_; }
+
+private:
+	std::vector<std::unique_ptr<Transfer>> transfers_;
+	std::string useragent_;
+	std::string auth_;
+	size_t connections_;
+
+	std::atomic<bool> stop_ {false};
+	std::thread thread_;
+	CURLM* multi_ = nullptr;
+
+	void fail(Transfer& t, std::string error)
+	{
+		if (t.file)
+		{
+			std::fclose(t.file);
+			t.file = nullptr;
+		}
+
+		std::remove(t.path.c_str());
+
+		t.error = std::move(error);
+		t.state.store(TransferState::kFailed, std::memory_order_release);
+	}
+
+	bool begin(Transfer& t)
+	{
+		t.file = std::fopen(t.path.c_str(), "wb");
+
+		if (t.file == nullptr)
+		{
+			fail(t, fmt::format("couldn't open {}", t.path));
+			return false;
+		}
+
+		t.handle = curl_easy_init();
+
+		if (t.handle == nullptr)
+		{
+			fail(t, "curl_easy_init() failed");
+			return false;
+		}
+
+		md5_init_ctx(&t.md5);
+
+		curl_easy_setopt(t.handle, CURLOPT_URL, t.url.c_str());
+
+		// Only allow HTTP and HTTPS
+#if LIBCURL_VERSION_MAJOR > 7 || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
+		curl_easy_setopt(t.handle, CURLOPT_PROTOCOLS_STR, "http,https");
+#else
+		curl_easy_setopt(t.handle, CURLOPT_PROTOCOLS, CURLPROTO_HTTP|CURLPROTO_HTTPS); // deprecated in 7.85.0
+#endif
+
+		curl_easy_setopt(t.handle, CURLOPT_USERAGENT, useragent_.c_str()); // Set user agent as some servers won't accept invalid user agents.
+
+		// Authenticate if the user so wishes
+		if (!auth_.empty())
+		{
+			curl_easy_setopt(t.handle, CURLOPT_USERPWD, auth_.c_str());
+		}
+
+		// Follow a redirect request, if sent by the server.
+		curl_easy_setopt(t.handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+		curl_easy_setopt(t.handle, CURLOPT_FAILONERROR, 1L);
+
+		curl_easy_setopt(t.handle, CURLOPT_PRIVATE, &t);
+		curl_easy_setopt(t.handle, CURLOPT_WRITEDATA, &t);
+		curl_easy_setopt(t.handle, CURLOPT_WRITEFUNCTION, write_data);
+		curl_easy_setopt(t.handle, CURLOPT_NOPROGRESS, 0L);
+		curl_easy_setopt(t.handle, CURLOPT_XFERINFODATA, &t);
+		curl_easy_setopt(t.handle, CURLOPT_XFERINFOFUNCTION, transfer_progress);
+
+		t.state.store(TransferState::kRunning, std::memory_order_release);
+		curl_multi_add_handle(multi_, t.handle);
+
+		return true;
+	}
+
+	void finish(Transfer& t, CURLcode result)
+	{
+		long response_code = 0;
+
+		curl_multi_remove_handle(multi_, t.handle);
+
+		if (result == CURLE_HTTP_RETURNED_ERROR)
+		{
+			curl_easy_getinfo(t.handle, CURLINFO_RESPONSE_CODE, &response_code);
+		}
+
+		curl_easy_cleanup(t.handle);
+		t.handle = nullptr;
+
+		if (result != CURLE_OK)
+		{
+			fail(t, response_code ? fmt::format("HTTP reponse code {}", response_code) : curl_easy_strerror(result));
+			return;
+		}
+
+		if (std::fclose(t.file) != 0)
+		{
+			t.file = nullptr;
+			fail(t, fmt::format("couldn't write {}", t.path));
+			return;
+		}
+
+		t.file = nullptr;
+
+#ifdef NOMD5
+		t.state.store(TransferState::kFinished, std::memory_order_release);
+#else
+		UINT8 md5sum[16];
+
+		md5_finish_ctx(&t.md5, md5sum);
+
+		// Left on disk, same as a bad checksum from the file search
+		t.state.store(std::memcmp(md5sum, t.md5sum, 16) ? TransferState::kCorrupt : TransferState::kFinished, std::memory_order_release);
+#endif
+	}
+
+	void run()
+	{
+		size_t next = 0;
+		size_t active = 0;
+
+		multi_ = curl_multi_init();
+
+		if (multi_ == nullptr)
+		{
+			for (auto& t : transfers_)
+			{
+				t->error = "curl_multi_init() failed";
+				t->state.store(TransferState::kFailed, std::memory_order_release);
+			}
+			return;
+		}
+
+		while (!stop_.load(std::memory_order_relaxed))
+		{
+			CURLMsg* m;
+			int running;
+			int msgs_left;
+
+			while (active < connections_ && next < transfers_.size())
+			{
+				if (begin(*transfers_[next++]))
+				{
+					active++;
+				}
+			}
+
+			if (active == 0)
+			{
+				break; // All done
+			}
+
+			curl_multi_perform(multi_, &running);
+
+			// See how the transfers went
+			while ((m = curl_multi_info_read(multi_, &msgs_left)))
+			{
+				if (m->msg == CURLMSG_DONE)
+				{
+					Transfer* t = nullptr;
+					const CURLcode result = m->data.result;
+
+					curl_easy_getinfo(m->easy_handle, CURLINFO_PRIVATE, &t);
+					finish(*t, result);
+					active--;
+				}
+			}
+
+			// Short, so stopping doesn't have to wait long
+			curl_multi_wait(multi_, nullptr, 0, 100, nullptr);
+		}
+
+		// Stopped early, throw away anything unfinished
+		for (auto& t : transfers_)
+		{
+			if (t->handle)
+			{
+				curl_multi_remove_handle(multi_, t->handle);
+				curl_easy_cleanup(t->handle);
+				t->handle = nullptr;
+				fail(*t, "aborted");
+			}
+		}
+
+		curl_multi_cleanup(multi_);
+		multi_ = nullptr;
+	}
+};
+
+std::unique_ptr<Downloader> g_downloader;
+time_t g_starttime;
+
+}; // namespace
+
+void CURLStartDownloads(const char *url)
+{
+	std::vector<std::unique_ptr<Transfer>> transfers;
+	HTTP_login *login;
+	INT32 i;
+
+#ifdef PARANOIA
+	if (M_CheckParm("-nodownload"))
+		I_Error("Attempted to download files in -nodownload mode");
+#endif
+
+	CURLStopDownloads();
+
+	for (i = 0; i < fileneedednum; i++)
+	{
+		fileneeded_t *file = &fileneeded[i];
+
+		if (file->status != FS_NOTFOUND && file->status != FS_MD5SUMBAD)
+			continue;
+
+		auto t = std::make_unique<Transfer>();
+
+		nameonly(file->filename);
+
+		t->filenum = i;
+		t->name = file->filename;
+		t->url = fmt::format("{}/{}", url, file->filename);
+		std::memcpy(t->md5sum, file->md5sum, 16);
+		t->origfilesize = file->currentsize;
+		t->origtotalfilesize = file->totalsize;
+
+		strcatbf(file->filename, downloaddir, "/");
+		t->path = file->filename;
+
+		file->status = FS_DOWNLOADING;
+
+		CONS_Printf("Downloading %s from %s\n", t->name.c_str(), url);
+
+		transfers.push_back(std::move(t));
+	}
+
+	curl_transfers = static_cast<INT32>(transfers.size());
+
+	if (transfers.empty())
+		return;
+
+	I_mkdir(downloaddir, 0755);
+
+	curl_global_init(CURL_GLOBAL_ALL);
+
+	login = CURLGetLogin(url, NULL);
+
+	g_starttime = time(NULL);
+	g_downloader = std::make_unique<Downloader>(
+		std::move(transfers),
+		fmt::format("Ring Racers/v{}.{}", VERSION, SUBVERSION),
+		login ? login->auth : "",
+		static_cast<size_t>(cv_httpconnections.value)
+	);
+}
+
+boolean CURLUpdateDownloads(void)
+{
+	UINT64 received = 0;
+	INT32 showfilenum = -1;
+	time_t curtime;
+
+	if (!g_downloader)
+		return false;
+
+	for (const auto& t : g_downloader->transfers())
+	{
+		fileneeded_t *file = &fileneeded[t->filenum];
+		const TransferState state = t->state.load(std::memory_order_acquire);
+
+		if (state == TransferState::kQueued)
+			continue;
+
+		if (state == TransferState::kRunning)
+		{
+			const UINT32 totalsize = t->totalsize.load(std::memory_order_relaxed);
+
+			file->currentsize = t->currentsize.load(std::memory_order_relaxed);
+			if (totalsize)
+				file->totalsize = totalsize;
+
+			received += file->currentsize;
+
+			// Show the oldest one still going
+			if (showfilenum == -1)
+				showfilenum = t->filenum;
+
+			continue;
+		}
+
+		if (t->reported)
+		{
+			if (state == TransferState::kFinished)
+				received += file->totalsize;
+			continue;
+		}
+
+		t->reported = true;
+		curl_transfers--;
+
+		switch (state)
+		{
+			case TransferState::kFinished:
+				CONS_Printf(M_GetText("Finished HTTP download of %s\n"), t->name.c_str());
+				downloadcompletednum++;
+				downloadcompletedsize += file->totalsize;
+				file->status = FS_FOUND;
+				received += file->totalsize;
+				break;
+
+			case TransferState::kCorrupt:
+				CONS_Alert(CONS_ERROR, M_GetText("HTTP Download of %s finished but is corrupt or has been modified\n"), t->name.c_str());
+				file->status = FS_FALLBACK;
+				curl_failedwebdownload = true;
+				break;
+
+			default:
+				file->status = FS_FALLBACK;
+				file->currentsize = t->origfilesize;
+				file->totalsize = t->origtotalfilesize;
+				curl_failedwebdownload = true;
+				CONS_Printf(M_GetText("Failed to download %s (%s)\n"), t->name.c_str(), t->error.c_str());
+				break;
+		}
+	}
+
+	if (showfilenum != -1)
+		lastfilenum = showfilenum;
+
+	curtime = time(NULL);
+
+	if (curtime > g_starttime)
+		getbytes = static_cast<INT32>(received / (curtime - g_starttime)); // To-do: Make this more accurate???
+	else
+		getbytes = 0;
+
+	if (curl_transfers > 0)
+		return true;
+
+	CURLStopDownloads();
+	return false;
+}
+
+void CURLStopDownloads(void)
+{
+	if (!g_downloader)
+		return;
+
+	g_downloader.reset();
+	curl_global_cleanup();
+	curl_transfers = 0;
+}
+
+#endif // HAVE_CURL
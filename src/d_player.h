@@ -425,10 +425,36 @@ typedef enum
 	// free up to and including 1<<31
 } targetdamaging_t;
 
+// What changed since the player's conditions were last checked.
+// Only the condition sets that depend on one of these are rechecked.
+typedef enum
+{
+	UCD_ANY					= 1,     // Anything not listed below; rechecked on every check
+	UCD_FINISH				= 1<<1,  // Finishing, NO CONTEST, tally grade
+	UCD_FELLOFF				= 1<<2,
+	UCD_OFFROAD				= 1<<3,
+	UCD_SNEAKERPANEL		= 1<<4,
+	UCD_RINGDEBT			= 1<<5,
+	UCD_FAULTED				= 1<<6,
+	UCD_HYUU				= 1<<7,  // tripwire_hyuu, whip_hyuu
+	UCD_SPBNEUTER			= 1<<8,
+	UCD_LANDMINEDUNK		= 1<<9,
+	UCD_HITMIDAIR			= 1<<10,
+	UCD_HITDRAFTERLOOKBACK	= 1<<11,
+	UCD_SHRUNKENORBI		= 1<<12,
+	UCD_RETURNTOSENDER		= 1<<13,
+	UCD_TRACKHAZARD			= 1<<14,
+	UCD_TRIGGER				= 1<<15,
+	UCD_ROUNDSTART			= 1<<16, // Sets of only round constants (map, character, gear...)
+
+	UCD_ALL					= (1<<17)-1,
+	// free up to and including 1<<31
+} conditiondep_t;
+
 struct roundconditions_t
 {
-	// Reduce the number of checks by only updating when this is true
-	boolean checkthisframe;
+	// Reduce the number of checks by only updating when this is nonzero
+	UINT32 checkthisframe; // conditiondep_t
 
 	// Trivial Yes/no events across multiple UCRP's
 	boolean fell_off;
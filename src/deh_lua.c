@@ -26,6 +26,10 @@
 #include "deh_lua.h"
 #include "deh_tables.h"
 #include "deh_soc.h" // freeslotusage
+#include "deh_symbols.h"
+#include "command.h" // COM_Argv
+#include "i_system.h" // I_GetPreciseTime
+#include "lua_alloc.h" // LUA_ZoneAlloc
 
 // freeslot takes a name (string only!)
 // and allocates it to the appropriate free slot.
@@ -102,6 +106,7 @@ static inline int lib_freeslot(lua_State *L)
 			}
 			if (j > SPR_LASTFREESLOT)
 				CONS_Alert(CONS_WARNING, "Ran out of free sprite slots!\n");
+			DEH_InvalidateSprites();
 		}
 		else if (fastcmp(type, "S"))
 		{
@@ -112,6 +117,7 @@ static inline int lib_freeslot(lua_State *L)
 					FREE_STATES[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 					strcpy(FREE_STATES[i],word);
 					freeslotusage[0][0]++;
+					DEH_AddSymbol("S_", word, S_FIRSTFREESLOT + i);
 					lua_pushinteger(L, S_FIRSTFREESLOT + i);
 					r++;
 					break;
@@ -128,6 +134,7 @@ static inline int lib_freeslot(lua_State *L)
 					FREE_MOBJS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 					strcpy(FREE_MOBJS[i],word);
 					freeslotusage[1][0]++;
+					DEH_AddSymbol("MT_", word, MT_FIRSTFREESLOT + i);
 					lua_pushinteger(L, MT_FIRSTFREESLOT + i);
 					r++;
 					break;
@@ -145,6 +152,7 @@ static inline int lib_freeslot(lua_State *L)
 					strcpy(FREE_SKINCOLORS[i],word);
 					skincolors[i].cache_spraycan = UINT16_MAX;
 					numskincolors++;
+					DEH_AddSymbol("SKINCOLOR_", word, SKINCOLOR_FIRSTFREESLOT + i);
 					lua_pushinteger(L, SKINCOLOR_FIRSTFREESLOT + i);
 					r++;
 					break;
@@ -247,19 +255,40 @@ static int lib_dummysuper(lua_State *L)
 	return luaL_error(L, "Can't call super() outside of hardcode-replacing A_Action functions being called by state changes!"); // convoluted, I know. @_@;;
 }
 
+// Off only for luaenumbench, to time the old scans
+static boolean enumcache = true;
+
+// For constants that can't change while this state exists. Saves them in
+// the table lib_getenum is indexed through, so the next lookup of this
+// name never leaves the Lua VM.
+static int pushconst(lua_State *L, lua_Integer value)
+{
+	if (enumcache)
+	{
+		lua_pushvalue(L, 2);
+		lua_pushinteger(L, value);
+		lua_rawset(L, 1);
+	}
+
+	lua_pushinteger(L, value);
+	return 1;
+}
+
 static inline int lib_getenum(lua_State *L)
 {
 	const char *word, *p;
 	fixed_t i;
+	INT64 value;
 	boolean mathlib = lua_toboolean(L, lua_upvalueindex(1));
 	if (lua_type(L,2) != LUA_TSTRING)
 		return 0;
 	word = lua_tostring(L,2);
+	if (enumcache && DEH_FindSymbol(word, &value))
+		return pushconst(L, value);
 	if (strlen(word) == 1) { // Assume sprite frame if length 1.
 		if (*word >= 'A' && *word <= '~')
 		{
-			lua_pushinteger(L, *word-'A');
-			return 1;
+			return pushconst(L, *word-'A');
 		}
 		if (mathlib) return luaL_error(L, "constant '%s' could not be parsed.\n", word);
 		return 0;
@@ -268,8 +297,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; MOBJFLAG_LIST[i]; i++)
 			if (fastcmp(p, MOBJFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjflag '%s' could not be found.\n", word);
 		return 0;
@@ -278,8 +306,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; MOBJFLAG2_LIST[i]; i++)
 			if (fastcmp(p, MOBJFLAG2_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjflag2 '%s' could not be found.\n", word);
 		return 0;
@@ -288,8 +315,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; MOBJEFLAG_LIST[i]; i++)
 			if (fastcmp(p, MOBJEFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mobjeflag '%s' could not be found.\n", word);
 		return 0;
@@ -298,8 +324,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; i < 4; i++)
 			if (MAPTHINGFLAG_LIST[i] && fastcmp(p, MAPTHINGFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "mapthingflag '%s' could not be found.\n", word);
 		return 0;
@@ -308,8 +333,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; PLAYERFLAG_LIST[i]; i++)
 			if (fastcmp(p, PLAYERFLAG_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "playerflag '%s' could not be found.\n", word);
 		return 0;
@@ -333,8 +357,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; GAMETYPERULE_LIST[i]; i++)
 			if (fastcmp(p, GAMETYPERULE_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		if (mathlib) return luaL_error(L, "game type rule '%s' could not be found.\n", word);
 		return 0;
@@ -343,8 +366,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+4;
 		for (i = 0; TYPEOFLEVEL[i].name; i++)
 			if (fastcmp(p, TYPEOFLEVEL[i].name)) {
-				lua_pushinteger(L, TYPEOFLEVEL[i].flag);
-				return 1;
+				return pushconst(L, TYPEOFLEVEL[i].flag);
 			}
 		if (mathlib) return luaL_error(L, "typeoflevel '%s' could not be found.\n", word);
 		return 0;
@@ -353,34 +375,28 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		for (i = 0; ML_LIST[i]; i++)
 			if (fastcmp(p, ML_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1<<i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1<<i));
 			}
 		// Aliases
 		if (fastcmp(p, "EFFECT1"))
 		{
-			lua_pushinteger(L, (lua_Integer)ML_SKEWTD);
-			return 1;
+			return pushconst(L, (lua_Integer)ML_SKEWTD);
 		}
 		if (fastcmp(p, "EFFECT2"))
 		{
-			lua_pushinteger(L, (lua_Integer)ML_NOSKEW);
-			return 1;
+			return pushconst(L, (lua_Integer)ML_NOSKEW);
 		}
 		if (fastcmp(p, "EFFECT3"))
 		{
-			lua_pushinteger(L, (lua_Integer)ML_MIDPEG);
-			return 1;
+			return pushconst(L, (lua_Integer)ML_MIDPEG);
 		}
 		if (fastcmp(p, "EFFECT4"))
 		{
-			lua_pushinteger(L, (lua_Integer)ML_MIDSOLID);
-			return 1;
+			return pushconst(L, (lua_Integer)ML_MIDSOLID);
 		}
 		if (fastcmp(p, "EFFECT5"))
 		{
-			lua_pushinteger(L, (lua_Integer)ML_WRAPMIDTEX);
-			return 1;
+			return pushconst(L, (lua_Integer)ML_WRAPMIDTEX);
 		}
 		if (mathlib) return luaL_error(L, "linedef flag '%s' could not be found.\n", word);
 		return 0;
@@ -389,13 +405,11 @@ static inline int lib_getenum(lua_State *L)
 		p = word + 4;
 		for (i = 0; MSF_LIST[i]; i++)
 			if (fastcmp(p, MSF_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1 << i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1 << i));
 			}
 		if (fastcmp(p, "FLIPSPECIAL_BOTH"))
 		{
-			lua_pushinteger(L, (lua_Integer)MSF_FLIPSPECIAL_BOTH);
-			return 1;
+			return pushconst(L, (lua_Integer)MSF_FLIPSPECIAL_BOTH);
 		}
 		if (mathlib) return luaL_error(L, "sector flag '%s' could not be found.\n", word);
 		return 0;
@@ -404,8 +418,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word + 4;
 		for (i = 0; SSF_LIST[i]; i++)
 			if (fastcmp(p, SSF_LIST[i])) {
-				lua_pushinteger(L, ((lua_Integer)1 << i));
-				return 1;
+				return pushconst(L, ((lua_Integer)1 << i));
 			}
 		if (mathlib) return luaL_error(L, "sector special flag '%s' could not be found.\n", word);
 		return 0;
@@ -414,8 +427,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word + 3;
 		for (i = 0; SD_LIST[i]; i++)
 			if (fastcmp(p, SD_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		if (mathlib) return luaL_error(L, "sector damagetype '%s' could not be found.\n", word);
 		return 0;
@@ -424,8 +436,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word + 3;
 		for (i = 0; TO_LIST[i]; i++)
 			if (fastcmp(p, TO_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		if (mathlib) return luaL_error(L, "sector triggerer '%s' could not be found.\n", word);
 		return 0;
@@ -434,21 +445,18 @@ static inline int lib_getenum(lua_State *L)
 		p = word+2;
 		if (fastcmp(p, "FIRSTFREESLOT"))
 		{
-			lua_pushinteger(L, S_FIRSTFREESLOT);
-			return 1;
+			return pushconst(L, S_FIRSTFREESLOT);
 		}
 		for (i = 0; i < NUMSTATEFREESLOTS; i++) {
 			if (!FREE_STATES[i])
 				break;
 			if (fastcmp(p, FREE_STATES[i])) {
-				lua_pushinteger(L, S_FIRSTFREESLOT+i);
-				return 1;
+				return pushconst(L, S_FIRSTFREESLOT+i);
 			}
 		}
 		for (i = 0; i < S_FIRSTFREESLOT; i++)
 			if (fastcmp(p, STATE_LIST[i]+2)) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		return luaL_error(L, "state '%s' does not exist.\n", word);
 	}
@@ -456,21 +464,18 @@ static inline int lib_getenum(lua_State *L)
 		p = word+3;
 		if (fastcmp(p, "FIRSTFREESLOT"))
 		{
-			lua_pushinteger(L, MT_FIRSTFREESLOT);
-			return 1;
+			return pushconst(L, MT_FIRSTFREESLOT);
 		}
 		for (i = 0; i < NUMMOBJFREESLOTS; i++) {
 			if (!FREE_MOBJS[i])
 				break;
 			if (fastcmp(p, FREE_MOBJS[i])) {
-				lua_pushinteger(L, MT_FIRSTFREESLOT+i);
-				return 1;
+				return pushconst(L, MT_FIRSTFREESLOT+i);
 			}
 		}
 		for (i = 0; i < MT_FIRSTFREESLOT; i++)
 			if (fastcmp(p, MOBJTYPE_LIST[i]+3)) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		return luaL_error(L, "mobjtype '%s' does not exist.\n", word);
 	}
@@ -481,7 +486,15 @@ static inline int lib_getenum(lua_State *L)
 			lua_pushinteger(L, SPR_FIRSTFREESLOT);
 			return 1;
 		}
-		for (i = 0; i < NUMSPRITES; i++)
+		if (enumcache)
+		{
+			if ((i = DEH_FindSprite(p)) != -1)
+			{
+				lua_pushinteger(L, i);
+				return 1;
+			}
+		}
+		else for (i = 0; i < NUMSPRITES; i++)
 			if (!sprnames[i][4] && fastncmp(p,sprnames[i],4)) {
 				lua_pushinteger(L, i);
 				return 1;
@@ -498,13 +511,11 @@ static inline int lib_getenum(lua_State *L)
 				// the spr2names entry will have "_" on the end, as in "RUN_"
 				if (spr2names[i][3] == '_' && !p[3]) {
 					if (fastncmp(p,spr2names[i],3)) {
-						lua_pushinteger(L, i);
-						return 1;
+						return pushconst(L, i);
 					}
 				}
 				else if (fastncmp(p,spr2names[i],4)) {
-					lua_pushinteger(L, i);
-					return 1;
+					return pushconst(L, i);
 				}
 			}
 		if (mathlib) return luaL_error(L, "player sprite '%s' could not be found.\n", word);
@@ -512,6 +523,17 @@ static inline int lib_getenum(lua_State *L)
 	}
 	else if (fastncmp("sfx_",word,4)) {
 		p = word+4;
+		if (enumcache)
+		{
+			// That's case insensitive, this isn't
+			if ((i = DEH_FindSfx(p)) == -1)
+				return 0;
+			if (fastcmp(p, S_sfx[i].name))
+			{
+				lua_pushinteger(L, i);
+				return 1;
+			}
+		}
 		for (i = 0; i < NUMSFX; i++)
 			if (S_sfx[i].name && fastcmp(p, S_sfx[i].name)) {
 				lua_pushinteger(L, i);
@@ -521,7 +543,15 @@ static inline int lib_getenum(lua_State *L)
 	}
 	else if (mathlib && fastncmp("SFX_",word,4)) { // SOCs are ALL CAPS!
 		p = word+4;
-		for (i = 0; i < NUMSFX; i++)
+		if (enumcache)
+		{
+			if ((i = DEH_FindSfx(p)) != -1)
+			{
+				lua_pushinteger(L, i);
+				return 1;
+			}
+		}
+		else for (i = 0; i < NUMSFX; i++)
 			if (S_sfx[i].name && fasticmp(p, S_sfx[i].name)) {
 				lua_pushinteger(L, i);
 				return 1;
@@ -530,7 +560,15 @@ static inline int lib_getenum(lua_State *L)
 	}
 	else if (mathlib && fastncmp("DS",word,2)) {
 		p = word+2;
-		for (i = 0; i < NUMSFX; i++)
+		if (enumcache)
+		{
+			if ((i = DEH_FindSfx(p)) != -1)
+			{
+				lua_pushinteger(L, i);
+				return 1;
+			}
+		}
+		else for (i = 0; i < NUMSFX; i++)
 			if (S_sfx[i].name && fasticmp(p, S_sfx[i].name)) {
 				lua_pushinteger(L, i);
 				return 1;
@@ -542,8 +580,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+5;
 		for (i = 0; i < NUMKARTHUD; i++)
 			if (fasticmp(p, KARTHUD_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		return luaL_error(L, "karthud '%s' could not be found.\n", word);
 	}
@@ -551,8 +588,7 @@ static inline int lib_getenum(lua_State *L)
 		p = word+5;
 		for (i = 0; i < NUMKARTHUD; i++)
 			if (fastcmp(p, KARTHUD_LIST[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		return luaL_error(L, "karthud '%s' could not be found.\n", word);
 	}
@@ -562,14 +598,12 @@ static inline int lib_getenum(lua_State *L)
 			if (!FREE_SKINCOLORS[i])
 				break;
 			if (fastcmp(p, FREE_SKINCOLORS[i])) {
-				lua_pushinteger(L, SKINCOLOR_FIRSTFREESLOT+i);
-				return 1;
+				return pushconst(L, SKINCOLOR_FIRSTFREESLOT+i);
 			}
 		}
 		for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
 			if (fastcmp(p, COLOR_ENUMS[i])) {
-				lua_pushinteger(L, i);
-				return 1;
+				return pushconst(L, i);
 			}
 		return luaL_error(L, "skincolor '%s' could not be found.\n", word);
 	}
@@ -582,8 +616,7 @@ static inline int lib_getenum(lua_State *L)
 
 			if (fastcmp(p, precipprops[i].name))
 			{
-				lua_pushinteger(L, PRECIP_NONE + i);
-				return 1;
+				return pushconst(L, PRECIP_NONE + i);
 			}
 		}
 		return luaL_error(L, "weather type '%s' does not exist.\n", word);
@@ -630,8 +663,7 @@ static inline int lib_getenum(lua_State *L)
 
 	for (i = 0; INT_CONST[i].n; i++)
 		if (fastcmp(word,INT_CONST[i].n)) {
-			lua_pushinteger(L, INT_CONST[i].v);
-			return 1;
+			return pushconst(L, INT_CONST[i].v);
 		}
 
 	if (mathlib) return luaL_error(L, "constant '%s' could not be parsed.\n", word);
@@ -642,20 +674,119 @@ static inline int lib_getenum(lua_State *L)
 	return LUA_PushGlobals(L, word);
 }
 
+// Pushes an empty constants table, falling back to lib_getenum
+static void LUA_PushEnumTable(lua_State *L, int mathlib)
+{
+	lua_newtable(L);
+	lua_createtable(L, 0, 1);
+	lua_pushvalue(L, mathlib);
+	lua_pushcclosure(L, lib_getenum, 1);
+	lua_setfield(L, -2, "__index");
+	lua_setmetatable(L, -2);
+}
+
 int LUA_EnumLib(lua_State *L)
 {
 	if (lua_gettop(L) == 0)
 		lua_pushboolean(L, 0);
 
 	// Set the global metatable
+	// Globals are indexed through a table of constants, instead of
+	// lib_getenum directly. Constants aren't put in _G itself, so
+	// assigning to them still errors instead of overwriting them.
 	lua_createtable(L, 0, 1);
-	lua_pushvalue(L, 1); // boolean passed to LUA_EnumLib as first argument.
-	lua_pushcclosure(L, lib_getenum, 1);
+	LUA_PushEnumTable(L, 1); // boolean passed to LUA_EnumLib as first argument.
 	lua_setfield(L, -2, "__index");
 	lua_setmetatable(L, LUA_GLOBALSINDEX);
 	return 0;
 }
 
+// A freeslot took over the name of a hardcoded constant
+void LUA_InvalidateEnumCache(void)
+{
+	if (!gL)
+		return;
+
+	lua_getmetatable(gL, LUA_GLOBALSINDEX);
+	lua_getfield(gL, -1, "__index"); // old constants
+	lua_newtable(gL);
+	lua_getmetatable(gL, -2); // still falls back to lib_getenum
+	lua_setmetatable(gL, -2);
+	lua_setfield(gL, -3, "__index");
+	lua_pop(gL, 2);
+}
+
+static const char *luaenumbench_script =
+	"local x\n"
+	"for i = 1, ... do\n"
+	"	x = %s, %s, %s, %s, %s\n"
+	"end\n";
+
+static precise_t LUA_RunEnumBench(const char *script, INT32 iterations)
+{
+	lua_State *L = lua_newstate(LUA_ZoneAlloc, NULL);
+	precise_t start = 0, time = 0;
+
+	lua_pushcfunction(L, LUA_EnumLib);
+	lua_call(L, 0, 0);
+
+	if (luaL_loadstring(L, script))
+	{
+		CONS_Alert(CONS_ERROR, "luaenumbench: %s\n", lua_tostring(L, -1));
+		lua_close(L);
+		return 0;
+	}
+
+	lua_pushinteger(L, iterations);
+
+	start = I_GetPreciseTime();
+
+	if (lua_pcall(L, 1, 0, 0))
+		CONS_Alert(CONS_ERROR, "luaenumbench: %s\n", lua_tostring(L, -1));
+	else
+		time = I_GetPreciseTime() - start;
+
+	lua_close(L);
+	return time;
+}
+
+// luaenumbench [iterations]
+// Times a loop over a few constants from the end of their tables,
+// with and without the hashed lookups and constants table.
+void Command_LuaEnumBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	INT32 iterations = 100000;
+	INT32 flags, consts;
+	char script[512];
+	char mobjflag[64], skincolor[64];
+	precise_t scantime, cachetime;
+
+	if (COM_Argc() > 1)
+		iterations = max(1, atoi(COM_Argv(1)));
+
+	for (flags = 0; MOBJFLAG_LIST[flags]; flags++)
+		;
+	for (consts = 0; INT_CONST[consts].n; consts++)
+		;
+
+	snprintf(mobjflag, sizeof mobjflag, "MF_%s", MOBJFLAG_LIST[flags - 1]);
+	snprintf(skincolor, sizeof skincolor, "SKINCOLOR_%s", COLOR_ENUMS[SKINCOLOR_FIRSTFREESLOT - 1]);
+	snprintf(script, sizeof script, luaenumbench_script,
+		STATE_LIST[S_FIRSTFREESLOT - 1], MOBJTYPE_LIST[MT_FIRSTFREESLOT - 1],
+		mobjflag, skincolor, INT_CONST[consts - 1].n);
+
+	enumcache = false;
+	scantime = LUA_RunEnumBench(script, iterations);
+	enumcache = true;
+	cachetime = LUA_RunEnumBench(script, iterations);
+
+	CONS_Printf("%d iterations of %s, %s, %s, %s, %s\n", iterations,
+		STATE_LIST[S_FIRSTFREESLOT - 1], MOBJTYPE_LIST[MT_FIRSTFREESLOT - 1], mobjflag, skincolor, INT_CONST[consts - 1].n);
+	CONS_Printf("table scans: %s us\n", sizeu1((size_t)(scantime * 1000000 / precision)));
+	CONS_Printf("cached: %s us\n", sizeu1((size_t)(cachetime * 1000000 / precision)));
+}
+
 // getActionName(action) -> return action's string name
 static int lib_getActionName(lua_State *L)
 {
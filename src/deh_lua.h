@@ -22,6 +22,8 @@ boolean LUA_SetLuaAction(void *state, const char *actiontocompare);
 const char *LUA_GetActionName(void *action);
 void LUA_SetActionByName(void *state, const char *actiontocompare);
 size_t LUA_GetActionNumByName(const char *actiontocompare);
+void LUA_InvalidateEnumCache(void);
+void Command_LuaEnumBench_f(void);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -39,6 +39,7 @@
 #include "fastcmp.h"
 #include "lua_script.h" // Reluctantly included for LUA_EvalMath
 #include "d_clisrv.h"
+#include "command.h" // COM_Argv
 
 #ifdef HWRENDER
 #include "hardware/hw_light.h"
@@ -51,6 +52,7 @@
 #include "deh_soc.h"
 #include "deh_lua.h" // included due to some LUA_SetLuaAction hack smh
 #include "deh_tables.h"
+#include "deh_symbols.h"
 
 // SRB2Kart
 #include "filesrch.h" // refreshdirmenu
@@ -58,9 +60,18 @@
 #include "doomstat.h" // MAXMUSNAMES
 #include "discord.h"
 
+// Off only for socbench, to time the old scans
+static boolean socsymbols = true;
+
 // Loops through every constant and operation in word and performs its calculations, returning the final value.
 fixed_t get_number(const char *word)
 {
+	INT32 value;
+
+	// Most are plain numbers, names or flags, which don't need a Lua state
+	if (socsymbols && DEH_EvalConstant(word, &value))
+		return value;
+
 	return LUA_EvalMath(word);
 
 	/*// DESPERATELY NEEDED: Order of operations support! :x
@@ -297,6 +308,7 @@ void readfreeslots(MYFILE *f)
 				}
 				if (i > SPR_LASTFREESLOT)
 					I_Error("Out of Sprite Freeslots while allocating \"%s\"\nLoad less addons to fix this.", word);
+				DEH_InvalidateSprites();
 
 			}
 			else if (fastcmp(type, "S"))
@@ -307,6 +319,7 @@ void readfreeslots(MYFILE *f)
 						FREE_STATES[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 						strcpy(FREE_STATES[i],word);
 						freeslotusage[0][0]++;
+						DEH_AddSymbol("S_", word, S_FIRSTFREESLOT + i);
 						break;
 					}
 				if (i == NUMSTATEFREESLOTS)
@@ -321,6 +334,7 @@ void readfreeslots(MYFILE *f)
 						FREE_MOBJS[i] = Z_Malloc(strlen(word)+1, PU_STATIC, NULL);
 						strcpy(FREE_MOBJS[i],word);
 						freeslotusage[1][0]++;
+						DEH_AddSymbol("MT_", word, MT_FIRSTFREESLOT + i);
 						break;
 					}
 				if (i == NUMMOBJFREESLOTS)
@@ -336,6 +350,7 @@ void readfreeslots(MYFILE *f)
 						strcpy(FREE_SKINCOLORS[i],word);
 						skincolors[i].cache_spraycan = UINT16_MAX;
 						numskincolors++;
+						DEH_AddSymbol("SKINCOLOR_", word, SKINCOLOR_FIRSTFREESLOT + i);
 						break;
 					}
 				if (i == NUMCOLORFREESLOTS)
@@ -4567,19 +4582,28 @@ void readweather(MYFILE *f, INT32 num)
 mobjtype_t get_mobjtype(const char *word)
 { // Returns the value of MT_ enumerations
 	mobjtype_t i;
+	INT64 value;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("MT_",word,3))
 		word += 3; // take off the MT_
-	for (i = 0; i < NUMMOBJFREESLOTS; i++) {
-		if (!FREE_MOBJS[i])
-			break;
-		if (fastcmp(word, FREE_MOBJS[i]))
-			return MT_FIRSTFREESLOT+i;
+	if (socsymbols)
+	{
+		if (DEH_FindPrefixedSymbol("MT_", word, &value))
+			return value;
+	}
+	else
+	{
+		for (i = 0; i < NUMMOBJFREESLOTS; i++) {
+			if (!FREE_MOBJS[i])
+				break;
+			if (fastcmp(word, FREE_MOBJS[i]))
+				return MT_FIRSTFREESLOT+i;
+		}
+		for (i = 0; i < MT_FIRSTFREESLOT; i++)
+			if (fastcmp(word, MOBJTYPE_LIST[i]+3))
+				return i;
 	}
-	for (i = 0; i < MT_FIRSTFREESLOT; i++)
-		if (fastcmp(word, MOBJTYPE_LIST[i]+3))
-			return i;
 	deh_warning("Couldn't find mobjtype named 'MT_%s'",word);
 	return MT_NULL;
 }
@@ -4587,19 +4611,28 @@ mobjtype_t get_mobjtype(const char *word)
 statenum_t get_state(const char *word)
 { // Returns the value of S_ enumerations
 	statenum_t i;
+	INT64 value;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("S_",word,2))
 		word += 2; // take off the S_
-	for (i = 0; i < NUMSTATEFREESLOTS; i++) {
-		if (!FREE_STATES[i])
-			break;
-		if (fastcmp(word, FREE_STATES[i]))
-			return S_FIRSTFREESLOT+i;
+	if (socsymbols)
+	{
+		if (DEH_FindPrefixedSymbol("S_", word, &value))
+			return value;
+	}
+	else
+	{
+		for (i = 0; i < NUMSTATEFREESLOTS; i++) {
+			if (!FREE_STATES[i])
+				break;
+			if (fastcmp(word, FREE_STATES[i]))
+				return S_FIRSTFREESLOT+i;
+		}
+		for (i = 0; i < S_FIRSTFREESLOT; i++)
+			if (fastcmp(word, STATE_LIST[i]+2))
+				return i;
 	}
-	for (i = 0; i < S_FIRSTFREESLOT; i++)
-		if (fastcmp(word, STATE_LIST[i]+2))
-			return i;
 	deh_warning("Couldn't find state named 'S_%s'",word);
 	return S_NULL;
 }
@@ -4607,19 +4640,28 @@ statenum_t get_state(const char *word)
 skincolornum_t get_skincolor(const char *word)
 { // Returns the value of SKINCOLOR_ enumerations
 	skincolornum_t i;
+	INT64 value;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SKINCOLOR_",word,10))
 		word += 10; // take off the SKINCOLOR_
-	for (i = 0; i < NUMCOLORFREESLOTS; i++) {
-		if (!FREE_SKINCOLORS[i])
-			break;
-		if (fastcmp(word, FREE_SKINCOLORS[i]))
-			return SKINCOLOR_FIRSTFREESLOT+i;
+	if (socsymbols)
+	{
+		if (DEH_FindPrefixedSymbol("SKINCOLOR_", word, &value))
+			return value;
+	}
+	else
+	{
+		for (i = 0; i < NUMCOLORFREESLOTS; i++) {
+			if (!FREE_SKINCOLORS[i])
+				break;
+			if (fastcmp(word, FREE_SKINCOLORS[i]))
+				return SKINCOLOR_FIRSTFREESLOT+i;
+		}
+		for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
+			if (fastcmp(word, COLOR_ENUMS[i]))
+				return i;
 	}
-	for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
-		if (fastcmp(word, COLOR_ENUMS[i]))
-			return i;
 	deh_warning("Couldn't find skincolor named 'SKINCOLOR_%s'",word);
 	return SKINCOLOR_GREEN;
 }
@@ -4627,13 +4669,22 @@ skincolornum_t get_skincolor(const char *word)
 spritenum_t get_sprite(const char *word)
 { // Returns the value of SPR_ enumerations
 	spritenum_t i;
+	INT32 found;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SPR_",word,4))
 		word += 4; // take off the SPR_
-	for (i = 0; i < NUMSPRITES; i++)
-		if (!sprnames[i][4] && memcmp(word,sprnames[i],4)==0)
-			return i;
+	if (socsymbols)
+	{
+		if ((found = DEH_FindSprite(word)) != -1)
+			return found;
+	}
+	else
+	{
+		for (i = 0; i < NUMSPRITES; i++)
+			if (!sprnames[i][4] && memcmp(word,sprnames[i],4)==0)
+				return i;
+	}
 	deh_warning("Couldn't find sprite named 'SPR_%s'",word);
 	return SPR_NULL;
 }
@@ -4655,15 +4706,24 @@ playersprite_t get_sprite2(const char *word)
 sfxenum_t get_sfx(const char *word)
 { // Returns the value of SFX_ enumerations
 	sfxenum_t i;
+	INT32 found;
 	if (*word >= '0' && *word <= '9')
 		return atoi(word);
 	if (fastncmp("SFX_",word,4))
 		word += 4; // take off the SFX_
 	else if (fastncmp("DS",word,2))
 		word += 2; // take off the DS
-	for (i = 0; i < NUMSFX; i++)
-		if (S_sfx[i].name && fasticmp(word, S_sfx[i].name))
-			return i;
+	if (socsymbols)
+	{
+		if ((found = DEH_FindSfx(word)) != -1)
+			return found;
+	}
+	else
+	{
+		for (i = 0; i < NUMSFX; i++)
+			if (S_sfx[i].name && fasticmp(word, S_sfx[i].name))
+				return i;
+	}
 	deh_warning("Couldn't find sfx named 'SFX_%s'",word);
 	return sfx_None;
 }
@@ -4926,3 +4986,124 @@ static fixed_t find_const(const char **rword)
 	free(word);
 	return 0;
 }*/
+
+typedef enum
+{
+	SOCBENCH_NUMBER,
+	SOCBENCH_STATE,
+	SOCBENCH_MOBJTYPE,
+	SOCBENCH_SPRITE,
+	SOCBENCH_SFX,
+	SOCBENCH_SKINCOLOR,
+} socbenchkind_t;
+
+typedef struct
+{
+	socbenchkind_t kind;
+	char *word;
+} socbenchword_t;
+
+static socbenchword_t *socbenchwords;
+static size_t socbenchcount;
+
+static void SOCBench_Add(socbenchkind_t kind, const char *word)
+{
+	socbenchwords[socbenchcount].kind = kind;
+	socbenchwords[socbenchcount].word = Z_StrDup(word);
+	socbenchcount++;
+}
+
+static INT64 SOCBench_Run(INT32 iterations, precise_t *time)
+{
+	precise_t start = I_GetPreciseTime();
+	INT64 sum = 0;
+	size_t i;
+
+	for (; iterations > 0; iterations--)
+	{
+		for (i = 0; i < socbenchcount; i++)
+		{
+			const char *word = socbenchwords[i].word;
+
+			switch (socbenchwords[i].kind)
+			{
+				case SOCBENCH_NUMBER:    sum += get_number(word); break;
+				case SOCBENCH_STATE:     sum += get_state(word); break;
+				case SOCBENCH_MOBJTYPE:  sum += get_mobjtype(word); break;
+				case SOCBENCH_SPRITE:    sum += get_sprite(word); break;
+				case SOCBENCH_SFX:       sum += get_sfx(word); break;
+				case SOCBENCH_SKINCOLOR: sum += get_skincolor(word); break;
+			}
+		}
+	}
+
+	*time = I_GetPreciseTime() - start;
+	return sum;
+}
+
+// socbench [iterations]
+// Resolves what a SOC redefining every hardcoded state, object and
+// skincolor would, with and without the hashed lookups.
+void Command_SOCBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	INT32 iterations = 1;
+	char flags[1024];
+	precise_t scantime, hashtime;
+	INT64 scansum, hashsum;
+	size_t i, len;
+	INT32 b;
+
+	if (COM_Argc() > 1)
+		iterations = max(1, atoi(COM_Argv(1)));
+
+	socbenchwords = Z_Malloc(sizeof *socbenchwords * (4*S_FIRSTFREESLOT + 5*MT_FIRSTFREESLOT + SKINCOLOR_FIRSTFREESLOT), PU_STATIC, NULL);
+	socbenchcount = 0;
+
+	for (i = 0; i < S_FIRSTFREESLOT; i++)
+	{
+		SOCBench_Add(SOCBENCH_STATE, STATE_LIST[i]);
+		SOCBench_Add(SOCBENCH_SPRITE, va("SPR_%s", sprnames[states[i].sprite]));
+		SOCBench_Add(SOCBENCH_NUMBER, va("%d", states[i].tics));
+		if (states[i].nextstate < S_FIRSTFREESLOT)
+			SOCBench_Add(SOCBENCH_NUMBER, STATE_LIST[states[i].nextstate]);
+	}
+
+	for (i = 0; i < MT_FIRSTFREESLOT; i++)
+	{
+		SOCBench_Add(SOCBENCH_MOBJTYPE, MOBJTYPE_LIST[i]);
+
+		len = 0;
+		for (b = 0; MOBJFLAG_LIST[b] && len < sizeof flags; b++)
+			if (mobjinfo[i].flags & (1u<<b))
+				len += snprintf(flags + len, sizeof flags - len, "%sMF_%s", len ? "|" : "", MOBJFLAG_LIST[b]);
+		SOCBench_Add(SOCBENCH_NUMBER, len ? flags : "0");
+
+		SOCBench_Add(SOCBENCH_NUMBER, va("%d*FRACUNIT", mobjinfo[i].radius / FRACUNIT));
+		if (mobjinfo[i].spawnstate < S_FIRSTFREESLOT)
+			SOCBench_Add(SOCBENCH_NUMBER, STATE_LIST[mobjinfo[i].spawnstate]);
+		if (mobjinfo[i].seesound > sfx_None && mobjinfo[i].seesound < NUMSFX && S_sfx[mobjinfo[i].seesound].name)
+			SOCBench_Add(SOCBENCH_SFX, va("SFX_%s", S_sfx[mobjinfo[i].seesound].name));
+	}
+
+	for (i = 0; i < SKINCOLOR_FIRSTFREESLOT; i++)
+		SOCBench_Add(SOCBENCH_SKINCOLOR, va("SKINCOLOR_%s", COLOR_ENUMS[i]));
+
+	socsymbols = false;
+	scansum = SOCBench_Run(iterations, &scantime);
+	socsymbols = true;
+	hashsum = SOCBench_Run(iterations, &hashtime);
+
+	CONS_Printf("%d iterations of %s SOC lookups\n", iterations, sizeu1(socbenchcount));
+	CONS_Printf("table scans and Lua: %s us\n", sizeu1((size_t)(scantime * 1000000 / precision)));
+	CONS_Printf("hashed: %s us\n", sizeu1((size_t)(hashtime * 1000000 / precision)));
+
+	if (scansum != hashsum)
+		CONS_Alert(CONS_WARNING, "socbench: the two didn't give the same results\n");
+
+	for (i = 0; i < socbenchcount; i++)
+		Z_Free(socbenchwords[i].word);
+	Z_Free(socbenchwords);
+	socbenchwords = NULL;
+	socbenchcount = 0;
+}
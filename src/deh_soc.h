@@ -92,6 +92,8 @@ void readfollowercategory(MYFILE *f);
 preciptype_t get_precip(const char *word);
 void readweather(MYFILE *f, INT32 num);
 
+void Command_SOCBench_f(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,555 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  deh_symbols.cpp
+/// \brief Hashed lookup of named constants for SOC and Lua
+
+#include "deh_symbols.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "doomdef.h"
+#include "doomdata.h" // ML_*
+#include "r_defs.h" // MSF_*
+#include "info.h"
+#include "sounds.h"
+#include "deh_tables.h"
+#include "deh_lua.h" // LUA_InvalidateEnumCache
+
+namespace
+{
+
+struct Symbol
+{
+	INT64 value;
+	bool hideable; // by a freeslot of the same name
+};
+
+// Prefixes that lib_getenum handles itself, so INT_CONST names starting
+// with them were never reachable there. Keep them out.
+constexpr const char* kReservedPrefixes[] = {
+	"MF_", "MF2_", "MFE_", "MTF_", "PF_", "GT_", "GTR_", "TOL_", "ML_", "MSF_", "SSF_", "SD_", "TO_",
+	"S_", "MT_", "SPR_", "SPR2_", "sfx_", "SFX_", "DS", "khud_", "KHUD_", "SKINCOLOR_", "PRECIP_", "A_",
+};
+
+class SymbolTable
+{
+	std::unordered_map<std::string_view, Symbol> symbols_;
+
+	// Keys for names that aren't string literals
+	std::deque<std::string> names_;
+
+	void add_static(std::string_view name, INT64 value, bool hideable = true)
+	{
+		// First one wins, same as the scans
+		symbols_.try_emplace(name, Symbol {value, hideable});
+	}
+
+	void add_owned(std::string name, INT64 value)
+	{
+		if (symbols_.find(name) == symbols_.end())
+		{
+			add_static(names_.emplace_back(std::move(name)), value);
+		}
+	}
+
+	void add_flags(const char* prefix, const char* const list[], size_t count = SIZE_MAX)
+	{
+		for (size_t i = 0; i < count && list[i]; i++)
+		{
+			add_owned(std::string(prefix) + list[i], static_cast<INT64>(1) << i);
+		}
+	}
+
+	void add_list(const char* prefix, const char* const list[], size_t count = SIZE_MAX)
+	{
+		for (size_t i = 0; i < count && list[i]; i++)
+		{
+			add_owned(std::string(prefix) + list[i], static_cast<INT64>(i));
+		}
+	}
+
+	static bool reserved(std::string_view name)
+	{
+		for (const char* prefix : kReservedPrefixes)
+		{
+			if (name.substr(0, std::char_traits<char>::length(prefix)) == prefix)
+			{
+				return true;
+			}
+		}
+		return name == "super";
+	}
+
+public:
+	SymbolTable()
+	{
+		add_flags("MF_", MOBJFLAG_LIST);
+		add_flags("MF2_", MOBJFLAG2_LIST);
+		add_flags("MFE_", MOBJEFLAG_LIST);
+		add_flags("PF_", PLAYERFLAG_LIST);
+		add_flags("GTR_", GAMETYPERULE_LIST);
+		add_flags("ML_", ML_LIST);
+		add_flags("MSF_", MSF_LIST);
+		add_flags("SSF_", SSF_LIST);
+		add_list("SD_", SD_LIST);
+		add_list("TO_", TO_LIST);
+
+		// Can have holes
+		for (size_t i = 0; i < 4; i++)
+		{
+			if (MAPTHINGFLAG_LIST[i])
+			{
+				add_owned(std::string("MTF_") + MAPTHINGFLAG_LIST[i], static_cast<INT64>(1) << i);
+			}
+		}
+
+		add_owned("ML_EFFECT1", ML_SKEWTD);
+		add_owned("ML_EFFECT2", ML_NOSKEW);
+		add_owned("ML_EFFECT3", ML_MIDPEG);
+		add_owned("ML_EFFECT4", ML_MIDSOLID);
+		add_owned("ML_EFFECT5", ML_WRAPMIDTEX);
+		add_owned("MSF_FLIPSPECIAL_BOTH", MSF_FLIPSPECIAL_BOTH);
+
+		// Checked before the freeslots
+		add_static("S_FIRSTFREESLOT", S_FIRSTFREESLOT, false);
+		add_static("MT_FIRSTFREESLOT", MT_FIRSTFREESLOT, false);
+
+		// These already have their prefix
+		for (size_t i = 0; i < S_FIRSTFREESLOT; i++)
+		{
+			add_static(STATE_LIST[i], static_cast<INT64>(i));
+		}
+		for (size_t i = 0; i < MT_FIRSTFREESLOT; i++)
+		{
+			add_static(MOBJTYPE_LIST[i], static_cast<INT64>(i));
+		}
+
+		add_list("SKINCOLOR_", COLOR_ENUMS, SKINCOLOR_FIRSTFREESLOT);
+
+		for (size_t i = 0; INT_CONST[i].n; i++)
+		{
+			if (!reserved(INT_CONST[i].n))
+			{
+				add_static(INT_CONST[i].n, INT_CONST[i].v);
+			}
+		}
+	}
+
+	const Symbol* find(std::string_view name) const
+	{
+		auto it = symbols_.find(name);
+		return it != symbols_.end() ? &it->second : nullptr;
+	}
+
+	// Returns true if this changed what an existing name resolves to.
+	bool add_freeslot(std::string name, INT64 value)
+	{
+		auto it = symbols_.find(name);
+
+		if (it == symbols_.end())
+		{
+			symbols_.try_emplace(names_.emplace_back(std::move(name)), Symbol {value, false});
+			return false;
+		}
+
+		if (!it->second.hideable)
+		{
+			return false;
+		}
+
+		it->second = {value, false};
+		return true;
+	}
+};
+
+SymbolTable& symbols()
+{
+	static SymbolTable table;
+	return table;
+}
+
+// Sprite and sound names aren't fixed like the ones above, since freeslots
+// fill them in. These are just rebuilt the next time they're needed.
+std::unordered_map<std::string, INT32> g_sprites; // first four characters
+std::unordered_map<std::string, INT32> g_sfx; // uppercase
+bool g_spritesvalid = false;
+bool g_sfxvalid = false;
+
+std::string upper(const char* name)
+{
+	std::string s {name};
+	for (char& c : s)
+	{
+		c = std::toupper(static_cast<unsigned char>(c));
+	}
+	return s;
+}
+
+// Evaluates what LUA_EvalMath would, for the kinds of expression SOCs are
+// full of: numbers, constants, parentheses and integer arithmetic, with
+// Lua's operator priorities. Gives up on anything else, or anything Lua
+// would complain about, so that LUA_EvalMath gets it instead.
+class ConstExpr
+{
+	enum class Op
+	{
+		kNone,
+		kAdd,
+		kSub,
+		kMul,
+		kDiv,
+		kMod,
+		kAnd,
+		kOr,
+		kShl,
+		kShr,
+	};
+
+	// From blua/lparser.c
+	static constexpr int kUnaryPriority = 8;
+
+	static int priority(Op op)
+	{
+		switch (op)
+		{
+			case Op::kMul:
+			case Op::kDiv:
+			case Op::kMod:
+			case Op::kShl:
+			case Op::kShr:
+				return 7;
+			default:
+				return 6;
+		}
+	}
+
+	const char* p_;
+	bool ok_ = true;
+
+	uint32_t fail()
+	{
+		ok_ = false;
+		return 0;
+	}
+
+	void skip_space()
+	{
+		while (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')
+		{
+			p_++;
+		}
+	}
+
+	Op peek_op(size_t& len)
+	{
+		skip_space();
+		len = 1;
+
+		switch (*p_)
+		{
+			case '+': return Op::kAdd;
+			case '-': return p_[1] == '-' ? Op::kNone : Op::kSub; // comment
+			case '*': return Op::kMul;
+			case '/': return Op::kDiv;
+			case '%': return Op::kMod;
+			case '&': return Op::kAnd;
+			case '|': return Op::kOr;
+			case '<':
+			case '>':
+				// Otherwise it's a comparison
+				if (p_[1] != p_[0])
+				{
+					return Op::kNone;
+				}
+				len = 2;
+				return *p_ == '<' ? Op::kShl : Op::kShr;
+			default:
+				return Op::kNone;
+		}
+	}
+
+	// Same as blua/luaconf.h, on INT32
+	uint32_t arith(Op op, uint32_t a, uint32_t b)
+	{
+		const INT32 sa = static_cast<INT32>(a);
+		const INT32 sb = static_cast<INT32>(b);
+
+		switch (op)
+		{
+			case Op::kAdd: return a + b;
+			case Op::kSub: return a - b;
+			case Op::kMul: return a * b;
+			case Op::kDiv:
+			case Op::kMod:
+				if (sb == 0 || (sa == INT32_MIN && sb == -1))
+				{
+					return fail();
+				}
+				return static_cast<uint32_t>(op == Op::kDiv ? sa / sb : sa % sb);
+			case Op::kAnd: return a & b;
+			case Op::kOr: return a | b;
+			case Op::kShl:
+			case Op::kShr:
+				if (b >= 32)
+				{
+					return fail();
+				}
+				return op == Op::kShl ? a << b : a >> b;
+			default:
+				return fail();
+		}
+	}
+
+	// What lib_getenum gives a math state, for the names that don't need
+	// anything but the tables here
+	uint32_t constant(const std::string& name)
+	{
+		INT64 value;
+
+		if (DEH_FindSymbol(name.c_str(), &value))
+		{
+			return static_cast<uint32_t>(value);
+		}
+
+		if (name.size() == 1)
+		{
+			return static_cast<uint32_t>(name[0] - 'A'); // sprite frame
+		}
+
+		if (!name.compare(0, 4, "SPR_"))
+		{
+			const INT32 sprite = name == "SPR_FIRSTFREESLOT" ? SPR_FIRSTFREESLOT : DEH_FindSprite(name.c_str() + 4);
+			return sprite != -1 ? static_cast<uint32_t>(sprite) : fail();
+		}
+
+		if (!name.compare(0, 4, "SFX_") || !name.compare(0, 2, "DS"))
+		{
+			const INT32 sfx = DEH_FindSfx(name.c_str() + (name[0] == 'D' ? 2 : 4));
+			return sfx != -1 ? static_cast<uint32_t>(sfx) : fail();
+		}
+
+		return fail();
+	}
+
+	uint32_t simpleexp()
+	{
+		skip_space();
+
+		if (*p_ == '(')
+		{
+			p_++;
+
+			const uint32_t v = subexpr(0);
+
+			skip_space();
+			if (*p_ != ')')
+			{
+				return fail();
+			}
+
+			p_++;
+			return v;
+		}
+
+		if (std::isdigit(static_cast<unsigned char>(*p_)))
+		{
+			const char* start = p_;
+			uint32_t v = 0;
+
+			while (std::isdigit(static_cast<unsigned char>(*p_)))
+			{
+				v = v * 10 + (*p_++ - '0');
+			}
+
+			// Nothing that could overflow, and no hex, decimals or exponents
+			if (p_ - start > 9 || std::isalnum(static_cast<unsigned char>(*p_)) || *p_ == '_' || *p_ == '.')
+			{
+				return fail();
+			}
+
+			return v;
+		}
+
+		if (std::isalpha(static_cast<unsigned char>(*p_)) || *p_ == '_')
+		{
+			const char* start = p_;
+
+			while (std::isalnum(static_cast<unsigned char>(*p_)) || *p_ == '_')
+			{
+				p_++;
+			}
+
+			return constant(std::string(start, p_));
+		}
+
+		return fail();
+	}
+
+	// subexpr from blua/lparser.c
+	uint32_t subexpr(int limit)
+	{
+		uint32_t v;
+
+		skip_space();
+
+		if (*p_ == '-' && p_[1] != '-')
+		{
+			p_++;
+			v = 0u - subexpr(kUnaryPriority);
+		}
+		else
+		{
+			v = simpleexp();
+		}
+
+		while (ok_)
+		{
+			size_t len;
+			const Op op = peek_op(len);
+
+			if (op == Op::kNone || priority(op) <= limit)
+			{
+				break;
+			}
+
+			p_ += len;
+
+			const uint32_t r = subexpr(priority(op));
+
+			if (ok_)
+			{
+				v = arith(op, v, r);
+			}
+		}
+
+		return v;
+	}
+
+public:
+	explicit ConstExpr(const char* word) : p_(word) {}
+
+	bool eval(INT32& value)
+	{
+		const uint32_t v = subexpr(0);
+
+		skip_space();
+
+		if (!ok_ || *p_ != '\0')
+		{
+			return false;
+		}
+
+		value = static_cast<INT32>(v);
+		return true;
+	}
+};
+
+}; // namespace
+
+boolean DEH_FindSymbol(const char *name, INT64 *value)
+{
+	const Symbol* symbol = symbols().find(name);
+
+	if (symbol == nullptr)
+	{
+		return false;
+	}
+
+	*value = symbol->value;
+	return true;
+}
+
+boolean DEH_FindPrefixedSymbol(const char *prefix, const char *name, INT64 *value)
+{
+	return DEH_FindSymbol((std::string(prefix) + name).c_str(), value);
+}
+
+void DEH_AddSymbol(const char *prefix, const char *name, INT64 value)
+{
+	if (symbols().add_freeslot(std::string(prefix) + name, value))
+	{
+		// Lua may have already cached the hardcoded one
+		LUA_InvalidateEnumCache();
+	}
+}
+
+INT32 DEH_FindSprite(const char *name)
+{
+	if (!g_spritesvalid)
+	{
+		g_sprites.clear();
+
+		// Same entries get_sprite and lib_getenum would match
+		for (INT32 i = 0; i < NUMSPRITES; i++)
+		{
+			if (!sprnames[i][4] && strnlen(sprnames[i], 4) == 4)
+			{
+				g_sprites.try_emplace(std::string(sprnames[i], 4), i);
+			}
+		}
+
+		g_spritesvalid = true;
+	}
+
+	if (strnlen(name, 4) < 4)
+	{
+		return -1;
+	}
+
+	auto it = g_sprites.find(std::string(name, 4));
+	return it != g_sprites.end() ? it->second : -1;
+}
+
+INT32 DEH_FindSfx(const char *name)
+{
+	if (!g_sfxvalid)
+	{
+		g_sfx.clear();
+
+		for (INT32 i = 0; i < NUMSFX; i++)
+		{
+			if (S_sfx[i].name)
+			{
+				g_sfx.try_emplace(upper(S_sfx[i].name), i);
+			}
+		}
+
+		g_sfxvalid = true;
+	}
+
+	auto it = g_sfx.find(upper(name));
+	return it != g_sfx.end() ? it->second : -1;
+}
+
+void DEH_InvalidateSprites(void)
+{
+	g_spritesvalid = false;
+}
+
+void DEH_InvalidateSfx(void)
+{
+	g_sfxvalid = false;
+}
+
+boolean DEH_EvalConstant(const char *word, INT32 *value)
+{
+	// LUA_EvalMath cuts off anything longer
+	if (strlen(word) > 1000)
+	{
+		return false;
+	}
+
+	return ConstExpr {word}.eval(*value);
+}
@@ -0,0 +1,52 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  deh_symbols.h
+/// \brief Hashed lookup of named constants for SOC and Lua
+
+#ifndef __DEH_SYMBOLS_H__
+#define __DEH_SYMBOLS_H__
+
+#include "doomtype.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Looks up a constant by its full name, e.g. "S_KART_STILL", "MT_PLAYER",
+// "MF_SOLID" or "SKINCOLOR_RED". Only names whose value can never change
+// once they exist are in here. Case sensitive.
+boolean DEH_FindSymbol(const char *name, INT64 *value);
+
+// DEH_FindSymbol for prefix + name, e.g. "MT_" and "PLAYER"
+boolean DEH_FindPrefixedSymbol(const char *prefix, const char *name, INT64 *value);
+
+// Adds prefix + name, for freeslots. Like the old table scans, a freeslot
+// hides a hardcoded constant of the same name, but not an earlier freeslot.
+void DEH_AddSymbol(const char *prefix, const char *name, INT64 value);
+
+// Index of the sprite named by the first four characters of name, like
+// get_sprite, or -1. Call DEH_InvalidateSprites after renaming any.
+INT32 DEH_FindSprite(const char *name);
+void DEH_InvalidateSprites(void);
+
+// Index of the sound named name, case insensitive like get_sfx, or -1.
+// Call DEH_InvalidateSfx after changing any S_sfx names.
+INT32 DEH_FindSfx(const char *name);
+void DEH_InvalidateSfx(void);
+
+// Evaluates word the same as LUA_EvalMath, if it's simple enough not to
+// need Lua: numbers and constants, combined with parentheses, unary minus
+// and + - * / % & | << >>. Returns false for anything else.
+boolean DEH_EvalConstant(const char *word, INT32 *value);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
@@ -14,10 +14,16 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
 
+#include <fmt/format.h>
 #include <tcb/span.hpp>
 #include <nlohmann/json.hpp>
 
+#include "cxxutil.hpp"
+
 #include "doomdef.h"
 #include "doomtype.h"
 #include "console.h"
@@ -48,6 +54,7 @@
 #include "v_video.h"
 #include "lua_hook.h"
 #include "md5.h" // demo checksums
+#include "lzf.h" // packed replays
 #include "p_saveg.h" // savebuffer_t
 #include "g_party.h"
 
@@ -119,6 +126,7 @@ size_t copy_fixed_buf(void* p, const void* s, size_t n)
 static char demoname[MAX_WADPATH];
 static savebuffer_t demobuf = {0};
 static UINT8 *demotime_p, *demoinfo_p;
+static size_t demoheadersize; // where tic data starts
 static UINT16 demoflags;
 boolean demosynced = true; // console warning message
 
@@ -226,6 +234,245 @@ boolean G_CompatLevel(UINT16 level)
 
 #define DEMOMARKER 0x80 // demobuf.end
 
+// Packed replays
+//
+// A packed replay is a normal replay split into blocks that are
+// compressed on their own, so a reader can decode them one at a
+// time. Unpacking gives back the exact same bytes, checksum and
+// all, so everything past loading reads them the same way.
+//
+// DEMOPACKHEADER
+// UINT16 DEMOPACKVERSION
+// UINT32 size of the unpacked replay
+// UINT32 where the first ghost tic starts, 0 if not a ghost
+// UINT32 block size
+// UINT32 number of blocks
+// UINT32 packed size of each block, DEMOPACKSTORED if not compressed
+// ...block data
+
+#define DEMOPACKHEADER "\xF0" "KartPacked" "\x0F"
+#define DEMOPACKVERSION 0x0001
+#define DEMOPACKHEADERSIZE (12 + 2 + 4*4)
+#define DEMOPACKBLOCK (32*1024)
+#define DEMOPACKMAXBLOCK (1024*1024)
+#define DEMOPACKMAXSIZE (256*1024*1024)
+#define DEMOPACKSTORED 0x80000000
+
+// Room kept decoded ahead of a ghost, more than any one ghost tic
+#define GHOSTWINDOWMARGIN (16*1024)
+
+struct demopack_t
+{
+	UINT32 rawsize;
+	UINT32 headersize;
+	UINT32 blocksize;
+	UINT32 numblocks;
+	const UINT8 *table;
+	const UINT8 *data; // first block
+};
+
+static boolean G_ReadDemoPack(const UINT8 *buffer, size_t size, demopack_t *pack)
+{
+	const UINT8 *p = buffer;
+	size_t datasize = 0;
+	UINT32 i;
+
+	if (size < DEMOPACKHEADERSIZE || memcmp(p, DEMOPACKHEADER, 12))
+		return false;
+	p += 12;
+
+	if (READUINT16(p) != DEMOPACKVERSION)
+		return false;
+
+	pack->rawsize = READUINT32(p);
+	pack->headersize = READUINT32(p);
+	pack->blocksize = READUINT32(p);
+	pack->numblocks = READUINT32(p);
+
+	if (pack->rawsize == 0 || pack->rawsize > DEMOPACKMAXSIZE
+		|| pack->blocksize == 0 || pack->blocksize > DEMOPACKMAXBLOCK
+		|| pack->headersize > pack->rawsize
+		|| pack->numblocks != (pack->rawsize + pack->blocksize - 1) / pack->blocksize
+		|| size - DEMOPACKHEADERSIZE < (size_t)pack->numblocks * 4)
+	{
+		return false;
+	}
+
+	pack->table = p;
+	pack->data = p + pack->numblocks * 4;
+
+	for (i = 0; i < pack->numblocks; i++)
+		datasize += READUINT32(p) & ~DEMOPACKSTORED;
+
+	return (datasize <= size - (pack->data - buffer));
+}
+
+static size_t G_DemoPackBlockLength(const demopack_t *pack, UINT32 block)
+{
+	return std::min<size_t>(pack->blocksize, pack->rawsize - (size_t)block * pack->blocksize);
+}
+
+// Decodes a block from *src and moves *src past it
+static boolean G_UnpackDemoBlock(const demopack_t *pack, UINT32 block, const UINT8 **src, UINT8 *dest)
+{
+	const UINT8 *t = pack->table + block * 4;
+	const UINT32 entry = READUINT32(t);
+	const size_t packedsize = entry & ~DEMOPACKSTORED;
+	const size_t rawsize = G_DemoPackBlockLength(pack, block);
+
+	if (entry & DEMOPACKSTORED)
+	{
+		if (packedsize != rawsize)
+			return false;
+
+		M_Memcpy(dest, *src, rawsize);
+	}
+	else if (lzf_decompress(*src, packedsize, dest, rawsize) != rawsize)
+	{
+		return false;
+	}
+
+	*src += packedsize;
+	return true;
+}
+
+// Decode every block once, so nothing can go wrong later
+static boolean G_CheckDemoPack(const demopack_t *pack)
+{
+	std::vector<UINT8> scratch(pack->blocksize);
+	const UINT8 *src = pack->data;
+	UINT32 i;
+
+	for (i = 0; i < pack->numblocks; i++)
+	{
+		if (!G_UnpackDemoBlock(pack, i, &src, scratch.data()))
+			return false;
+	}
+
+	return true;
+}
+
+static boolean G_PackDemo(const UINT8 *raw, size_t rawsize, size_t headersize, savebuffer_t *out)
+{
+	const UINT32 numblocks = (rawsize + DEMOPACKBLOCK - 1) / DEMOPACKBLOCK;
+	UINT8 *table;
+	UINT32 i;
+
+	// Enough for every block to be stored as is
+	if (!P_SaveBufferAlloc(out, DEMOPACKHEADERSIZE + numblocks * 4 + rawsize))
+		return false;
+
+	M_Memcpy(out->p, DEMOPACKHEADER, 12); out->p += 12;
+	WRITEUINT16(out->p, DEMOPACKVERSION);
+	WRITEUINT32(out->p, rawsize);
+	WRITEUINT32(out->p, headersize);
+	WRITEUINT32(out->p, DEMOPACKBLOCK);
+	WRITEUINT32(out->p, numblocks);
+
+	table = out->p;
+	out->p += numblocks * 4;
+
+	for (i = 0; i < numblocks; i++)
+	{
+		const size_t offset = (size_t)i * DEMOPACKBLOCK;
+		const size_t len = std::min<size_t>(DEMOPACKBLOCK, rawsize - offset);
+		size_t packedsize = lzf_compress(raw + offset, len, out->p, len - 1);
+
+		if (packedsize == 0)
+		{
+			M_Memcpy(out->p, raw + offset, len);
+			WRITEUINT32(table, len | DEMOPACKSTORED);
+			out->p += len;
+		}
+		else
+		{
+			WRITEUINT32(table, packedsize);
+			out->p += packedsize;
+		}
+	}
+
+	out->size = out->p - out->buffer;
+	out->end = out->p;
+	return true;
+}
+
+// out gets a PU_STATIC copy of the unpacked replay
+static boolean G_UnpackDemo(const UINT8 *buffer, size_t size, savebuffer_t *out)
+{
+	demopack_t pack;
+	const UINT8 *src;
+	UINT32 i;
+
+	if (!G_ReadDemoPack(buffer, size, &pack) || !P_SaveBufferAlloc(out, pack.rawsize))
+		return false;
+
+	src = pack.data;
+
+	for (i = 0; i < pack.numblocks; i++)
+	{
+		if (!G_UnpackDemoBlock(&pack, i, &src, out->buffer + (size_t)i * pack.blocksize))
+		{
+			P_SaveBufferFree(out);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Swaps a packed replay in a zone buffer for its unpacked copy.
+// Anything else is left alone; false only for broken packed ones.
+static boolean G_UnpackDemoInPlace(UINT8 **buffer, size_t *size)
+{
+	savebuffer_t unpacked = {0};
+
+	if (*size < 12 || memcmp(*buffer, DEMOPACKHEADER, 12))
+		return true;
+
+	if (!G_UnpackDemo(*buffer, *size, &unpacked))
+		return false;
+
+	Z_Free(*buffer);
+	*buffer = unpacked.buffer;
+	*size = unpacked.size;
+	return true;
+}
+
+// Keeps at least need bytes decoded ahead of a packed ghost's
+// read position, or whatever is left of the replay.
+static void G_FillGhostWindow(demoghost *g, size_t need)
+{
+	demopack_t pack;
+	size_t ahead;
+
+	if (g->window == NULL)
+		return;
+
+	ahead = g->windowend - g->p;
+
+	if (ahead >= need || !G_ReadDemoPack(g->buffer, g->buffersize, &pack) || g->nextblock >= pack.numblocks)
+		return;
+
+	memmove(g->window, g->p, ahead);
+	g->p = g->window;
+	g->windowend = g->window + ahead;
+
+	while (ahead < need && g->nextblock < pack.numblocks)
+	{
+		const UINT8 *src = pack.data + g->nextdata;
+		const size_t len = G_DemoPackBlockLength(&pack, g->nextblock);
+
+		// Already checked by G_AddGhost
+		if (!G_UnpackDemoBlock(&pack, g->nextblock, &src, g->windowend))
+			break;
+
+		g->nextdata = src - pack.data;
+		g->nextblock++;
+		g->windowend += len;
+		ahead += len;
+	}
+}
+
 UINT8 demo_extradata[MAXPLAYERS];
 UINT8 demo_writerng; // 0=no, 1=yes, 2=yes but on a timeout
 static ticcmd_t oldcmd[MAXPLAYERS];
@@ -267,6 +514,7 @@ static ticcmd_t oldcmd[MAXPLAYERS];
 // spare FZT slots 0x20 to 0x80
 
 static mobj_t oldghost[MAXPLAYERS];
+static boolean keyframesdirty; // rewind points to save with the replay
 
 void G_ReadDemoExtraData(void)
 {
@@ -281,6 +529,7 @@ void G_ReadDemoExtraData(void)
 		{
 			memcpy(rewind->oldcmd, oldcmd, sizeof (oldcmd));
 			memcpy(rewind->oldghost, oldghost, sizeof (oldghost));
+			keyframesdirty = true;
 		}
 	}
 
@@ -1295,6 +1544,8 @@ void G_GhostTicker(void)
 
 readghosttic:
 
+		G_FillGhostWindow(g, GHOSTWINDOWMARGIN);
+
 		// Skip normal demo data.
 		ziptic = READUINT8(g->p);
 		xziptic = 0;
@@ -1641,10 +1892,243 @@ typedef struct rewindinfo_s {
 static tic_t currentrewindnum;
 static rewindinfo_t *rewindhead = NULL; // Reverse chronological order
 
-void G_InitDemoRewind(void)
+// Replay keyframes
+//
+// Rewind points for a replay played from a file are saved next to
+// it, so the next time it's watched, seeking anywhere only has to
+// simulate forward from the nearest one. The netgame snapshots are
+// only good for the exact same replay with the exact same files
+// loaded, which the header checks for. The header ends with an MD5 of
+// everything after it, so a damaged file is thrown out rather than
+// restored from.
+
+#define KEYFRAMEHEADER "\xF0" "KartKeyfrm" "\x0F"
+#define KEYFRAMEVERSION 0x0002
+
+static std::string keyframefile; // empty if the replay isn't a file
+static UINT8 keyframechecksum[16];
+static size_t keyframedemosize;
+
+UINT32 G_DemoContentSignature(void)
 {
-	CL_ClearRewinds();
+	UINT32 hash = 2166136261u; // FNV-1a
+
+	auto add = [&hash](const void *data, size_t size)
+	{
+		const UINT8 *p = static_cast<const UINT8*>(data);
 
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ p[i]) * 16777619u;
+		}
+	};
+
+	const INT32 counts[] = {VERSION, SUBVERSION, numskins, nummapheaders, numgametypes, numskincolors};
+
+	add(counts, sizeof counts);
+
+	for (UINT16 i = 0; i < numwadfiles; i++)
+	{
+		add(wadfiles[i]->md5sum, sizeof wadfiles[i]->md5sum);
+	}
+
+	return hash;
+}
+
+static void G_WriteKeyframeHeader(UINT8 *&p, UINT32 count, const UINT8 *payloadmd5)
+{
+	M_Memcpy(p, KEYFRAMEHEADER, 12); p += 12;
+	WRITEUINT16(p, KEYFRAMEVERSION);
+	WRITEUINT8(p, VERSION);
+	WRITEUINT8(p, SUBVERSION);
+	WRITEUINT16(p, DEMOVERSION);
+	WRITEUINT16(p, sizeof (ticcmd_t));
+	WRITEUINT16(p, MAXPLAYERS);
+	WRITEMEM(p, keyframechecksum, 16);
+	WRITEUINT32(p, keyframedemosize);
+	WRITEUINT32(p, G_DemoContentSignature());
+	WRITEUINT32(p, REWIND_POINT_INTERVAL);
+	WRITEUINT32(p, count);
+	WRITEMEM(p, payloadmd5, 16);
+}
+
+#define KEYFRAMEHEADERSIZE (12 + 2 + 1 + 1 + 2 + 2 + 2 + 16 + 4 + 4 + 4 + 4 + 16)
+#define KEYFRAMEPOINTSIZE (4*4 + sizeof (ticcmd_t)*MAXPLAYERS + 6*4*MAXPLAYERS)
+
+static void G_LoadDemoKeyframes(void)
+{
+	savebuffer_t file = {0};
+	UINT8 expect[KEYFRAMEHEADERSIZE];
+	UINT8 *p = expect;
+	UINT8 payloadmd5[16] = {0};
+	UINT8 actualmd5[16];
+	UINT32 count, i;
+	INT32 j;
+
+	if (keyframefile.empty() || !P_SaveBufferFromFile(&file, keyframefile.c_str()))
+		return;
+
+	G_WriteKeyframeHeader(p, 0, payloadmd5);
+
+	// Everything but the count and the MD5 has to match
+	if (file.size < KEYFRAMEHEADERSIZE || memcmp(file.buffer, expect, KEYFRAMEHEADERSIZE - 20))
+	{
+		P_SaveBufferFree(&file);
+		return;
+	}
+
+	file.p = file.buffer + KEYFRAMEHEADERSIZE - 20;
+	count = READUINT32(file.p);
+	READMEM(file.p, payloadmd5, 16);
+
+	md5_buffer((char *)file.p, P_SaveBufferRemaining(&file), actualmd5);
+
+	if (memcmp(payloadmd5, actualmd5, 16))
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Replay keyframes in %s are corrupt, ignoring them\n"), keyframefile.c_str());
+		P_SaveBufferFree(&file);
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		rewind_t *rewind;
+
+		if (P_SaveBufferRemaining(&file) < KEYFRAMEPOINTSIZE)
+			break;
+
+		rewind = static_cast<rewind_t*>(calloc(1, sizeof (rewind_t)));
+		if (!rewind)
+			break;
+
+		rewind->leveltime = READUINT32(file.p);
+		rewind->demopos = READUINT32(file.p);
+		rewind->rawsize = READUINT32(file.p);
+		rewind->savesize = READUINT32(file.p);
+		READMEM(file.p, rewind->oldcmd, sizeof (rewind->oldcmd));
+
+		for (j = 0; j < MAXPLAYERS; j++)
+		{
+			// Only what G_ConsGhostTic looks at
+			rewind->oldghost[j].x = READFIXED(file.p);
+			rewind->oldghost[j].y = READFIXED(file.p);
+			rewind->oldghost[j].z = READFIXED(file.p);
+			rewind->oldghost[j].momx = READFIXED(file.p);
+			rewind->oldghost[j].momy = READFIXED(file.p);
+			rewind->oldghost[j].momz = READFIXED(file.p);
+		}
+
+		if (rewind->savesize > rewind->rawsize || rewind->rawsize > NETSAVEGAMESIZE
+			|| rewind->demopos >= keyframedemosize
+			|| P_SaveBufferRemaining(&file) < rewind->savesize
+			|| !(rewind->savebuffer = static_cast<UINT8*>(malloc(rewind->savesize))))
+		{
+			free(rewind);
+			break;
+		}
+
+		READMEM(file.p, rewind->savebuffer, rewind->savesize);
+
+		CL_AddRewindPoint(rewind);
+	}
+
+	P_SaveBufferFree(&file);
+}
+
+static void G_SaveDemoKeyframes(void)
+{
+	namespace fs = std::filesystem;
+
+	savebuffer_t file = {0};
+	rewind_t *rewind;
+	size_t size = KEYFRAMEHEADERSIZE;
+	UINT32 count = 0;
+	UINT8 payloadmd5[16] = {0};
+	UINT8 *header;
+	INT32 j;
+	boolean ok;
+
+	if (!keyframesdirty || keyframefile.empty() || !cv_replaykeyframes.value)
+		return;
+
+	keyframesdirty = false;
+
+	for (rewind = CL_GetRewindPoints(); rewind; rewind = rewind->next)
+	{
+		size += KEYFRAMEPOINTSIZE + rewind->savesize;
+		count++;
+	}
+
+	if (!count || !P_SaveBufferAlloc(&file, size))
+		return;
+
+	// The MD5 is filled in once the rest is written
+	G_WriteKeyframeHeader(file.p, count, payloadmd5);
+
+	for (rewind = CL_GetRewindPoints(); rewind; rewind = rewind->next)
+	{
+		WRITEUINT32(file.p, rewind->leveltime);
+		WRITEUINT32(file.p, rewind->demopos);
+		WRITEUINT32(file.p, rewind->rawsize);
+		WRITEUINT32(file.p, rewind->savesize);
+		WRITEMEM(file.p, rewind->oldcmd, sizeof (rewind->oldcmd));
+
+		for (j = 0; j < MAXPLAYERS; j++)
+		{
+			WRITEFIXED(file.p, rewind->oldghost[j].x);
+			WRITEFIXED(file.p, rewind->oldghost[j].y);
+			WRITEFIXED(file.p, rewind->oldghost[j].z);
+			WRITEFIXED(file.p, rewind->oldghost[j].momx);
+			WRITEFIXED(file.p, rewind->oldghost[j].momy);
+			WRITEFIXED(file.p, rewind->oldghost[j].momz);
+		}
+
+		WRITEMEM(file.p, rewind->savebuffer, rewind->savesize);
+	}
+
+	md5_buffer((char *)file.buffer + KEYFRAMEHEADERSIZE, file.p - (file.buffer + KEYFRAMEHEADERSIZE), payloadmd5);
+	header = file.buffer;
+	G_WriteKeyframeHeader(header, count, payloadmd5);
+
+	// Don't leave a half written file in place of a good one
+	const std::string tmppath = fmt::format("{}_{}.tmp", keyframefile, rand());
+
+	ok = FIL_WriteFile(tmppath.c_str(), file.buffer, file.p - file.buffer);
+	P_SaveBufferFree(&file);
+
+	if (ok)
+	{
+		std::error_code ec;
+		fs::rename(tmppath, keyframefile, ec);
+		ok = !ec;
+	}
+
+	if (!ok)
+	{
+		std::error_code ec;
+		fs::remove(tmppath, ec);
+		CONS_Alert(CONS_WARNING, M_GetText("Couldn't save replay keyframes to %s\n"), keyframefile.c_str());
+	}
+}
+
+// Called with the replay freshly loaded into demobuf
+static void G_OpenDemoKeyframes(const char *demopath)
+{
+	if (demobuf.size < 96)
+		return;
+
+	keyframefile = std::string(demopath) + ".keyframes";
+	M_Memcpy(keyframechecksum, demobuf.buffer + 80, 16); // after DEMOHEADER, versions and title
+	keyframedemosize = demobuf.size;
+	keyframesdirty = false;
+
+	G_LoadDemoKeyframes();
+}
+
+// The ghost positions for G_PreviewRewind, which are stored again as the
+// replay plays from the start
+static void G_ClearRewindInfo(void)
+{
 	while (rewindhead)
 	{
 		rewindinfo_t *p = rewindhead->prev;
@@ -1655,6 +2139,15 @@ void G_InitDemoRewind(void)
 	currentrewindnum = 0;
 }
 
+void G_InitDemoRewind(void)
+{
+	G_SaveDemoKeyframes();
+	keyframefile.clear();
+
+	CL_ClearRewinds();
+	G_ClearRewindInfo();
+}
+
 void G_StoreRewindInfo(void)
 {
 	static UINT8 timetolog = 8;
@@ -1778,22 +2271,32 @@ void G_ConfirmRewind(tic_t rewindtime)
 	else
 	{
 		rewind_t *rewind;
+		boolean skipahead;
+
 		sound_disabled = true; // Prevent sound spam
-		demo.rewinding = true;
 
-		rewind = CL_RewindToTime(rewindtime);
+		// Seeking forward only restores a point if one is closer
+		// than where playback already is.
+		rewind = CL_FindRewindPoint(rewindtime);
+		skipahead = (!demo.rewinding && rewindtime > leveltime && (!rewind || rewind->leveltime <= leveltime));
 
-		if (rewind)
-		{
-			demobuf.p = demobuf.buffer + rewind->demopos;
-			memcpy(oldcmd, rewind->oldcmd, sizeof (oldcmd));
-			memcpy(oldghost, rewind->oldghost, sizeof (oldghost));
-			paused = false;
-		}
-		else
+		demo.rewinding = true;
+
+		if (!skipahead)
 		{
-			demo.rewinding = true;
-			G_DoPlayDemo(NULL); // Restart the current demo
+			rewind = CL_RewindToTime(rewindtime);
+
+			if (rewind)
+			{
+				demobuf.p = demobuf.buffer + rewind->demopos;
+				memcpy(oldcmd, rewind->oldcmd, sizeof (oldcmd));
+				memcpy(oldghost, rewind->oldghost, sizeof (oldghost));
+				paused = false;
+			}
+			else
+			{
+				G_DoPlayDemo(NULL); // Restart the current demo
+			}
 		}
 	}
 
@@ -2380,6 +2883,8 @@ void G_BeginRecording(void)
 	if (demoflags & DF_LUAVARS)
 		LUA_Archive(&demobuf, false);
 
+	demoheadersize = demobuf.p - demobuf.buffer;
+
 	memset(&oldcmd,0,sizeof(oldcmd));
 	memset(&oldghost,0,sizeof(oldghost));
 	memset(&ghostext,0,sizeof(ghostext));
@@ -2455,7 +2960,7 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 	UINT32 oldtime = UINT32_MAX, newtime = UINT32_MAX;
 	UINT32 oldlap = UINT32_MAX, newlap = UINT32_MAX;
 	UINT16 oldversion;
-	size_t bufsize ATTRUNUSED;
+	size_t bufsize;
 	UINT8 c;
 	UINT16 s ATTRUNUSED;
 	UINT8 aflags = 0;
@@ -2465,6 +2970,12 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 	FIL_DefaultExtension(newname, ".lmp");
 	bufsize = FIL_ReadFile(newname, &buffer);
 	I_Assert(bufsize != 0);
+	if (!G_UnpackDemoInPlace(&buffer, &bufsize))
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("File '%s' is corrupt.\n"), newname);
+		Z_Free(buffer);
+		return 0;
+	}
 	p = buffer;
 
 	// read demo header
@@ -2504,11 +3015,12 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 
 	// load old file
 	FIL_DefaultExtension(oldname, ".lmp");
-	if (!FIL_ReadFile(oldname, &buffer))
+	if (!(bufsize = FIL_ReadFile(oldname, &buffer)))
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), oldname);
 		return UINT8_MAX;
 	}
+	G_UnpackDemoInPlace(&buffer, &bufsize);
 	p = buffer;
 
 	// read demo header
@@ -2633,6 +3145,22 @@ static bool load_ubjson_standing(menudemo_t* pdemo, tcb::span<std::byte> slice,
 void G_LoadDemoInfo(menudemo_t *pdemo, boolean allownonmultiplayer)
 {
 	savebuffer_t info = {0};
+
+	if (!P_SaveBufferFromFile(&info, pdemo->filepath))
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), pdemo->filepath);
+		pdemo->type = MD_INVALID;
+		sprintf(pdemo->title, "INVALID REPLAY");
+		return;
+	}
+
+	G_LoadDemoInfoFromBuffer(pdemo, &info, allownonmultiplayer);
+	P_SaveBufferFree(&info);
+}
+
+void G_LoadDemoInfoFromBuffer(menudemo_t *pdemo, const savebuffer_t *buffer, boolean allownonmultiplayer)
+{
+	savebuffer_t info = *buffer;
 	UINT8 *extrainfo_p;
 	UINT8 version, subversion, worknumskins, skinid;
 	UINT16 pdemoflags;
@@ -2642,15 +3170,23 @@ void G_LoadDemoInfo(menudemo_t *pdemo, boolean allownonmultiplayer)
 	char mapname[MAXMAPLUMPNAME],gtname[MAXGAMETYPELENGTH];
 	INT32 i;
 
-	if (!P_SaveBufferFromFile(&info, pdemo->filepath))
+	if (info.size < 12)
 	{
-		CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), pdemo->filepath);
-		goto badreplay;
+		goto corrupt;
 	}
 
-	if (info.size < 12)
+	if (!memcmp(info.p, DEMOPACKHEADER, 12))
 	{
-		goto corrupt;
+		savebuffer_t unpacked = {0};
+
+		if (!G_UnpackDemo(info.buffer, info.size, &unpacked))
+		{
+			goto corrupt;
+		}
+
+		G_LoadDemoInfoFromBuffer(pdemo, &unpacked, allownonmultiplayer);
+		P_SaveBufferFree(&unpacked);
+		return;
 	}
 
 	if (memcmp(info.p, DEMOHEADER, 12))
@@ -2902,7 +3438,6 @@ void G_LoadDemoInfo(menudemo_t *pdemo, boolean allownonmultiplayer)
 
 	// I think that's everything we need?
 	Z_Free(skinlist);
-	P_SaveBufferFree(&info);
 	return;
 
 corrupt:
@@ -2912,7 +3447,6 @@ badreplay:
 	pdemo->type = MD_INVALID;
 	sprintf(pdemo->title, "INVALID REPLAY");
 	Z_Free(skinlist);
-	P_SaveBufferFree(&info);
 }
 
 //
@@ -2945,6 +3479,7 @@ void G_DoPlayDemoEx(const char *defdemoname, lumpnum_t deflumpnum)
 
 	boolean spectator, bot;
 	UINT8 slots[MAXPLAYERS], lastfakeskin[MAXPLAYERS];
+	const char *keyframepath = NULL;
 
 #if defined(SKIPERRORS) && !defined(DEVELOP)
 	// RR: Don't print warnings for staff ghosts, since they'll inevitably
@@ -2954,7 +3489,11 @@ void G_DoPlayDemoEx(const char *defdemoname, lumpnum_t deflumpnum)
 	boolean skiperrors = true;
 #endif
 
-	G_InitDemoRewind();
+	// Restarting the same replay keeps its rewind points
+	if (deflumpnum != LUMPERROR || defdemoname != NULL)
+		G_InitDemoRewind();
+	else
+		G_ClearRewindInfo();
 
 	gtname[MAXGAMETYPELENGTH-1] = '\0';
 
@@ -3007,6 +3546,8 @@ void G_DoPlayDemoEx(const char *defdemoname, lumpnum_t deflumpnum)
 				return;
 			}
 
+			keyframepath = defdemoname;
+
 #if defined(SKIPERRORS) && !defined(DEVELOP)
 			skiperrors = false; // DO print warnings for external lumps
 #endif
@@ -3082,6 +3623,23 @@ void G_DoPlayDemoEx(const char *defdemoname, lumpnum_t deflumpnum)
 		}
 	}
 
+	if (!G_UnpackDemoInPlace(&demobuf.buffer, &demobuf.size))
+	{
+		snprintf(msg, 1024, M_GetText("%s is corrupt and cannot be played.\n"), pdemoname);
+		CONS_Alert(CONS_ERROR, "%s", msg);
+		M_StartMessage("Demo Playback", msg, NULL, MM_NOTHING, NULL, "Return to Menu");
+		Z_Free(pdemoname);
+		Z_Free(demobuf.buffer);
+		gameaction = ga_nothing;
+		return;
+	}
+
+	demobuf.p = demobuf.buffer;
+	demobuf.end = demobuf.buffer + demobuf.size;
+
+	if (keyframepath)
+		G_OpenDemoKeyframes(keyframepath);
+
 	// read demo header
 	gameaction = ga_nothing;
 	demo.playback = true;
@@ -3546,8 +4104,51 @@ void G_AddGhost(savebuffer_t *buffer, const char *defdemoname)
 	skin_t *ghskin = &skins[0];
 	UINT8 worknumskins;
 	democharlist_t *skinlist = NULL;
+	demopack_t pack;
+	demoghost stream = {};
+	savebuffer_t view = *buffer; // whatever p is reading from
 
-	p = buffer->buffer;
+	auto free_window = srb2::finally([&stream]() { Z_Free(stream.window); });
+
+	if (G_ReadDemoPack(buffer->buffer, buffer->size, &pack))
+	{
+		if (!G_CheckDemoPack(&pack))
+		{
+			CONS_Alert(CONS_NOTICE, M_GetText("Ghost %s: Replay is corrupt.\n"), defdemoname);
+			P_SaveBufferFree(buffer);
+			return;
+		}
+
+		if (pack.headersize != 0)
+		{
+			// Only keep a block or two decoded at a time
+			stream.buffer = buffer->buffer;
+			stream.buffersize = buffer->size;
+			stream.window = static_cast<UINT8*>(Z_Malloc(pack.headersize + GHOSTWINDOWMARGIN + pack.blocksize, PU_LEVEL, NULL));
+			stream.windowend = stream.p = stream.window;
+
+			G_FillGhostWindow(&stream, pack.headersize + GHOSTWINDOWMARGIN);
+
+			view.buffer = view.p = stream.window;
+			view.end = stream.windowend;
+			view.size = view.end - view.buffer;
+		}
+		else if (!G_UnpackDemoInPlace(&buffer->buffer, &buffer->size))
+		{
+			CONS_Alert(CONS_NOTICE, M_GetText("Ghost %s: Replay is corrupt.\n"), defdemoname);
+			P_SaveBufferFree(buffer);
+			return;
+		}
+		else
+		{
+			Z_ChangeTag(buffer->buffer, PU_LEVEL);
+			buffer->p = buffer->buffer;
+			buffer->end = buffer->buffer + buffer->size;
+			view = *buffer;
+		}
+	}
+
+	p = view.buffer;
 
 	// read demo header
 	if (memcmp(p, DEMOHEADER, 12))
@@ -3620,9 +4221,9 @@ void G_AddGhost(savebuffer_t *buffer, const char *defdemoname)
 
 	{
 		// FIXME: the rest of this function is not modifying buffer->p directly so fuck it
-		buffer->p = p;
-		skinlist = G_LoadDemoSkins(ghostsizes, buffer, &worknumskins, true);
-		p = buffer->p;
+		view.p = p;
+		skinlist = G_LoadDemoSkins(ghostsizes, &view, &worknumskins, true);
+		p = view.p;
 	}
 	if (!skinlist)
 	{
@@ -3708,7 +4309,7 @@ void G_AddGhost(savebuffer_t *buffer, const char *defdemoname)
 	p += 1; // lives
 	p += 2; // rings
 
-	if (READUINT8(p) != 0xFF)
+	if (READUINT8(p) != 0xFF || p > view.end)
 	{
 		CONS_Alert(CONS_NOTICE, M_GetText("Failed to add ghost %s: Invalid player slot (bad terminator)\n"), defdemoname);
 		Z_Free(skinlist);
@@ -3721,9 +4322,19 @@ void G_AddGhost(savebuffer_t *buffer, const char *defdemoname)
 	gh->sizes = ghostsizes;
 	gh->next = ghosts;
 	gh->buffer = buffer->buffer;
+	gh->buffersize = buffer->size;
 	M_Memcpy(gh->checksum, md5, 16);
 	gh->p = p;
 
+	if (stream.window)
+	{
+		gh->window = stream.window;
+		gh->windowend = stream.windowend;
+		gh->nextblock = stream.nextblock;
+		gh->nextdata = stream.nextdata;
+		stream.window = NULL; // the ghost owns it now
+	}
+
 	gh->numskins = worknumskins;
 	gh->skinlist = skinlist;
 
@@ -3789,6 +4400,7 @@ void G_FreeGhosts(void)
 	{
 		demoghost *next = ghosts->next;
 		Z_Free(ghosts->skinlist);
+		Z_Free(ghosts->window);
 		Z_Free(ghosts);
 		ghosts = next;
 	}
@@ -3796,7 +4408,7 @@ void G_FreeGhosts(void)
 }
 
 // A simplified version of G_AddGhost...
-staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer)
+staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer, size_t size)
 {
 	UINT8 *p = buffer;
 	UINT16 ghostversion;
@@ -3804,10 +4416,21 @@ staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer)
 	INT32 i;
 	staffbrief_t temp = {0};
 	staffbrief_t *ret = NULL;
+	savebuffer_t unpacked = {0};
 
 	temp.name[0] = '\0';
 	temp.time = temp.lap = UINT32_MAX;
 
+	if (size >= 12 && !memcmp(p, DEMOPACKHEADER, 12))
+	{
+		if (!G_UnpackDemo(buffer, size, &unpacked))
+		{
+			goto fail;
+		}
+
+		p = unpacked.buffer;
+	}
+
 	// read demo header
 	if (memcmp(p, DEMOHEADER, 12))
 	{
@@ -3902,6 +4525,7 @@ staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer)
 
 	// Ok, no longer any reason to care, bye
 fail:
+	P_SaveBufferFree(&unpacked);
 	return ret;
 }
 
@@ -4022,6 +4646,8 @@ static void G_StopTimingDemo(void)
 // called from stopdemo command, map command, and g_checkdemoStatus.
 void G_StopDemo(void)
 {
+	G_InitDemoRewind();
+
 	Z_Free(demobuf.buffer);
 	demobuf.buffer = NULL;
 	demo.playback = false;
@@ -4206,7 +4832,21 @@ void G_SaveDemo(void)
 	md5_buffer((char *)p+16, (demobuf.buffer + length) - (p+16), p);
 #endif
 
-	bool saved = FIL_WriteFile(demoname, demobuf.buffer, demobuf.p - demobuf.buffer); // finally output the file.
+	bool saved;
+	savebuffer_t packed = {0};
+
+	// Only replays that can be loaded as ghosts get to stream them
+	if (cv_replaycompression.value && G_PackDemo(demobuf.buffer, demobuf.p - demobuf.buffer,
+		(demoflags & DF_LUAVARS) ? 0 : demoheadersize, &packed))
+	{
+		saved = FIL_WriteFile(demoname, packed.buffer, packed.size); // finally output the file.
+		P_SaveBufferFree(&packed);
+	}
+	else
+	{
+		saved = FIL_WriteFile(demoname, demobuf.buffer, demobuf.p - demobuf.buffer); // finally output the file.
+	}
+
 	G_ResetDemoRecording();
 
 	if (!modeattacking)
@@ -4229,6 +4869,270 @@ void G_SaveDemo(void)
 	}
 }
 
+// Where the tic data of a replay starts, which is as far as
+// G_AddGhost reads. 0 for replays that can't be ghosts.
+static size_t G_GhostHeaderSize(UINT8 *buffer, size_t size)
+{
+	UINT8 *p = buffer;
+	UINT16 version, flags, count;
+	UINT8 player;
+	INT32 i;
+
+	if (size < 12+2+2+64+16+4 || memcmp(p, DEMOHEADER, 12))
+		return 0;
+
+	p += 12; // DEMOHEADER
+	p++; // VERSION
+	p++; // SUBVERSION
+	version = READUINT16(p);
+
+	const DemoBufferSizes sizes = get_buffer_sizes(version);
+
+	p += 64; // full demo title
+	p += 16; // demo checksum
+
+	if (memcmp(p, "PLAY", 4))
+		return 0;
+	p += 4;
+
+	SKIPSTRING(p); // gamemap
+	p += 16; // mapmd5
+
+	flags = READUINT16(p);
+	if (!(flags & DF_GHOST) || (flags & DF_LUAVARS))
+		return 0;
+
+	SKIPSTRING(p); // gametype
+	p++; // numlaps
+	G_SkipDemoExtraFiles(&p);
+	G_SkipDemoSkins(&p, sizes);
+
+	if (flags & ATTACKING_TIME)
+		p += 4;
+	if (flags & ATTACKING_LAP)
+		p += 4;
+
+	for (i = 0; i < PRNUMSYNCED; i++)
+		p += 4; // random seed
+
+	p += 4; // Extrainfo location marker
+
+	count = READUINT16(p); // net var data
+	while (count--)
+	{
+		SKIPSTRING(p);
+		SKIPSTRING(p);
+		p++; // stealth
+	}
+
+	if ((flags & DF_GRANDPRIX))
+		p += 3;
+
+	{
+		UINT32 unlockables = READUINT32(p);
+		p += unlockables;
+	}
+
+	p++; // mapmusrng
+
+	while ((size_t)(p - buffer) < size && (player = READUINT8(p)) != 0xFF)
+	{
+		if (player >= MAXPLAYERS)
+			return 0;
+
+		if (READUINT8(p) & DEMO_BOT)
+			p += 3; // bot difficulty, diffincrease, rival
+
+		p += sizes.player_name;
+		p += MAXAVAILABILITY;
+		p += 2; // skin, lastfakeskin
+		p += sizes.color_name;
+		p += sizes.skin_name + sizes.color_name; // follower
+		p += 4; // score
+		p += 2; // powerlevel
+		p += 4; // followitem
+		p += 1; // lives
+		p += 2; // rings
+	}
+
+	if ((size_t)(p - buffer) > size)
+		return 0;
+
+	return p - buffer;
+}
+
+enum convertreplay_t
+{
+	CONVERT_FAILED,
+	CONVERT_DONE,
+	CONVERT_SKIPPED, // already in that format
+};
+
+// Checks out holds the same replay as in, before it replaces it
+static boolean G_CheckConvertedReplay(const savebuffer_t *in, const savebuffer_t *out, boolean unpack)
+{
+	savebuffer_t check = {0};
+	boolean same;
+
+	if (unpack)
+		return (out->size >= 12 && !memcmp(out->buffer, DEMOHEADER, 12));
+
+	if (!G_UnpackDemo(out->buffer, out->size, &check))
+		return false;
+
+	same = (check.size == in->size && !memcmp(check.buffer, in->buffer, in->size));
+	P_SaveBufferFree(&check);
+	return same;
+}
+
+static convertreplay_t G_ConvertReplay(const char *path, boolean unpack, size_t *oldsize, size_t *newsize)
+{
+	namespace fs = std::filesystem;
+
+	savebuffer_t in = {0}, out = {0};
+	boolean packed, ok;
+
+	if (!P_SaveBufferFromFile(&in, path))
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), path);
+		return CONVERT_FAILED;
+	}
+
+	packed = (in.size >= 12 && !memcmp(in.buffer, DEMOPACKHEADER, 12));
+
+	if (!packed && (in.size < 12 || memcmp(in.buffer, DEMOHEADER, 12)))
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("%s is not a Ring Racers replay file.\n"), path);
+		P_SaveBufferFree(&in);
+		return CONVERT_FAILED;
+	}
+
+	*oldsize = *newsize = in.size;
+
+	if (packed == !unpack)
+	{
+		P_SaveBufferFree(&in);
+		return CONVERT_SKIPPED;
+	}
+
+	if (unpack)
+		ok = G_UnpackDemo(in.buffer, in.size, &out);
+	else
+		ok = G_PackDemo(in.buffer, in.size, G_GhostHeaderSize(in.buffer, in.size), &out);
+
+	if (ok && !G_CheckConvertedReplay(&in, &out, unpack))
+	{
+		P_SaveBufferFree(&out);
+		ok = false;
+	}
+
+	P_SaveBufferFree(&in);
+
+	if (!ok)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("%s is corrupt and cannot be converted.\n"), path);
+		return CONVERT_FAILED;
+	}
+
+	// This is the only copy of the replay, so never leave it half written
+	const std::string tmppath = fmt::format("{}_{}.tmp", path, rand());
+
+	ok = FIL_WriteFile(tmppath.c_str(), out.buffer, out.size);
+	*newsize = out.size;
+	P_SaveBufferFree(&out);
+
+	if (ok)
+	{
+		std::error_code ec;
+		fs::rename(tmppath, path, ec);
+		ok = !ec;
+	}
+
+	if (!ok)
+	{
+		std::error_code ec;
+		fs::remove(tmppath, ec);
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't write %s\n"), path);
+		return CONVERT_FAILED;
+	}
+
+	return CONVERT_DONE;
+}
+
+void Command_ConvertReplay_f(void)
+{
+	namespace fs = std::filesystem;
+
+	const boolean unpack = (COM_CheckParm("-unpack") != 0);
+	std::vector<fs::path> files;
+	size_t oldtotal = 0, newtotal = 0, converted = 0, skipped = 0, failed = 0;
+
+	if (COM_Argc() < 2)
+	{
+		CONS_Printf("convertreplay <file or folder> [-unpack]:\n");
+		CONS_Printf(M_GetText(
+					"Rewrite replays in the packed format, or back to the plain one with \"-unpack\".\n"
+					"Folders are converted with everything in them. Paths are from your Kart directory.\n"));
+		return;
+	}
+
+	try
+	{
+		const fs::path root = fs::path(srb2home) / COM_Argv(1);
+
+		if (fs::is_directory(root))
+		{
+			for (const fs::directory_entry& entry : fs::recursive_directory_iterator(root))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == ".lmp")
+					files.push_back(entry.path());
+			}
+		}
+		else
+		{
+			files.push_back(root);
+		}
+	}
+	catch (const fs::filesystem_error& ex)
+	{
+		CONS_Alert(CONS_ERROR, "convertreplay: %s\n", ex.what());
+		return;
+	}
+
+	for (const fs::path& file : files)
+	{
+		size_t oldsize, newsize;
+
+		switch (G_ConvertReplay(file.string().c_str(), unpack, &oldsize, &newsize))
+		{
+			case CONVERT_FAILED:
+				failed++;
+				break;
+
+			case CONVERT_SKIPPED:
+				skipped++;
+				break;
+
+			case CONVERT_DONE:
+				converted++;
+				oldtotal += oldsize;
+				newtotal += newsize;
+				break;
+		}
+	}
+
+	CONS_Printf(M_GetText("Converted %s replays, %s KB -> %s KB"),
+		sizeu1(converted), sizeu2(oldtotal >> 10), sizeu3(newtotal >> 10));
+
+	if (skipped)
+		CONS_Printf(M_GetText(", %s already %s"), sizeu4(skipped), unpack ? "unpacked" : "packed");
+
+	if (failed)
+		CONS_Printf(M_GetText(", %s failed"), sizeu5(failed));
+
+	CONS_Printf("\n");
+}
+
 boolean G_CheckDemoTitleEntry(void)
 {
 	if (menuactive || chat_on)
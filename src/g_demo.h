@@ -65,7 +65,7 @@ extern "C" {
 // DEMO playback/recording related stuff.
 // ======================================
 
-extern consvar_t cv_recordmultiplayerdemos, cv_netdemosyncquality;
+extern consvar_t cv_recordmultiplayerdemos, cv_netdemosyncquality, cv_replaykeyframes, cv_replaycompression;
 
 extern tic_t demostarttime;
 
@@ -192,6 +192,10 @@ void G_StoreRewindInfo(void);
 void G_PreviewRewind(tic_t previewtime);
 void G_ConfirmRewind(tic_t rewindtime);
 
+// Changes whenever the loaded files would make saved game
+// states or parsed replay headers mean something else
+UINT32 G_DemoContentSignature(void);
+
 struct DemoBufferSizes
 {
 	size_t player_name;
@@ -204,6 +208,12 @@ struct DemoBufferSizes
 struct demoghost {
 	UINT8 checksum[16];
 	UINT8 *buffer, *p, color;
+	size_t buffersize;
+	// Packed replays are decoded into window a block at a time,
+	// then p points into window instead of buffer.
+	UINT8 *window, *windowend;
+	UINT32 nextblock;
+	size_t nextdata;
 	UINT8 fadein;
 	UINT16 version;
 	UINT8 numskins;
@@ -229,7 +239,7 @@ void G_DoPlayDemoEx(const char *defdemoname, lumpnum_t deflumpnum);
 #define G_DoPlayDemo(defdemoname) G_DoPlayDemoEx(defdemoname, LUMPERROR)
 void G_TimeDemo(const char *name);
 void G_AddGhost(savebuffer_t *buffer, const char *defdemoname);
-staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer);
+staffbrief_t *G_GetStaffGhostBrief(UINT8 *buffer, size_t size);
 void G_FreeGhosts(void);
 void G_DoneLevelLoad(void);
 
@@ -237,9 +247,16 @@ void G_StopDemo(void);
 boolean G_CheckDemoStatus(void);
 
 void G_LoadDemoInfo(menudemo_t *pdemo, boolean allownonmultiplayer);
+
+// Same as G_LoadDemoInfo, for a replay that has already been read into memory.
+// pdemo->filepath is only used for error messages. The buffer is not freed.
+void G_LoadDemoInfoFromBuffer(menudemo_t *pdemo, const savebuffer_t *buffer, boolean allownonmultiplayer);
 void G_DeferedPlayDemo(const char *demo);
 
 void G_SaveDemo(void);
+
+// Console command: pack or unpack replay files in place
+void Command_ConvertReplay_f(void);
 void G_ResetDemoRecording(void);
 
 boolean G_CheckDemoTitleEntry(void);
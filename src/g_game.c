@@ -2513,6 +2513,8 @@ void G_PlayerReborn(INT32 player, boolean betweenmaps)
 
 	if (saveroundconditions)
 		memcpy(&p->roundconditions, &roundconditions, sizeof (p->roundconditions));
+	else
+		p->roundconditions.checkthisframe |= UCD_ROUNDSTART;
 
 	if (tallyactive == true)
 	{
@@ -11,15 +11,24 @@
 #include "g_gamedata.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstddef>
 #include <exception>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 #include <fmt/format.h>
 
 #include "io/streams.hpp"
+#include "command.h"
 #include "d_main.h"
+#include "i_system.h"
 #include "m_argv.h"
 #include "m_cond.h"
 #include "g_game.h"
@@ -32,6 +41,249 @@ using json = nlohmann::json;
 #define GD_VERSION_MAJOR (0xBA5ED321)
 #define GD_VERSION_MINOR (1)
 
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Saves of the same file requested this close together are written once...
+constexpr auto kSaveCoalesce = std::chrono::milliseconds(250);
+// ...but one that keeps being requested is still written this often.
+constexpr auto kSaveMaxDelay = std::chrono::seconds(2);
+
+struct SaveJob
+{
+	std::string path;
+	std::string tmppath;
+	std::function<std::vector<std::byte>()> serialize;
+	std::string failure;
+	bool fatal;
+	Clock::time_point first;
+	Clock::time_point last;
+	uint32_t requests;
+};
+
+struct SaveResult
+{
+	std::string path;
+	std::string failure;
+	std::string error; // empty if it was written
+	bool fatal;
+	uint32_t requests;
+	Clock::duration time;
+};
+
+// Writes everything queued with srb2::queue_save on its own thread.
+// The serializers only touch the snapshot they were given, so nothing
+// else is shared with the main thread.
+class SaveWriter
+{
+public:
+	SaveWriter() : thread_ {[this] { run(); }} {}
+
+	~SaveWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lock {mutex_};
+			stop_ = true;
+		}
+		wake_.notify_all();
+		thread_.join();
+	}
+
+	SaveWriter(const SaveWriter&) = delete;
+	SaveWriter& operator=(const SaveWriter&) = delete;
+
+	void queue(SaveJob job)
+	{
+		{
+			std::lock_guard<std::mutex> lock {mutex_};
+			auto it = pending_.find(job.path);
+
+			job.last = Clock::now();
+			if (it != pending_.end())
+			{
+				// Not written yet, so this snapshot replaces it
+				job.first = it->second.first;
+				job.requests = it->second.requests + 1;
+				it->second = std::move(job);
+			}
+			else
+			{
+				job.first = job.last;
+				job.requests = 1;
+				std::string path = job.path;
+				pending_.emplace(std::move(path), std::move(job));
+				outstanding_.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		wake_.notify_all();
+	}
+
+	// Blocks until everything queued so far is on disk.
+	void flush()
+	{
+		std::unique_lock<std::mutex> lock {mutex_};
+		flushing_++;
+		wake_.notify_all();
+		idle_.wait(lock, [this] { return pending_.empty() && !writing_; });
+		flushing_--;
+	}
+
+	// flush for crash handlers. The crashed thread may be holding the
+	// mutex, so this never touches it: it only tells the writer to stop
+	// coalescing and polls until nothing is left, or gives up.
+	void finish(std::chrono::seconds timeout)
+	{
+		const Clock::time_point deadline = Clock::now() + timeout;
+
+		hurry_.store(true, std::memory_order_relaxed);
+
+		// A writer waiting out a coalesce delay notices within kSaveMaxDelay
+		while (outstanding_.load(std::memory_order_acquire) > 0 && Clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	std::vector<SaveResult> take_results()
+	{
+		std::lock_guard<std::mutex> lock {mutex_};
+		return std::exchange(results_, {});
+	}
+
+private:
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable idle_;
+	std::unordered_map<std::string, SaveJob> pending_;
+	std::vector<SaveResult> results_;
+	int flushing_ = 0;
+	bool writing_ = false;
+	bool stop_ = false;
+	std::atomic<int> outstanding_ {0}; // pending_ and the one being written
+	std::atomic<bool> hurry_ {false}; // set by finish, in place of flushing_
+	std::thread thread_; // last, so the rest is ready when it starts
+
+	void run()
+	{
+		std::unique_lock<std::mutex> lock {mutex_};
+
+		for (;;)
+		{
+			if (pending_.empty())
+			{
+				if (stop_)
+					return;
+
+				idle_.notify_all();
+				wake_.wait(lock);
+				continue;
+			}
+
+			auto next = pending_.begin();
+			Clock::time_point due = Clock::time_point::max();
+
+			for (auto it = pending_.begin(); it != pending_.end(); ++it)
+			{
+				Clock::time_point when = std::min(it->second.last + kSaveCoalesce, it->second.first + kSaveMaxDelay);
+				if (when < due)
+				{
+					due = when;
+					next = it;
+				}
+			}
+
+			if (!flushing_ && !stop_ && !hurry_.load(std::memory_order_relaxed) && Clock::now() < due)
+			{
+				wake_.wait_until(lock, due);
+				continue;
+			}
+
+			SaveJob job = std::move(next->second);
+			pending_.erase(next);
+			writing_ = true;
+
+			lock.unlock();
+			SaveResult result = write(job);
+			outstanding_.fetch_sub(1, std::memory_order_release);
+			lock.lock();
+
+			writing_ = false;
+			results_.push_back(std::move(result));
+		}
+	}
+
+	static SaveResult write(SaveJob& job)
+	{
+		SaveResult result {std::move(job.path), std::move(job.failure), {}, job.fatal, job.requests, {}};
+		const Clock::time_point start = Clock::now();
+
+		try
+		{
+			std::vector<std::byte> data = job.serialize();
+
+			srb2::io::FileStream file {job.tmppath, srb2::io::FileStreamMode::kWrite};
+			srb2::io::write_exact(file, tcb::make_span(std::as_const(data)));
+			file.close();
+
+			// Now that the save is written successfully, move it over the old save
+			fs::rename(job.tmppath, result.path);
+		}
+		catch (const std::exception& ex)
+		{
+			result.error = ex.what();
+		}
+		catch (...)
+		{
+			result.error = "unknown error";
+		}
+
+		result.time = Clock::now() - start;
+		return result;
+	}
+};
+
+std::unique_ptr<SaveWriter> g_savewriter;
+
+void report_saves(const std::vector<SaveResult>& results)
+{
+	for (const SaveResult& result : results)
+	{
+		if (!result.error.empty())
+		{
+			if (result.fatal)
+				I_Error("%s\n\nException: %s", result.failure.c_str(), result.error.c_str());
+
+			CONS_Alert(CONS_ERROR, "%s: %s\n", result.failure.c_str(), result.error.c_str());
+			continue;
+		}
+
+#ifdef DEVELOP
+		CONS_Alert(CONS_NOTICE, "Saved %s (%u requests, %d us)\n", result.path.c_str(), result.requests,
+			static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(result.time).count()));
+#endif
+	}
+}
+
+} // namespace
+
+void srb2::queue_save(std::string path, std::function<std::vector<std::byte>()> serialize, std::string failure, bool fatal)
+{
+	SaveJob job {};
+
+	if (!g_savewriter)
+		g_savewriter = std::make_unique<SaveWriter>();
+
+	job.tmppath = fmt::format("{}_{}.tmp", path, rand());
+	job.path = std::move(path);
+	job.serialize = std::move(serialize);
+	job.failure = std::move(failure);
+	job.fatal = fatal;
+
+	g_savewriter->queue(std::move(job));
+}
+
 void srb2::save_ng_gamedata()
 {
 	if (gamedata == NULL || !gamedata->loaded)
@@ -285,51 +537,35 @@ void srb2::save_ng_gamedata()
 		ng.sealedswaps.emplace_back(std::move(sealedswap));
 	}
 
-	std::string gamedataname_s {gamedatafilename};
-	fs::path savepath {fmt::format("{}/{}", srb2home, gamedataname_s)};
-	int random_number = rand();
-	fs::path tmpsavepath {fmt::format("{}/{}_{}.tmp", srb2home, gamedataname_s, random_number)};
-
-	json ngdata_json = ng;
-
-	try
-	{
-		std::string tmpsavepathstring = tmpsavepath.string();
-		srb2::io::FileStream file {tmpsavepathstring, srb2::io::FileStreamMode::kWrite};
-
-		// The header is necessary to validate during loading.
-		srb2::io::write(static_cast<uint32_t>(GD_VERSION_MAJOR), file); // major
-		srb2::io::write(static_cast<uint8_t>(GD_VERSION_MINOR), file); // minor/flags
-		srb2::io::write(static_cast<uint8_t>(gamedata->evercrashed), file); // dirty (crash recovery)
+	const uint8_t dirty = gamedata->evercrashed;
 
-		std::vector<uint8_t> ubjson = json::to_ubjson(ng);
-		srb2::io::write_exact(file, tcb::as_bytes(tcb::make_span(ubjson)));
-		file.close();
-	}
-	catch (const std::exception& ex)
-	{
-		CONS_Alert(CONS_ERROR, "NG Gamedata save failed: %s\n", ex.what());
-	}
-	catch (...)
-	{
-		CONS_Alert(CONS_ERROR, "NG Gamedata save failed\n");
-	}
-
-	try
-	{
-		// Now that the save is written successfully, move it over the old save
-		fs::rename(tmpsavepath, savepath);
-	}
-	catch (const fs::filesystem_error& ex)
-	{
-		CONS_Alert(CONS_ERROR, "NG Gamedata save succeeded but did not replace old save successfully: %s\n", ex.what());
-	}
+	srb2::queue_save(
+		fmt::format("{}/{}", srb2home, gamedatafilename),
+		[ng = std::move(ng), dirty]
+		{
+			srb2::io::VecStream stream;
+
+			// The header is necessary to validate during loading.
+			srb2::io::write(static_cast<uint32_t>(GD_VERSION_MAJOR), stream); // major
+			srb2::io::write(static_cast<uint8_t>(GD_VERSION_MINOR), stream); // minor/flags
+			srb2::io::write(dirty, stream); // dirty (crash recovery)
+
+			std::vector<uint8_t> ubjson = json::to_ubjson(ng);
+			srb2::io::write_exact(stream, tcb::as_bytes(tcb::make_span(ubjson)));
+			return std::move(stream.vector());
+		},
+		"NG Gamedata save failed",
+		false
+	);
 }
 
 // G_SaveGameData
 // Saves the main data file, which stores information such as emblems found, etc.
+// Only the snapshot is taken here; it's written in the background.
 void G_SaveGameData(void)
 {
+	G_UpdateSaves();
+
 	try
 	{
 		srb2::save_ng_gamedata();
@@ -342,10 +578,86 @@ void G_SaveGameData(void)
 
 	// Also save profiles here.
 	PR_SaveProfiles();
+}
+
+// G_FlushSaves
+// Waits for every queued gamedata and profile save to reach the disk.
+void G_FlushSaves(void)
+{
+	if (!g_savewriter)
+		return;
 
-	#ifdef DEVELOP
-		CONS_Alert(CONS_NOTICE, M_GetText("Gamedata saved.\n"));
-	#endif
+	g_savewriter->flush();
+	report_saves(g_savewriter->take_results());
+}
+
+// G_FinishSaves
+// G_FlushSaves for the crash handler. It won't wait forever or report
+// anything, and the snapshots it writes were taken before the crash.
+void G_FinishSaves(void)
+{
+	if (!g_savewriter)
+		return;
+
+	g_savewriter->finish(std::chrono::seconds(5));
+}
+
+// G_UpdateSaves
+// Reports the saves finished since the last call.
+void G_UpdateSaves(void)
+{
+	if (!g_savewriter)
+		return;
+
+	report_saves(g_savewriter->take_results());
+}
+
+// savebench [saves]
+// What G_SaveGameData costs the main thread now, against waiting for the
+// write like it used to.
+void Command_SaveBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	int saves = 10;
+	precise_t start, synctime, queuetime, flushtime;
+	uint32_t writes = 0;
+
+	if (gamedata == NULL || !gamedata->loaded || usedCheats)
+	{
+		CONS_Printf("Gamedata can't be saved right now.\n");
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		saves = std::max(1, atoi(COM_Argv(1)));
+
+	G_FlushSaves();
+
+	start = I_GetPreciseTime();
+	G_SaveGameData();
+	G_FlushSaves();
+	synctime = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (int i = 0; i < saves; i++)
+		G_SaveGameData();
+	queuetime = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	g_savewriter->flush();
+	flushtime = I_GetPreciseTime() - start;
+
+	std::vector<SaveResult> results = g_savewriter->take_results();
+	for (const SaveResult& result : results)
+		writes += result.error.empty();
+	report_saves(results);
+
+	CONS_Printf("Saving and waiting for it: %d us\n", static_cast<int>(synctime * 1000000 / precision));
+	CONS_Printf("%d saves: %d us on the main thread, %d us each\n", saves,
+		static_cast<int>(queuetime * 1000000 / precision),
+		static_cast<int>(queuetime * 1000000 / precision / saves));
+	CONS_Printf("Waiting for them afterward: %d us, %u files written\n",
+		static_cast<int>(flushtime * 1000000 / precision), writes);
 }
 
 static const char *G_GameDataFolder(void)
@@ -885,6 +1197,9 @@ void srb2::load_ng_gamedata()
 // Loads the main data file, which stores information such as emblems found, etc.
 void G_LoadGameData(void)
 {
+	// Don't read a file that's still being written
+	G_FlushSaves();
+
 	try
 	{
 		srb2::load_ng_gamedata();
@@ -14,7 +14,9 @@
 #ifdef __cplusplus
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -328,6 +330,12 @@ struct GamedataJson final
 void save_ng_gamedata(void);
 void load_ng_gamedata(void);
 
+// Writes what serialize returns to path on the save thread, by way of a temp
+// file. Until then, queueing the same path again replaces the snapshot, so a
+// burst of saves is written once. failure is shown if it can't be written,
+// through I_Error if fatal.
+void queue_save(std::string path, std::function<std::vector<std::byte>()> serialize, std::string failure, bool fatal);
+
 }
 
 extern "C"
@@ -337,6 +345,12 @@ extern "C"
 void G_SaveGameData(void);
 void G_LoadGameData(void);
 
+void G_FlushSaves(void);
+void G_FinishSaves(void);
+void G_UpdateSaves(void);
+
+void Command_SaveBench_f(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
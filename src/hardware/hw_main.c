@@ -4597,7 +4597,9 @@ static void HWR_AddPrecipitationSprites(void)
 	const fixed_t drawdist = cv_drawdist_precip.value * mapobjectscale;
 
 	INT32 xl, xh, yl, yh, bx, by;
+	precipcell_t *cell;
 	precipmobj_t *th;
+	UINT32 i;
 
 	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
 	if (drawdist == 0)
@@ -4611,10 +4613,17 @@ static void HWR_AddPrecipitationSprites(void)
 	{
 		for (by = yl; by <= yh; by++)
 		{
-			for (th = precipblocklinks[(by * bmapwidth) + bx]; th; th = th->bnext)
+			// okay... this is a hack, but weather isn't networked, so it should be ok
+			cell = &precipcells[(by * bmapwidth) + bx];
+			P_PrecipCellThinker(cell);
+
+			for (i = 0; i < cell->count; i++)
 			{
+				th = cell->mobjs[i];
+
 				if (R_PrecipThingVisible(th))
 				{
+					P_SyncPrecipMobj(th);
 					HWR_ProjectPrecipitationSprite(th);
 				}
 			}
@@ -5140,12 +5149,6 @@ static void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	// uncapped/interpolation
 	interpmobjstate_t interp = {0};
 
-	// okay... this is a hack, but weather isn't networked, so it should be ok
-	if (!P_PrecipThinker(thing))
-	{
-		return;
-	}
-
 	// do interpolation
 	if (R_UsingFrameInterpolation() && !paused)
 	{
@@ -13,6 +13,13 @@
 ///        This is not really OS-dependent because all OSes have the same socket API.
 ///        Just use ifdef for OS-dependent parts.
 
+#if defined (__linux__) && !defined (NOMMSG)
+	#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE // recvmmsg, sendmmsg
+	#endif
+	#define USE_MMSG
+#endif
+
 #include "i_tcp_detail.h"
 #include "i_system.h"
 #include "i_time.h"
@@ -34,6 +41,10 @@
 
 #include "i_addrinfo.h"
 
+#ifdef USE_MMSG
+	#include <sys/epoll.h>
+#endif
+
 #define SELECTTEST
 
 #define DEFAULTPORT "5029"
@@ -77,6 +88,33 @@ static const INT32 hole_punch_magic = MSBF_LONG (0x52eb11);
 static bannednode_t SOCK_bannednode[MAXNETNODES+1]; /// \note do we really need the +1?
 static boolean init_tcp_driver = false;
 
+#ifdef USE_MMSG
+/// \brief Most datagrams moved by a single recvmmsg/sendmmsg call
+#define SOCKBATCH 64
+
+typedef struct
+{
+	char data[MAXPACKETLENGTH];
+	mysockaddr_t address;
+	socklen_t addresslen;
+	SOCKET_TYPE socket;
+	INT16 length;
+	INT16 node; // -1 if a failed send should not be reported
+} sockpacket_t;
+
+static boolean sockbatch = false; // false falls back to one recvfrom/sendto per packet
+static int sockepoll = -1;
+static boolean sendblocked = false; // the last flush hit EWOULDBLOCK
+
+static sockpacket_t recvqueue[SOCKBATCH];
+static size_t recvhead = 0, recvcount = 0;
+static sockpacket_t sendqueue[SOCKBATCH];
+static size_t sendcount = 0;
+
+static struct mmsghdr mmsgs[SOCKBATCH];
+static struct iovec mmsgiov[SOCKBATCH];
+#endif
+
 static const char *serverport_name = DEFAULTPORT;
 static const char *clientport_name;/* any port */
 
@@ -408,6 +446,7 @@ static boolean hole_punch(ssize_t c)
 		addr.ip4.sin_addr.s_addr = holepunchpacket->addr;
 		addr.ip4.sin_port        = holepunchpacket->port;
 		sendto(mysockets[0], NULL, 0, 0, &addr.any, sizeof addr.ip4);
+		netsyscalls++;
 
 		CONS_Debug(DBG_NETPLAY,
 				"hole punching request from %s\n", SOCK_AddrToStr(&addr));
@@ -420,62 +459,320 @@ static boolean hole_punch(ssize_t c)
 	}
 }
 
+// Works out which node sent the packet currently in doomcom
+// Returns 1 if it came from a new node, 0 if from a known one, -1 if it should be discarded
+static INT32 SOCK_IdentifyPacket(SOCKET_TYPE socket, mysockaddr_t *fromaddress, socklen_t fromlen, ssize_t c)
+{
+	INT32 j;
+
+#ifdef USE_STUN
+	if (STUN_got_response(doomcom->data, c))
+	{
+		return -1;
+	}
+#endif
+
+	if (hole_punch(c))
+	{
+		return -1;
+	}
+
+	// find remote node number
+	for (j = 1; j <= MAXNETNODES; j++) //include LAN
+	{
+		if (SOCK_cmpaddr(fromaddress, &clientaddress[j], 0))
+		{
+			doomcom->remotenode = (INT16)j; // good packet from a game player
+			doomcom->datalength = (INT16)c;
+			nodesocket[j] = socket;
+			return 0;
+		}
+	}
+	// not found
+
+	// find a free slot
+	j = getfreenode();
+	if (j > 0)
+	{
+		M_Memcpy(&clientaddress[j], fromaddress, fromlen);
+		nodesocket[j] = socket;
+		DEBFILE(va("New node detected: node:%d address:%s\n", j,
+				SOCK_GetNodeAddress(j)));
+		doomcom->remotenode = (INT16)j; // good packet from a game player
+		doomcom->datalength = (INT16)c;
+
+		return 1;
+	}
+
+	DEBFILE("New node detected: No more free slots\n");
+	return -1;
+}
+
+static inline socklen_t SOCK_AddrLen(const mysockaddr_t *sockaddr)
+{
+	switch (sockaddr->any.sa_family)
+	{
+		case AF_INET:  return (socklen_t)sizeof(struct sockaddr_in);
+#ifdef HAVE_IPV6
+		case AF_INET6: return (socklen_t)sizeof(struct sockaddr_in6);
+#endif
+		default:       return (socklen_t)sizeof(mysockaddr_t);
+	}
+}
+
+#ifdef USE_MMSG
+// Sets ready[n] for every socket with one of the requested epoll events pending
+static boolean SOCK_PollSockets(UINT32 mask, boolean *ready)
+{
+	struct epoll_event ev[MAXNETNODES+1];
+	boolean any = false;
+	int i, n;
+
+	n = epoll_wait(sockepoll, ev, MAXNETNODES+1, 0);
+	netsyscalls++;
+
+	for (i = 0; i < n; i++)
+	{
+		if (!(ev[i].events & mask))
+			continue;
+
+		any = true;
+		if (ready)
+			ready[ev[i].data.u32] = true;
+	}
+
+	return any;
+}
+
+// Sends everything queued by SOCK_Send. sendmmsg only takes one socket,
+// so consecutive packets for the same socket go out together.
+static void SOCK_FlushSend(boolean reporterrors)
+{
+	size_t i = 0, k;
+
+	sendblocked = false;
+
+	while (i < sendcount)
+	{
+		const SOCKET_TYPE socket = sendqueue[i].socket;
+		size_t run = 1;
+		int sent;
+
+		while (i + run < sendcount && sendqueue[i + run].socket == socket)
+			run++;
+
+		for (k = 0; k < run; k++)
+		{
+			sockpacket_t *p = &sendqueue[i + k];
+			mmsgiov[k].iov_base = p->data;
+			mmsgiov[k].iov_len = p->length;
+			memset(&mmsgs[k], 0, sizeof (mmsgs[k]));
+			mmsgs[k].msg_hdr.msg_name = &p->address;
+			mmsgs[k].msg_hdr.msg_namelen = p->addresslen;
+			mmsgs[k].msg_hdr.msg_iov = &mmsgiov[k];
+			mmsgs[k].msg_hdr.msg_iovlen = 1;
+		}
+
+		sent = sendmmsg(socket, mmsgs, (unsigned int)run, MSG_DONTWAIT);
+		netsyscalls++;
+
+		if (sent > 0)
+		{
+			i += sent;
+			continue;
+		}
+
+		// The first packet of the run failed, skip it like sendto would drop it
+		{
+			int e = errno; // save error code so it can't be modified later
+			const INT16 node = sendqueue[i].node;
+
+			if (e == EWOULDBLOCK)
+				sendblocked = true;
+			else if (reporterrors && node >= 0 && e != ECONNREFUSED)
+				I_Error("SOCK_Send, error sending to node %d (%s) #%u: %s", node,
+					SOCK_GetNodeAddress(node), e, strerror(e));
+		}
+		i++;
+	}
+
+	sendcount = 0;
+}
+
+static void SOCK_QueueSend(SOCKET_TYPE socket, mysockaddr_t *sockaddr, INT16 node)
+{
+	sockpacket_t *p;
+
+	if (sendcount == SOCKBATCH)
+		SOCK_FlushSend(true);
+
+	p = &sendqueue[sendcount++];
+	M_Memcpy(p->data, doomcom->data, doomcom->datalength);
+	p->length = doomcom->datalength;
+	p->address = *sockaddr;
+	p->addresslen = SOCK_AddrLen(sockaddr);
+	p->socket = socket;
+	p->node = node;
+}
+
+// Pulls every waiting datagram, up to SOCKBATCH, with one recvmmsg per socket
+static boolean SOCK_FillRecvQueue(void)
+{
+	boolean ready[MAXNETNODES+1];
+	size_t n, i;
+
+	// Anything we were about to send should leave before we look for replies
+	SOCK_FlushSend(true);
+
+	recvhead = recvcount = 0;
+
+	if (sockepoll != -1 && mysocketses > 1)
+	{
+		// With several sockets bound, only read the ones that have something
+		memset(ready, 0, sizeof ready);
+		if (!SOCK_PollSockets(EPOLLIN, ready))
+			return false;
+	}
+	else
+	{
+		for (n = 0; n < mysocketses; n++)
+			ready[n] = true;
+	}
+
+	for (n = 0; n < mysocketses && recvcount < SOCKBATCH; n++)
+	{
+		const size_t room = SOCKBATCH - recvcount;
+		int got;
+
+		if (!ready[n])
+			continue;
+
+		for (i = 0; i < room; i++)
+		{
+			sockpacket_t *p = &recvqueue[recvcount + i];
+			mmsgiov[i].iov_base = p->data;
+			mmsgiov[i].iov_len = MAXPACKETLENGTH;
+			memset(&mmsgs[i], 0, sizeof (mmsgs[i]));
+			mmsgs[i].msg_hdr.msg_name = &p->address;
+			mmsgs[i].msg_hdr.msg_namelen = (socklen_t)sizeof (p->address);
+			mmsgs[i].msg_hdr.msg_iov = &mmsgiov[i];
+			mmsgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		got = recvmmsg(mysockets[n], mmsgs, (unsigned int)room, MSG_DONTWAIT, NULL);
+		netsyscalls++;
+
+		if (got <= 0)
+			continue;
+
+		for (i = 0; i < (size_t)got; i++)
+		{
+			sockpacket_t *p = &recvqueue[recvcount + i];
+			p->length = (INT16)mmsgs[i].msg_len;
+			p->addresslen = mmsgs[i].msg_hdr.msg_namelen;
+			p->socket = mysockets[n];
+		}
+
+		recvcount += got;
+	}
+
+	return (recvcount > 0);
+}
+
+static boolean SOCK_GetBatched(void)
+{
+	while (recvhead < recvcount || SOCK_FillRecvQueue())
+	{
+		sockpacket_t *p = &recvqueue[recvhead++];
+		INT32 res;
+
+		if (p->length <= 0)
+			continue;
+
+		M_Memcpy(doomcom->data, p->data, p->length);
+
+		res = SOCK_IdentifyPacket(p->socket, &p->address, p->addresslen, p->length);
+		if (res >= 0)
+			return (res == 1);
+	}
+
+	doomcom->remotenode = -1; // no packet
+	return false;
+}
+
+static void SOCK_InitBatch(void)
+{
+	size_t n;
+
+	recvhead = recvcount = sendcount = 0;
+	sendblocked = false;
+
+	sockbatch = !M_CheckParm("-noudpbatch");
+	if (!sockbatch)
+		return;
+
+	sockepoll = epoll_create1(EPOLL_CLOEXEC);
+	if (sockepoll == -1)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Could not create epoll instance, using select\n"));
+		return;
+	}
+
+	for (n = 0; n < mysocketses; n++)
+	{
+		struct epoll_event ev;
+		ev.events = EPOLLIN|EPOLLOUT;
+		ev.data.u32 = (UINT32)n;
+		if (epoll_ctl(sockepoll, EPOLL_CTL_ADD, mysockets[n], &ev) == -1)
+		{
+			CONS_Alert(CONS_WARNING, M_GetText("Could not watch socket with epoll, using select\n"));
+			close(sockepoll);
+			sockepoll = -1;
+			return;
+		}
+	}
+}
+
+static void SOCK_ShutdownBatch(void)
+{
+	if (sockbatch)
+		SOCK_FlushSend(false);
+
+	recvhead = recvcount = sendcount = 0;
+	sockbatch = false;
+
+	if (sockepoll != -1)
+	{
+		close(sockepoll);
+		sockepoll = -1;
+	}
+}
+#endif
+
 // Returns true if a packet was received from a new node, false in all other cases
 static boolean SOCK_Get(void)
 {
 	size_t n;
-	int j;
 	ssize_t c;
 	mysockaddr_t fromaddress;
 	socklen_t fromlen;
 
+#ifdef USE_MMSG
+	if (sockbatch)
+		return SOCK_GetBatched();
+#endif
+
 	for (n = 0; n < mysocketses; n++)
 	{
 		fromlen = (socklen_t)sizeof(fromaddress);
 		c = recvfrom(mysockets[n], (char *)&doomcom->data, MAXPACKETLENGTH, 0,
 			(void *)&fromaddress, &fromlen);
+		netsyscalls++;
 		if (c > 0)
 		{
-#ifdef USE_STUN
-			if (STUN_got_response(doomcom->data, c))
-			{
-				break;
-			}
-#endif
-
-			if (hole_punch(c))
-			{
-				break;
-			}
-
-			// find remote node number
-			for (j = 1; j <= MAXNETNODES; j++) //include LAN
-			{
-				if (SOCK_cmpaddr(&fromaddress, &clientaddress[j], 0))
-				{
-					doomcom->remotenode = (INT16)j; // good packet from a game player
-					doomcom->datalength = (INT16)c;
-					nodesocket[j] = mysockets[n];
-					return false;
-				}
-			}
-			// not found
-
-			// find a free slot
-			j = getfreenode();
-			if (j > 0)
-			{
-				M_Memcpy(&clientaddress[j], &fromaddress, fromlen);
-				nodesocket[j] = mysockets[n];
-				DEBFILE(va("New node detected: node:%d address:%s\n", j,
-						SOCK_GetNodeAddress(j)));
-				doomcom->remotenode = (INT16)j; // good packet from a game player
-				doomcom->datalength = (INT16)c;
-
-				return true;
-			}
-			else
-				DEBFILE("New node detected: No more free slots\n");
+			const INT32 res = SOCK_IdentifyPacket(mysockets[n], &fromaddress, fromlen, c);
+			if (res >= 0)
+				return (res == 1);
 		}
 	}
 
@@ -511,11 +808,33 @@ static boolean SOCK_CanSend(void)
 	fd_set tset;
 	int wselect;
 
+#ifdef USE_MMSG
+	if (sockbatch)
+	{
+		// Packets are only queued here, so just make sure
+		// the kernel drained whatever blocked the last flush
+		if (!sendblocked)
+			return true;
+
+		if (sockepoll != -1)
+		{
+			sendblocked = !SOCK_PollSockets(EPOLLOUT, NULL);
+			return !sendblocked;
+		}
+	}
+#endif
+
 	if(!FD_CPY(&masterset, &tset, mysockets, mysocketses))
 		return false;
 	wselect = select(255, NULL, &tset, NULL, &timeval_for_select);
+	netsyscalls++;
 	if (wselect >= 1)
+	{
+#ifdef USE_MMSG
+		sendblocked = false;
+#endif
 		return true;
+	}
 	return false;
 }
 
@@ -525,38 +844,53 @@ static boolean SOCK_CanGet(void)
 	fd_set tset;
 	int rselect;
 
+#ifdef USE_MMSG
+	if (sockbatch)
+	{
+		if (recvhead < recvcount)
+			return true;
+
+		if (sockepoll != -1)
+			return SOCK_PollSockets(EPOLLIN, NULL);
+	}
+#endif
+
 	if(!FD_CPY(&masterset, &tset, mysockets, mysocketses))
 		return false;
 	rselect = select(255, &tset, NULL, NULL, &timeval_for_select);
+	netsyscalls++;
 	if (rselect >= 1)
 		return true;
 	return false;
 }
 #endif
 
-static inline ssize_t SOCK_SendToAddr(SOCKET_TYPE socket, mysockaddr_t *sockaddr)
+static void SOCK_SendToAddr(SOCKET_TYPE socket, mysockaddr_t *sockaddr, INT16 node)
 {
-	socklen_t d4 = (socklen_t)sizeof(struct sockaddr_in);
-#ifdef HAVE_IPV6
-	socklen_t d6 = (socklen_t)sizeof(struct sockaddr_in6);
-#endif
-	socklen_t d, da = (socklen_t)sizeof(mysockaddr_t);
+	ssize_t c;
 
-	switch (sockaddr->any.sa_family)
+#ifdef USE_MMSG
+	if (sockbatch)
 	{
-		case AF_INET:  d = d4; break;
-#ifdef HAVE_IPV6
-		case AF_INET6: d = d6; break;
-#endif
-		default:       d = da; break;
+		SOCK_QueueSend(socket, sockaddr, node);
+		return;
 	}
+#endif
+
+	c = sendto(socket, (char *)&doomcom->data, doomcom->datalength, 0, &sockaddr->any, SOCK_AddrLen(sockaddr));
+	netsyscalls++;
 
-	return sendto(socket, (char *)&doomcom->data, doomcom->datalength, 0, &sockaddr->any, d);
+	if (c == ERRSOCKET && node >= 0)
+	{
+		int e = errno; // save error code so it can't be modified later
+		if (e != ECONNREFUSED && e != EWOULDBLOCK)
+			I_Error("SOCK_Send, error sending to node %d (%s) #%u: %s", node,
+				SOCK_GetNodeAddress(node), e, strerror(e));
+	}
 }
 
 static void SOCK_Send(void)
 {
-	ssize_t c = ERRSOCKET;
 	size_t i, j;
 
 	if (!nodeconnected[doomcom->remotenode])
@@ -569,33 +903,31 @@ static void SOCK_Send(void)
 			for (j = 0; j < broadcastaddresses; j++)
 			{
 				if (myfamily[i] == broadcastaddress[j].any.sa_family)
-					SOCK_SendToAddr(mysockets[i], &broadcastaddress[j]);
+					SOCK_SendToAddr(mysockets[i], &broadcastaddress[j], -1);
 			}
 		}
-		return;
 	}
 	else if (nodesocket[doomcom->remotenode] == (SOCKET_TYPE)ERRSOCKET)
 	{
 		for (i = 0; i < mysocketses; i++)
 		{
 			if (myfamily[i] == clientaddress[doomcom->remotenode].any.sa_family)
-				SOCK_SendToAddr(mysockets[i], &clientaddress[doomcom->remotenode]);
+				SOCK_SendToAddr(mysockets[i], &clientaddress[doomcom->remotenode], -1);
 		}
-		return;
 	}
 	else
 	{
-		c = SOCK_SendToAddr(nodesocket[doomcom->remotenode], &clientaddress[doomcom->remotenode]);
+		SOCK_SendToAddr(nodesocket[doomcom->remotenode], &clientaddress[doomcom->remotenode], doomcom->remotenode);
 	}
+}
 
-	if (c == ERRSOCKET)
-	{
-		int e = errno; // save error code so it can't be modified later
-		if (e != ECONNREFUSED && e != EWOULDBLOCK)
-			I_Error("SOCK_Send, error sending to node %d (%s) #%u: %s", doomcom->remotenode,
-				SOCK_GetNodeAddress(doomcom->remotenode), e, strerror(e));
-	}
+#ifdef USE_MMSG
+static void SOCK_Flush(void)
+{
+	if (sockbatch)
+		SOCK_FlushSend(true);
 }
+#endif
 
 static void SOCK_FreeNodenum(INT32 numnode)
 {
@@ -862,6 +1194,10 @@ static boolean UDP_Socket(void)
 	if (s == 0) // no sockets?
 		return false;
 
+#ifdef USE_MMSG
+	SOCK_InitBatch();
+#endif
+
 	s = 0;
 
 	// ip + udp
@@ -1009,6 +1345,11 @@ boolean I_InitTcpDriver(void)
 static void SOCK_CloseSocket(void)
 {
 	size_t i;
+
+#ifdef USE_MMSG
+	SOCK_ShutdownBatch();
+#endif
+
 	for (i=0; i < MAXNETNODES+1; i++)
 	{
 		if (mysockets[i] != (SOCKET_TYPE)ERRSOCKET
@@ -1168,6 +1509,9 @@ static boolean SOCK_OpenSocket(void)
 	I_NetCanSend = SOCK_CanSend;
 	I_NetCanGet = SOCK_CanGet;
 #endif
+#ifdef USE_MMSG
+	I_NetFlush = SOCK_Flush;
+#endif
 
 	I_NetRequestHolePunch = SOCK_RequestHolePunch;
 	I_NetRegisterHolePunch = SOCK_RegisterHolePunch;
@@ -15,7 +15,7 @@
 #include <vector>
 
 #include <imgui.h>
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "command.h"
 #include "cxxutil.hpp"
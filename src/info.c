@@ -23,6 +23,7 @@
 #include "d_player.h"
 #include "v_video.h" // V_*MAP constants
 #include "lzf.h"
+#include "deh_symbols.h" // DEH_InvalidateSprites
 
 // Hey, moron! If you change this table, don't forget about the sprite enum in info.h and the sprite lights in hw_light.c!
 // EXCEPT HW_LIGHT.C DOESN'T EXIST ANYMORE LOVE CONTINUOUSLY FALLING ON MY ASS THROUGHOUT THIS CODEBASE - Tyron 2022-05-12
@@ -22287,6 +22288,7 @@ void P_PatchInfoTables(void)
 		tempname[4] = '\0';
 	}
 	sprnames[i][0] = '\0'; // i == NUMSPRITES
+	DEH_InvalidateSprites();
 	memset(&states[S_FIRSTFREESLOT], 0, sizeof (state_t) * NUMSTATEFREESLOTS);
 	memset(&mobjinfo[MT_FIRSTFREESLOT], 0, sizeof (mobjinfo_t) * NUMMOBJFREESLOTS);
 	memset(&skincolors[SKINCOLOR_FIRSTFREESLOT], 0, sizeof (skincolor_t) * NUMCOLORFREESLOTS);
@@ -12,7 +12,7 @@
 
 #include <algorithm>
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "doomdef.h"
 #include "d_player.h"
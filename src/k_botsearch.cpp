@@ -12,7 +12,7 @@
 
 #include <algorithm>
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "doomdef.h"
 #include "d_player.h"
@@ -96,28 +96,21 @@ UINT8 K_EggboxStealth(fixed_t x, fixed_t y)
 {
 	ZoneScoped;
 
-	INT32 xl, xh, yl, yh, bx, by;
-
 	g_eggboxSearch.eggboxx = x;
 	g_eggboxSearch.eggboxy = y;
 	g_eggboxSearch.distancetocheck = (mapobjectscale * 256);
 	g_eggboxSearch.randomitems = 0;
 	g_eggboxSearch.eggboxes = 0;
 
-	xl = (unsigned)(g_eggboxSearch.eggboxx - g_eggboxSearch.distancetocheck - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(g_eggboxSearch.eggboxx + g_eggboxSearch.distancetocheck - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(g_eggboxSearch.eggboxy - g_eggboxSearch.distancetocheck - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(g_eggboxSearch.eggboxy + g_eggboxSearch.distancetocheck - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
-
-	for (bx = xl; bx <= xh; bx++)
-	{
-		for (by = yl; by <= yh; by++)
-		{
-			P_BlockThingsIterator(bx, by, K_FindEggboxes);
-		}
-	}
+	// Bots think between tics, so the blockmap snapshot is up to date.
+	P_BlockSnapshotBox(
+		g_eggboxSearch.eggboxx - g_eggboxSearch.distancetocheck,
+		g_eggboxSearch.eggboxy - g_eggboxSearch.distancetocheck,
+		g_eggboxSearch.eggboxx + g_eggboxSearch.distancetocheck,
+		g_eggboxSearch.eggboxy + g_eggboxSearch.distancetocheck,
+		[](const blocksnapthing_t *snap, void *) { return K_FindEggboxes(snap->mobj); },
+		nullptr
+	);
 
 	return (g_eggboxSearch.randomitems * (g_eggboxSearch.eggboxes + 1));
 }
@@ -398,7 +391,7 @@ static boolean K_PlayerAttackSteer(mobj_t *thing, UINT8 side, UINT8 weight, bool
 --------------------------------------------------*/
 static BlockItReturn_t K_FindObjectsForNudging(mobj_t *thing)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	INT16 angledelta, anglediff;
 	angle_t destangle, angle;
@@ -687,8 +680,6 @@ void K_NudgePredictionTowardsObjects(botprediction_t *predict, const player_t *p
 
 	const precise_t time = I_GetPreciseTime();
 
-	INT32 xl, xh, yl, yh, bx, by;
-
 	fixed_t distToPredict = 0;
 	fixed_t radToPredict = 0;
 	angle_t angleToPredict = 0;
@@ -735,20 +726,14 @@ void K_NudgePredictionTowardsObjects(botprediction_t *predict, const player_t *p
 		g_nudgeSearch.avoidObjs[i] = 0;
 	}
 
-	xl = (unsigned)(avgX - (radToPredict + MAXRADIUS) - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(avgX + (radToPredict + MAXRADIUS) - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(avgY - (radToPredict + MAXRADIUS) - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(avgY + (radToPredict + MAXRADIUS) - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
-
-	for (bx = xl; bx <= xh; bx++)
-	{
-		for (by = yl; by <= yh; by++)
-		{
-			P_BlockThingsIterator(bx, by, K_FindObjectsForNudging);
-		}
-	}
+	P_BlockSnapshotBox(
+		avgX - (radToPredict + MAXRADIUS),
+		avgY - (radToPredict + MAXRADIUS),
+		avgX + (radToPredict + MAXRADIUS),
+		avgY + (radToPredict + MAXRADIUS),
+		[](const blocksnapthing_t *snap, void *) { return K_FindObjectsForNudging(snap->mobj); },
+		nullptr
+	);
 
 	// Handle dodge characters
 	if (g_nudgeSearch.avoidObjs[1] > 0 || g_nudgeSearch.avoidObjs[0] > 0)
@@ -971,8 +956,6 @@ INT32 K_PositionBully(const player_t *player)
 {
 	ZoneScoped;
 
-	INT32 xl, xh, yl, yh, bx, by;
-
 	angle_t ourangle, destangle, angle;
 	INT16 anglediff;
 
@@ -982,20 +965,14 @@ INT32 K_PositionBully(const player_t *player)
 	g_bullySearch.annoymo = NULL;
 	g_bullySearch.annoyscore = 0;
 
-	xl = (unsigned)(g_bullySearch.botmo->x - g_bullySearch.distancetocheck - bmaporgx)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(g_bullySearch.botmo->x + g_bullySearch.distancetocheck - bmaporgx)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(g_bullySearch.botmo->y - g_bullySearch.distancetocheck - bmaporgy)>>MAPBLOCKSHIFT;
-	yh = (unsigned)(g_bullySearch.botmo->y + g_bullySearch.distancetocheck - bmaporgy)>>MAPBLOCKSHIFT;
-
-	BMBOUNDFIX(xl, xh, yl, yh);
-
-	for (bx = xl; bx <= xh; bx++)
-	{
-		for (by = yl; by <= yh; by++)
-		{
-			P_BlockThingsIterator(bx, by, K_FindPlayersToBully);
-		}
-	}
+	P_BlockSnapshotBox(
+		g_bullySearch.botmo->x - g_bullySearch.distancetocheck,
+		g_bullySearch.botmo->y - g_bullySearch.distancetocheck,
+		g_bullySearch.botmo->x + g_bullySearch.distancetocheck,
+		g_bullySearch.botmo->y + g_bullySearch.distancetocheck,
+		[](const blocksnapthing_t *snap, void *) { return K_FindPlayersToBully(snap->mobj); },
+		nullptr
+	);
 
 	if (g_bullySearch.annoymo == NULL)
 	{
@@ -439,7 +439,7 @@ boolean K_LandMineCollide(mobj_t *t1, mobj_t *t2)
 			&& t2->player != t1->target->player)
 			{
 				t1->target->player->roundconditions.landmine_dunk = true;
-				t1->target->player->roundconditions.checkthisframe = true;
+				t1->target->player->roundconditions.checkthisframe |= UCD_LANDMINEDUNK;
 			}
 
 			S_StartSound(t2, sfx_bsnipe);
@@ -992,7 +992,7 @@ boolean K_InstaWhipCollide(mobj_t *shield, mobj_t *victim)
 				&& attackerPlayer->hyudorotimer > 0)
 			{
 				attackerPlayer->roundconditions.whip_hyuu = true;
-				attackerPlayer->roundconditions.checkthisframe = true;
+				attackerPlayer->roundconditions.checkthisframe |= UCD_HYUU;
 			}
 
 			return true;
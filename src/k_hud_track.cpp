@@ -8,6 +8,7 @@
 //-----------------------------------------------------------------------------
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <cstddef>
 #include <optional>
@@ -97,6 +98,7 @@ struct TargetTracking
 	trackingResult_t result;
 	fixed_t camDist;
 	bool foreground;
+	bool sighted; // P_CheckSight from this view's player, updated once per tic
 	playertagtype_t nametag;
 	std::optional<Tooltip> tooltip;
 
@@ -243,7 +245,7 @@ struct TargetTracking
 			return false;
 		}
 
-		if (!P_CheckSight(stplyr->mo, const_cast<mobj_t*>(mobj)))
+		if (!sighted)
 		{
 			// Can't see
 			return false;
@@ -447,21 +449,31 @@ std::optional<TargetTracking::Tooltip> object_tooltip(const mobj_t* mobj)
 	}
 }
 
-Visibility is_object_visible(const mobj_t* mobj)
+bool object_flickers(const mobj_t* mobj)
 {
 	switch (mobj->type)
 	{
 	case MT_SPRAYCAN:
 	case MT_SUPER_FLICKY:
-		// Always flickers.
-		return Visibility::kFlicker;
+		return true;
 
 	default:
-		// Transparent when not visible.
-		return P_CheckSight(stplyr->mo, const_cast<mobj_t*>(mobj)) ? Visibility::kVisible : Visibility::kTransparent;
+		return false;
 	}
 }
 
+Visibility is_object_visible(const TargetTracking& target)
+{
+	if (object_flickers(target.mobj))
+	{
+		// Always flickers.
+		return Visibility::kFlicker;
+	}
+
+	// Transparent when not visible.
+	return target.sighted ? Visibility::kVisible : Visibility::kTransparent;
+}
+
 void K_DrawTargetTracking(const TargetTracking& target)
 {
 	if (target.nametag != PLAYERTAG_NONE)
@@ -496,7 +508,7 @@ void K_DrawTargetTracking(const TargetTracking& target)
 		return;
 	}
 
-	Visibility visibility = is_object_visible(target.mobj);
+	Visibility visibility = is_object_visible(target);
 
 	if (visibility == Visibility::kFlicker && (leveltime & 1))
 	{
@@ -799,11 +811,43 @@ void K_CullTargetList(std::vector<TargetTracking>& targetList)
 	);
 }
 
-}; // namespace
+// Everything about a tracked object that only changes when the game ticks.
+struct TrackedObject
+{
+	mobj_t* mobj;
+	bool tracking;
+	bool sighted;
+	playertagtype_t nametag;
+	std::optional<TargetTracking::Tooltip> tooltip;
+};
 
-void K_drawTargetHUD(const vector3_t* origin, player_t* player)
+// Walking trackercap, building tooltips and especially the sight checks are
+// too expensive to repeat on every rendered frame, so each view keeps the
+// results from its last tic and only projects them on interpolated frames.
+struct TrackedObjectCache
 {
-	std::vector<TargetTracking> targetList;
+	bool valid = false;
+	tic_t tic;
+	UINT32 era;
+	const player_t* player;
+	std::vector<TrackedObject> objects;
+
+	bool stale(const player_t* viewer) const
+	{
+		// thinker_era changes whenever every mobj is thrown away at once
+		return !valid || tic != gametic || era != thinker_era || player != viewer;
+	}
+};
+
+std::array<TrackedObjectCache, MAXSPLITSCREENPLAYERS> g_trackedObjects;
+
+void K_UpdateTrackedObjects(TrackedObjectCache& cache)
+{
+	cache.valid = true;
+	cache.tic = gametic;
+	cache.era = thinker_era;
+	cache.player = stplyr;
+	cache.objects.clear();
 
 	mobj_t* mobj = nullptr;
 	mobj_t* next = nullptr;
@@ -826,6 +870,48 @@ void K_drawTargetHUD(const vector3_t* origin, player_t* player)
 			continue;
 		}
 
+		if (tooltip)
+		{
+			if (auto* text = std::get_if<srb2::Draw::TextElement>(&tooltip->var))
+			{
+				text->flags(text->flags().value_or(0) | V_SPLITSCREEN);
+			}
+		}
+
+		// Only pay for a sight check if something is going to use it.
+		bool sighted = false;
+
+		if ((tracking && !object_flickers(mobj)) || (nametag != PLAYERTAG_NONE && !mobj->player->spectator))
+		{
+			sighted = P_CheckSight(stplyr->mo, mobj);
+		}
+
+		cache.objects.push_back({mobj, tracking, sighted, nametag, std::move(tooltip)});
+	}
+}
+
+}; // namespace
+
+void K_drawTargetHUD(const vector3_t* origin, player_t* player)
+{
+	std::vector<TargetTracking> targetList;
+
+	TrackedObjectCache& cache = g_trackedObjects[R_GetViewNumber()];
+
+	if (cache.stale(stplyr))
+	{
+		K_UpdateTrackedObjects(cache);
+	}
+
+	targetList.reserve(cache.objects.size());
+
+	for (const TrackedObject& tracked : cache.objects)
+	{
+		mobj_t* mobj = tracked.mobj;
+		bool tracking = tracked.tracking;
+		playertagtype_t nametag = tracked.nametag;
+		const auto& tooltip = tracked.tooltip;
+
 		vector3_t pos = {
 			R_InterpolateFixed(mobj->old_x, mobj->x) + mobj->sprxoff,
 			R_InterpolateFixed(mobj->old_y, mobj->y) + mobj->spryoff,
@@ -837,6 +923,7 @@ void K_drawTargetHUD(const vector3_t* origin, player_t* player)
 		tr.mobj = mobj;
 		tr.camDist = R_PointToDist2(origin->x, origin->y, pos.x, pos.y);
 		tr.foreground = false;
+		tr.sighted = tracked.sighted;
 		tr.nametag = PLAYERTAG_NONE;
 
 		if (tracking)
@@ -847,11 +934,6 @@ void K_drawTargetHUD(const vector3_t* origin, player_t* player)
 
 		if (tooltip)
 		{
-			if (auto* text = std::get_if<srb2::Draw::TextElement>(&tooltip->var))
-			{
-				text->flags(text->flags().value_or(0) | V_SPLITSCREEN);
-			}
-
 			const vector3_t copy = pos;
 			FV3_Add(&pos, &tooltip->ofs);
 			K_ObjectTracking(&tr.result, &pos, false);
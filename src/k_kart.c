@@ -1269,7 +1269,7 @@ static void K_UpdateOffroad(player_t *player)
 			&& player->offroad > (2*offroadstrength) / TICRATE)
 		{
 			player->roundconditions.touched_offroad = true;
-			player->roundconditions.checkthisframe = true;
+			player->roundconditions.checkthisframe |= UCD_OFFROAD;
 		}
 	}
 	else
@@ -4903,7 +4903,7 @@ void K_ApplyTripWire(player_t *player, tripwirestate_t state)
 			&& player->hyudorotimer > 0)
 		{
 			player->roundconditions.tripwire_hyuu = true;
-			player->roundconditions.checkthisframe = true;
+			player->roundconditions.checkthisframe |= UCD_HYUU;
 		}
 
 		if (player->tripwirePass == TRIPWIRE_CONSUME && player->tripwireLeniency == 0)
@@ -6691,7 +6691,7 @@ void K_DoSneaker(player_t *player, INT32 type)
 		&& player->floorboost != 0)
 	{
 		player->roundconditions.touched_sneakerpanel = true;
-		player->roundconditions.checkthisframe = true;
+		player->roundconditions.checkthisframe |= UCD_SNEAKERPANEL;
 	}
 
 	if (player->floorboost == 0 || player->floorboost == 3)
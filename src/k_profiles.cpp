@@ -17,6 +17,7 @@
 #include <fmt/format.h>
 
 #include "io/streams.hpp"
+#include "g_gamedata.h" // queue_save
 #include "doomtype.h"
 #include "d_main.h" // pandf
 #include "byteptr.h" // READ/WRITE macros
@@ -250,7 +251,6 @@ void PR_InitNewProfile(void)
 
 void PR_SaveProfiles(void)
 {
-	namespace fs = std::filesystem;
 	using json = nlohmann::json;
 	using namespace srb2;
 	namespace io = srb2::io;
@@ -316,35 +316,26 @@ void PR_SaveProfiles(void)
 		ng.profiles.emplace_back(std::move(jsonprof));
 	}
 
-	std::vector<uint8_t> ubjson = json::to_ubjson(ng);
-
-	std::string realpath = fmt::format("{}/{}", srb2home, PROFILESFILE);
-	int random_number = rand();
-	std::string tmppath = fmt::format("{}_{}.tmp", realpath, random_number);
-
-	try
-	{
-		io::FileStream file {tmppath, io::FileStreamMode::kWrite};
-
-		io::write(static_cast<uint32_t>(0x52494E47), file, io::Endian::kBE); // "RING"
-		io::write(static_cast<uint32_t>(0x5052464C), file, io::Endian::kBE); // "PRFL"
-		io::write(static_cast<uint8_t>(0), file); // reserved1
-		io::write(static_cast<uint8_t>(0), file); // reserved2
-		io::write(static_cast<uint8_t>(0), file); // reserved3
-		io::write(static_cast<uint8_t>(0), file); // reserved4
-		io::write_exact(file, tcb::as_bytes(tcb::make_span(ubjson)));
-		file.close();
-
-		fs::rename(tmppath, realpath);
-	}
-	catch (const std::exception& ex)
-	{
-		I_Error("Couldn't save profiles. Are you out of Disk space / playing in a protected folder?\n\nException: %s", ex.what());
-	}
-	catch (...)
-	{
-		I_Error("Couldn't save profiles. Are you out of Disk space / playing in a protected folder?");
-	}
+	queue_save(
+		fmt::format("{}/{}", srb2home, PROFILESFILE),
+		[ng = std::move(ng)]
+		{
+			io::VecStream stream;
+
+			io::write(static_cast<uint32_t>(0x52494E47), stream, io::Endian::kBE); // "RING"
+			io::write(static_cast<uint32_t>(0x5052464C), stream, io::Endian::kBE); // "PRFL"
+			io::write(static_cast<uint8_t>(0), stream); // reserved1
+			io::write(static_cast<uint8_t>(0), stream); // reserved2
+			io::write(static_cast<uint8_t>(0), stream); // reserved3
+			io::write(static_cast<uint8_t>(0), stream); // reserved4
+
+			std::vector<uint8_t> ubjson = json::to_ubjson(ng);
+			io::write_exact(stream, tcb::as_bytes(tcb::make_span(ubjson)));
+			return std::move(stream.vector());
+		},
+		"Couldn't save profiles. Are you out of Disk space / playing in a protected folder?",
+		true
+	);
 }
 
 void PR_LoadProfiles(void)
@@ -363,6 +354,9 @@ void PR_LoadProfiles(void)
 		true
 	);
 
+	// Don't read a file that's still being written
+	G_FlushSaves();
+
 	std::string datapath {fmt::format("{}/{}", srb2home, PROFILESFILE)};
 
 	io::BufferedInputStream<io::FileStream> bis;
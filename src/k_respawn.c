@@ -122,7 +122,7 @@ void K_DoFault(player_t *player)
 		if (player->roundconditions.faulted == false)
 		{
 			player->roundconditions.faulted = true;
-			player->roundconditions.checkthisframe = true;
+			player->roundconditions.checkthisframe |= UCD_FAULTED;
 		}
 	}
 }
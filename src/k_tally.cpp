@@ -871,7 +871,7 @@ void level_tally_t::Tick(void)
 					delay = TICRATE/2;
 
 					// for UCRP_FINISHGRADE
-					owner->roundconditions.checkthisframe = true;
+					owner->roundconditions.checkthisframe |= UCD_FINISH;
 				}
 				else
 				{
@@ -24,6 +24,7 @@
 #include "cxxutil.hpp"
 
 #include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/format.h>
@@ -53,6 +54,10 @@ static size_t baseopensetsize    = OPENSET_BASE_SIZE;
 static size_t baseclosedsetsize  = CLOSEDSET_BASE_SIZE;
 static size_t basenodesarraysize = NODESARRAY_BASE_SIZE;
 
+// Waypoint ID -> waypointheap index, built on the first lookup after the heap changes.
+static std::unordered_map<INT32, size_t> waypointidmap;
+static boolean waypointidmapvalid = false;
+
 
 /*--------------------------------------------------
 	waypoint_t *K_GetFinishLineWaypoint(void)
@@ -266,12 +271,40 @@ waypoint_t *K_GetWaypointFromID(INT32 waypointID)
 	waypoint_t *waypoint = NULL;
 	size_t i = SIZE_MAX;
 
+	if (waypointidmapvalid == false)
+	{
+		waypointidmap.clear();
+		waypointidmap.reserve(numwaypoints);
+
+		for (i = 0; i < numwaypoints; i++)
+		{
+			// emplace keeps the first waypoint with an ID, the same one a linear search finds.
+			waypointidmap.emplace(K_GetWaypointID(&waypointheap[i]), i);
+		}
+
+		waypointidmapvalid = true;
+	}
+
+	auto it = waypointidmap.find(waypointID);
+	if (it != waypointidmap.end())
+	{
+		waypoint = &waypointheap[it->second];
+
+		if (K_GetWaypointID(waypoint) == waypointID)
+		{
+			return waypoint;
+		}
+	}
+
+	// The ID is not in the map, or a waypoint's mobj was changed after it was built.
+	// Fall back to searching the heap, and rebuild next time if that finds anything.
 	for (i = 0; i < numwaypoints; i++)
 	{
 		waypoint = &waypointheap[i];
 
 		if (K_GetWaypointID(waypoint) == waypointID)
 		{
+			waypointidmapvalid = false;
 			return waypoint;
 		}
 	}
@@ -2094,6 +2127,7 @@ static waypoint_t *K_MakeWaypoint(mobj_t *const mobj)
 
 	madewaypoint = &waypointheap[numwaypoints];
 	numwaypoints++;
+	waypointidmapvalid = false;
 
 	madewaypoint->mobj = NULL;
 	P_SetTarget(&madewaypoint->mobj, mobj);
@@ -2808,6 +2842,9 @@ void K_ClearWaypoints(void)
 	numwaypointmobjs = 0U;
 	circuitlength    = 0U;
 	trackcomplexity  = 0U;
+
+	waypointidmap.clear();
+	waypointidmapvalid = false;
 }
 
 /*--------------------------------------------------
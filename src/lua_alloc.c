@@ -0,0 +1,330 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  lua_alloc.c
+/// \brief Size-class allocator for Lua states
+
+#include "doomdef.h"
+#include "command.h"
+#include "i_system.h"
+#include "z_zone.h"
+#include "lua_alloc.h"
+
+#include "blua/lua.h"
+#include "blua/lauxlib.h"
+
+#define LUAALLOC_PAGESIZE (16*1024)
+
+// Every class is a multiple of 8, which is all the alignment Lua needs.
+static const UINT16 sizeclasses[] = {
+	16, 24, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 448, LUAALLOC_MAXSMALL
+};
+
+#define NUMSIZECLASSES (sizeof (sizeclasses) / sizeof (*sizeclasses))
+
+// (size + 7) / 8 -> index into sizeclasses
+static UINT8 sizeclasslookup[(LUAALLOC_MAXSMALL / 8) + 1];
+static boolean sizeclassesready = false;
+
+typedef struct luaallocpage_s
+{
+	struct luaallocpage_s *next;
+	void *pad; // keeps the blocks after the header 16-byte aligned
+} luaallocpage_t;
+
+typedef struct luaallocfree_s
+{
+	struct luaallocfree_s *next;
+} luaallocfree_t;
+
+struct luaallocator_t
+{
+	luaallocfree_t *freelist[NUMSIZECLASSES];
+	luaallocpage_t *pages;
+	luaallocstats_t stats;
+};
+
+static void LUA_InitSizeClasses(void)
+{
+	size_t i, c = 0;
+
+	if (sizeclassesready)
+		return;
+
+	for (i = 0; i < sizeof (sizeclasslookup); i++)
+	{
+		while (sizeclasses[c] < i * 8)
+			c++;
+		sizeclasslookup[i] = (UINT8)c;
+	}
+
+	sizeclassesready = true;
+}
+
+static inline UINT8 LUA_SizeClass(size_t size)
+{
+	return sizeclasslookup[(size + 7) >> 3];
+}
+
+luaallocator_t *LUA_CreateAllocator(void)
+{
+	luaallocator_t *alloc = calloc(1, sizeof (*alloc));
+
+	if (alloc == NULL)
+		I_Error("LUA_CreateAllocator: out of memory");
+
+	LUA_InitSizeClasses();
+	return alloc;
+}
+
+void LUA_DestroyAllocator(luaallocator_t *alloc)
+{
+	luaallocpage_t *page, *next;
+
+	if (alloc == NULL)
+		return;
+
+	for (page = alloc->pages; page; page = next)
+	{
+		next = page->next;
+		free(page);
+	}
+
+	free(alloc);
+}
+
+const luaallocstats_t *LUA_GetAllocatorStats(const luaallocator_t *alloc)
+{
+	return &alloc->stats;
+}
+
+// Split a new page into blocks of one size class.
+static boolean LUA_AddPage(luaallocator_t *alloc, UINT8 sc)
+{
+	const size_t blocksize = sizeclasses[sc];
+	luaallocpage_t *page = malloc(LUAALLOC_PAGESIZE);
+	UINT8 *block, *end;
+
+	if (page == NULL)
+		return false;
+
+	page->next = alloc->pages;
+	alloc->pages = page;
+
+	alloc->stats.pages++;
+	alloc->stats.reserved += LUAALLOC_PAGESIZE;
+
+	block = (UINT8 *)(page + 1);
+	end = (UINT8 *)page + LUAALLOC_PAGESIZE - blocksize;
+
+	for (; block <= end; block += blocksize)
+	{
+		luaallocfree_t *f = (luaallocfree_t *)block;
+		f->next = alloc->freelist[sc];
+		alloc->freelist[sc] = f;
+	}
+
+	return true;
+}
+
+static void *LUA_SmallAlloc(luaallocator_t *alloc, UINT8 sc)
+{
+	luaallocfree_t *f = alloc->freelist[sc];
+
+	if (f == NULL)
+	{
+		if (!LUA_AddPage(alloc, sc))
+			return NULL;
+		f = alloc->freelist[sc];
+	}
+
+	alloc->freelist[sc] = f->next;
+	alloc->stats.smallblocks++;
+	return f;
+}
+
+static void LUA_SmallFree(luaallocator_t *alloc, void *ptr, UINT8 sc)
+{
+	luaallocfree_t *f = ptr;
+
+	f->next = alloc->freelist[sc];
+	alloc->freelist[sc] = f;
+	alloc->stats.smallblocks--;
+}
+
+static void LUA_FreeBlock(luaallocator_t *alloc, void *ptr, size_t size)
+{
+	if (size <= LUAALLOC_MAXSMALL)
+	{
+		LUA_SmallFree(alloc, ptr, LUA_SizeClass(size));
+	}
+	else
+	{
+		free(ptr);
+		alloc->stats.largeblocks--;
+		alloc->stats.reserved -= size;
+	}
+}
+
+// Lua 5.1 always passes the real size of ptr as osize (0 for new blocks),
+// so the size class can be found without a block header.
+void *LUA_PoolAlloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	luaallocator_t *alloc = ud;
+	void *newptr;
+
+	if (nsize == 0)
+	{
+		if (ptr != NULL)
+		{
+			LUA_FreeBlock(alloc, ptr, osize);
+			alloc->stats.inuse -= osize;
+			alloc->stats.frees++;
+		}
+		return NULL;
+	}
+
+	if (ptr != NULL && osize > LUAALLOC_MAXSMALL && nsize > LUAALLOC_MAXSMALL)
+	{
+		// Large to large, let the system resize it in place if it can.
+		newptr = realloc(ptr, nsize);
+
+		if (newptr == NULL)
+			return NULL;
+
+		alloc->stats.reserved += nsize - osize;
+	}
+	else if (ptr != NULL && osize <= LUAALLOC_MAXSMALL && nsize <= LUAALLOC_MAXSMALL
+		&& LUA_SizeClass(osize) == LUA_SizeClass(nsize))
+	{
+		// Still fits in the same class.
+		newptr = ptr;
+	}
+	else
+	{
+		if (nsize <= LUAALLOC_MAXSMALL)
+		{
+			newptr = LUA_SmallAlloc(alloc, LUA_SizeClass(nsize));
+		}
+		else
+		{
+			newptr = malloc(nsize);
+
+			if (newptr != NULL)
+			{
+				alloc->stats.largeblocks++;
+				alloc->stats.reserved += nsize;
+			}
+		}
+
+		if (newptr == NULL)
+			return NULL;
+
+		if (ptr != NULL)
+		{
+			M_Memcpy(newptr, ptr, min(osize, nsize));
+			LUA_FreeBlock(alloc, ptr, osize);
+		}
+	}
+
+	alloc->stats.inuse += nsize - osize;
+	alloc->stats.allocs++;
+
+	if (alloc->stats.inuse > alloc->stats.peak)
+		alloc->stats.peak = alloc->stats.inuse;
+
+	return newptr;
+}
+
+void *LUA_ZoneAlloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	(void)ud;
+	if (nsize == 0) {
+		if (osize != 0)
+			Z_Free(ptr);
+		return NULL;
+	} else
+		return Z_Realloc(ptr, nsize, PU_LUA, NULL);
+}
+
+// Builds and throws away lots of small tables and strings, which is most of
+// what a busy Lua addon asks the allocator for.
+static const char *luaallocbench_script =
+	"local n = ...\n"
+	"local keep = {}\n"
+	"for i = 1, n do\n"
+	"	local k = \"key\" .. (i % 4096)\n"
+	"	local t = { i, i * 2, name = k, pos = { x = i, y = -i } }\n"
+	"	keep[k] = t\n"
+	"	if i % 3 == 0 then keep[\"key\" .. ((i * 7) % 4096)] = nil end\n"
+	"	local s = k .. \":\" .. t.name .. \":\" .. tostring(t.pos.x)\n"
+	"end\n";
+
+static int LUA_BenchTostring(lua_State *L)
+{
+	lua_pushstring(L, va("%d", (int)luaL_checkinteger(L, 1)));
+	return 1;
+}
+
+static precise_t LUA_RunAllocBench(lua_State *L, INT32 iterations)
+{
+	precise_t start;
+
+	lua_register(L, "tostring", LUA_BenchTostring);
+
+	if (luaL_loadstring(L, luaallocbench_script))
+	{
+		CONS_Alert(CONS_ERROR, "luaallocbench: %s\n", lua_tostring(L, -1));
+		return 0;
+	}
+
+	lua_pushinteger(L, iterations);
+
+	start = I_GetPreciseTime();
+
+	if (lua_pcall(L, 1, 0, 0))
+	{
+		CONS_Alert(CONS_ERROR, "luaallocbench: %s\n", lua_tostring(L, -1));
+		return 0;
+	}
+
+	lua_gc(L, LUA_GCCOLLECT, 0);
+
+	return I_GetPreciseTime() - start;
+}
+
+void Command_LuaAllocBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	INT32 iterations = 200000;
+	luaallocator_t *alloc;
+	const luaallocstats_t *stats;
+	lua_State *L;
+	precise_t zonetime, pooltime;
+
+	if (COM_Argc() > 1)
+		iterations = max(1, atoi(COM_Argv(1)));
+
+	L = lua_newstate(LUA_ZoneAlloc, NULL);
+	zonetime = LUA_RunAllocBench(L, iterations);
+	lua_close(L);
+
+	alloc = LUA_CreateAllocator();
+	L = lua_newstate(LUA_PoolAlloc, alloc);
+	pooltime = LUA_RunAllocBench(L, iterations);
+
+	stats = LUA_GetAllocatorStats(alloc);
+	CONS_Printf("%d iterations\n", iterations);
+	CONS_Printf("zone allocator: %s us\n", sizeu1((size_t)(zonetime * 1000000 / precision)));
+	CONS_Printf("pool allocator: %s us\n", sizeu1((size_t)(pooltime * 1000000 / precision)));
+	CONS_Printf("pool peak %s KB, %s pages, %s allocations\n",
+		sizeu1(stats->peak >> 10), sizeu2(stats->pages), sizeu3((size_t)stats->allocs));
+
+	lua_close(L);
+	LUA_DestroyAllocator(alloc);
+}
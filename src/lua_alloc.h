@@ -0,0 +1,66 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  lua_alloc.h
+/// \brief Size-class allocator for Lua states
+
+// Lua makes huge numbers of small, short-lived allocations (strings, tables,
+// closures, upvalues). Each Lua state gets its own allocator: blocks up to
+// LUAALLOC_MAXSMALL bytes come from per-size-class free lists carved out of
+// larger pages, anything bigger goes straight to the system allocator.
+// An allocator is only ever touched by the thread running its state, so the
+// pools need no locking, and everything is handed back in one go when the
+// state is closed.
+
+#ifndef __LUA_ALLOC__
+#define __LUA_ALLOC__
+
+#include "doomtype.h"
+#include "typedef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LUAALLOC_MAXSMALL 512
+
+struct luaallocstats_t
+{
+	size_t inuse; // Bytes currently allocated by Lua
+	size_t peak; // Highest inuse so far
+	size_t reserved; // Bytes taken from the system, pages and large blocks
+	size_t pages; // Small block pages
+	size_t smallblocks; // Live blocks from the size classes
+	size_t largeblocks; // Live blocks from the system allocator
+	UINT64 allocs; // Total allocations, including resizes
+	UINT64 frees; // Total frees
+};
+
+// Create an allocator to pass as the userdata of lua_newstate.
+luaallocator_t *LUA_CreateAllocator(void);
+
+// Free every page. Large blocks come from the system allocator and are
+// freed by lua_close, so only call this after it.
+void LUA_DestroyAllocator(luaallocator_t *alloc);
+
+// lua_Alloc for states created with a luaallocator_t.
+void *LUA_PoolAlloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+// lua_Alloc that uses the zone allocator with PU_LUA. ud is unused.
+void *LUA_ZoneAlloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+const luaallocstats_t *LUA_GetAllocatorStats(const luaallocator_t *alloc);
+
+// Console command: compare both allocators on a table and string churn script.
+void Command_LuaAllocBench_f(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // __LUA_ALLOC__
@@ -434,9 +434,11 @@ static int pcall_timed_or_untimed(Hook_State *hook)
 {
 	extern consvar_t cv_lua_profile;
 
-	if (!hud_running && cv_lua_profile.value > 0)
+	if (cv_lua_profile.value > 0)
 	{
-		lua_timer_t *timer = LUA_BeginFunctionTimer(gL, -1 - hook->values, hook_name(hook));
+		lua_timer_t *timer = hud_running ?
+			LUA_BeginHUDTimer(gL, -1 - hook->values, hook_name(hook)) :
+			LUA_BeginFunctionTimer(gL, -1 - hook->values, hook_name(hook));
 		int k = pcall(hook);
 		LUA_EndFunctionTimer(timer);
 
@@ -15,9 +15,18 @@
 
 #include <string.h>
 
+#include "command.h"
+#include "r_fps.h"
+#include "r_main.h"
 #include "v_video.h"
 #include "z_zone.h"
 
+extern consvar_t cv_luahudinterp;
+
+// Positions further apart than this between tics are treated as a jump
+// rather than movement, and are not interpolated.
+#define INTERP_MAXDELTA (64*FRACUNIT)
+
 enum drawitem_e {
 	DI_Draw = 0,
 	DI_DrawScaled,
@@ -66,10 +75,15 @@ typedef struct drawitem_s {
 } drawitem_t;
 
 // The internal structure of a drawlist.
+// HUD hooks only refill a list on new tics, so the previous tic's items are
+// kept around for interpolating between the two.
 struct huddrawlist_s {
 	drawitem_t *items;
 	size_t items_capacity;
 	size_t items_len;
+	drawitem_t *previtems;
+	size_t previtems_capacity;
+	size_t previtems_len;
 	char *strbuf;
 	size_t strbuf_capacity;
 	size_t strbuf_len;
@@ -96,6 +110,9 @@ huddrawlist_h LUA_HUD_CreateDrawList(void)
 	drawlist->items = NULL;
 	drawlist->items_capacity = 0;
 	drawlist->items_len = 0;
+	drawlist->previtems = NULL;
+	drawlist->previtems_capacity = 0;
+	drawlist->previtems_len = 0;
 	drawlist->strbuf = NULL;
 	drawlist->strbuf_capacity = 0;
 	drawlist->strbuf_len = 0;
@@ -106,7 +123,17 @@ huddrawlist_h LUA_HUD_CreateDrawList(void)
 void LUA_HUD_ClearDrawList(huddrawlist_h list)
 {
 	// rather than deallocate, we'll just save the existing allocation and empty
-	// it out for reuse
+	// it out for reuse. the items that were just drawn become the previous
+	// tic's, and the old previous buffer gets reused for the new ones
+	drawitem_t *items = list->previtems;
+	size_t capacity = list->previtems_capacity;
+
+	list->previtems = list->items;
+	list->previtems_capacity = list->items_capacity;
+	list->previtems_len = list->items_len;
+
+	list->items = items;
+	list->items_capacity = capacity;
 
 	// this memset probably isn't necessary
 	if (list->items)
@@ -131,6 +158,10 @@ void LUA_HUD_DestroyDrawList(huddrawlist_h list)
 	{
 		Z_Free(list->items);
 	}
+	if (list->previtems)
+	{
+		Z_Free(list->previtems);
+	}
 	if (list->strbuf)
 	{
 		Z_Free(list->strbuf);
@@ -394,29 +425,89 @@ void LUA_HUD_AddDrawKartString(
 	item->flags = flags;
 }
 
+static fixed_t InterpolateCoord(fixed_t from, fixed_t to, fixed_t frac)
+{
+	if (abs(to - from) > INTERP_MAXDELTA)
+		return to;
+
+	return from + FixedMul(to - from, frac);
+}
+
+// Find where a patch item was on the previous tic. Hooks usually draw the
+// same things in the same order every tic, so an item is matched with the one
+// at the same index, as long as it is drawing the same patch the same way.
+// Only patches are interpolated; text and numbers are drawn on whole pixels
+// anyway and would just jitter.
+static void InterpolatePatchItem(huddrawlist_h list, size_t i, fixed_t frac, fixed_t *x, fixed_t *y)
+{
+	const drawitem_t *item = &list->items[i];
+	const drawitem_t *prev;
+	fixed_t px, py;
+
+	if (i >= list->previtems_len)
+		return;
+
+	prev = &list->previtems[i];
+
+	if (prev->type != item->type || prev->patch != item->patch)
+		return;
+
+	px = prev->x;
+	py = prev->y;
+
+	if (item->type == DI_Draw)
+	{
+		px <<= FRACBITS;
+		py <<= FRACBITS;
+	}
+
+	*x = InterpolateCoord(px, *x, frac);
+	*y = InterpolateCoord(py, *y, frac);
+}
+
 void LUA_HUD_DrawList(huddrawlist_h list)
 {
 	size_t i;
+	boolean interp;
+	fixed_t frac = FRACUNIT;
 
 	if (!list) I_Error("HUD drawlist invalid");
 	if (list->items_len <= 0) return;
 	if (!list->items) I_Error("HUD drawlist->items invalid");
 
+	interp = (cv_luahudinterp.value && R_UsingFrameInterpolation());
+
+	if (interp)
+		frac = rendertimefrac;
+
 	for (i = 0; i < list->items_len; i++)
 	{
 		drawitem_t *item = &list->items[i];
 		const char *itemstr = &list->strbuf[item->stroffset];
+		fixed_t x, y;
 
 		switch (item->type)
 		{
 			case DI_Draw:
-				V_DrawFixedPatch(item->x<<FRACBITS, item->y<<FRACBITS, FRACUNIT, item->flags, item->patch, item->colormap);
+				x = item->x<<FRACBITS;
+				y = item->y<<FRACBITS;
+				if (interp)
+					InterpolatePatchItem(list, i, frac, &x, &y);
+				V_DrawFixedPatch(x, y, FRACUNIT, item->flags, item->patch, item->colormap);
 				break;
 			case DI_DrawScaled:
-				V_DrawFixedPatch(item->x, item->y, item->scale, item->flags, item->patch, item->colormap);
+				x = item->x;
+				y = item->y;
+				if (interp)
+					InterpolatePatchItem(list, i, frac, &x, &y);
+				V_DrawFixedPatch(x, y, item->scale, item->flags, item->patch, item->colormap);
 				break;
 			case DI_DrawStretched:
-				V_DrawStretchyFixedPatch(item->x, item->y, item->hscale, item->vscale, item->flags, item->patch, item->colormap);
+				x = item->x;
+				y = item->y;
+				if (interp)
+					InterpolatePatchItem(list, i, frac, &x, &y);
+				V_DrawStretchyFixedPatch(x, y, item->hscale, item->vscale, item->flags, item->patch, item->colormap);
 				break;
 			case DI_DrawNum:
 				V_DrawTallNum(item->x, item->y, item->flags, item->num);
@@ -19,6 +19,7 @@
 #include "p_slopes.h"
 #include "p_polyobj.h"
 #include "r_main.h"
+#include "r_textures.h" // R_RequestTexture
 
 #include "lua_script.h"
 #include "lua_libs.h"
@@ -397,6 +398,20 @@ static const char *const activator_opt[] = {
 static const char *const array_opt[] ={"iterate",NULL};
 static const char *const valid_opt[] ={"valid",NULL};
 
+static int sector_fields_ref = LUA_NOREF;
+static int subsector_fields_ref = LUA_NOREF;
+static int line_fields_ref = LUA_NOREF;
+static int side_fields_ref = LUA_NOREF;
+static int vertex_fields_ref = LUA_NOREF;
+#ifdef HAVE_LUA_SEGS
+static int seg_fields_ref = LUA_NOREF;
+static int node_fields_ref = LUA_NOREF;
+#endif
+static int ffloor_fields_ref = LUA_NOREF;
+static int slope_fields_ref = LUA_NOREF;
+static int vector_fields_ref = LUA_NOREF;
+static int activator_fields_ref = LUA_NOREF;
+
 /////////////////////////////////////////////
 // sector/subsector list iterate functions //
 /////////////////////////////////////////////
@@ -636,7 +651,7 @@ static int sectorstringargs_len(lua_State *L)
 static int sector_get(lua_State *L)
 {
 	sector_t *sector = *((sector_t **)luaL_checkudata(L, 1, META_SECTOR));
-	enum sector_e field = luaL_checkoption(L, 2, sector_opt[0], sector_opt);
+	enum sector_e field = Lua_checkoption(L, 2, sector_valid, sector_fields_ref);
 	INT16 i;
 
 	if (!sector)
@@ -770,7 +785,7 @@ static int sector_get(lua_State *L)
 static int sector_set(lua_State *L)
 {
 	sector_t *sector = *((sector_t **)luaL_checkudata(L, 1, META_SECTOR));
-	enum sector_e field = luaL_checkoption(L, 2, sector_opt[0], sector_opt);
+	enum sector_e field = Lua_checkoption(L, 2, sector_valid, sector_fields_ref);
 
 	if (!sector)
 		return luaL_error(L, "accessed sector_t doesn't exist anymore.");
@@ -895,7 +910,7 @@ static int sector_num(lua_State *L)
 static int subsector_get(lua_State *L)
 {
 	subsector_t *subsector = *((subsector_t **)luaL_checkudata(L, 1, META_SUBSECTOR));
-	enum subsector_e field = luaL_checkoption(L, 2, subsector_opt[0], subsector_opt);
+	enum subsector_e field = Lua_checkoption(L, 2, subsector_valid, subsector_fields_ref);
 
 	if (!subsector)
 	{
@@ -979,7 +994,7 @@ static int linestringargs_len(lua_State *L)
 static int line_get(lua_State *L)
 {
 	line_t *line = *((line_t **)luaL_checkudata(L, 1, META_LINE));
-	enum line_e field = luaL_checkoption(L, 2, line_opt[0], line_opt);
+	enum line_e field = Lua_checkoption(L, 2, line_valid, line_fields_ref);
 
 	if (!line)
 	{
@@ -1138,7 +1153,7 @@ static int sidenum_get(lua_State *L)
 static int side_get(lua_State *L)
 {
 	side_t *side = *((side_t **)luaL_checkudata(L, 1, META_SIDE));
-	enum side_e field = luaL_checkoption(L, 2, side_opt[0], side_opt);
+	enum side_e field = Lua_checkoption(L, 2, side_valid, side_fields_ref);
 
 	if (!side)
 	{
@@ -1188,7 +1203,7 @@ static int side_get(lua_State *L)
 static int side_set(lua_State *L)
 {
 	side_t *side = *((side_t **)luaL_checkudata(L, 1, META_SIDE));
-	enum side_e field = luaL_checkoption(L, 2, side_opt[0], side_opt);
+	enum side_e field = Lua_checkoption(L, 2, side_valid, side_fields_ref);
 
 	if (!side)
 	{
@@ -1215,12 +1230,15 @@ static int side_set(lua_State *L)
 		break;
 	case side_toptexture:
 		side->toptexture = luaL_checkinteger(L, 3);
+		R_RequestTexture(R_GetTextureNum(side->toptexture));
 		break;
 	case side_bottomtexture:
 		side->bottomtexture = luaL_checkinteger(L, 3);
+		R_RequestTexture(R_GetTextureNum(side->bottomtexture));
 		break;
 	case side_midtexture:
 		side->midtexture = luaL_checkinteger(L, 3);
+		R_RequestTexture(R_GetTextureNum(side->midtexture));
 		break;
 	case side_repeatcnt:
 		side->repeatcnt = luaL_checkinteger(L, 3);
@@ -1243,7 +1261,7 @@ static int side_num(lua_State *L)
 static int vertex_get(lua_State *L)
 {
 	vertex_t *vertex = *((vertex_t **)luaL_checkudata(L, 1, META_VERTEX));
-	enum vertex_e field = luaL_checkoption(L, 2, vertex_opt[0], vertex_opt);
+	enum vertex_e field = Lua_checkoption(L, 2, vertex_valid, vertex_fields_ref);
 
 	if (!vertex)
 	{
@@ -1297,7 +1315,7 @@ static int vertex_num(lua_State *L)
 static int seg_get(lua_State *L)
 {
 	seg_t *seg = *((seg_t **)luaL_checkudata(L, 1, META_SEG));
-	enum seg_e field = luaL_checkoption(L, 2, seg_opt[0], seg_opt);
+	enum seg_e field = Lua_checkoption(L, 2, seg_valid, seg_fields_ref);
 
 	if (!seg)
 	{
@@ -1361,7 +1379,7 @@ static int seg_num(lua_State *L)
 static int node_get(lua_State *L)
 {
 	node_t *node = *((node_t **)luaL_checkudata(L, 1, META_NODE));
-	enum node_e field = luaL_checkoption(L, 2, node_opt[0], node_opt);
+	enum node_e field = Lua_checkoption(L, 2, node_valid, node_fields_ref);
 
 	if (!node)
 	{
@@ -1997,7 +2015,7 @@ static INT32 P_GetOldFOFFlags(ffloor_t *fflr)
 static int ffloor_get(lua_State *L)
 {
 	ffloor_t *ffloor = *((ffloor_t **)luaL_checkudata(L, 1, META_FFLOOR));
-	enum ffloor_e field = luaL_checkoption(L, 2, ffloor_opt[0], ffloor_opt);
+	enum ffloor_e field = Lua_checkoption(L, 2, ffloor_valid, ffloor_fields_ref);
 	INT16 i;
 
 	if (!ffloor)
@@ -2179,7 +2197,7 @@ static void P_SetOldFOFFlags(ffloor_t *fflr, oldffloortype_e oldflags)
 static int ffloor_set(lua_State *L)
 {
 	ffloor_t *ffloor = *((ffloor_t **)luaL_checkudata(L, 1, META_FFLOOR));
-	enum ffloor_e field = luaL_checkoption(L, 2, ffloor_opt[0], ffloor_opt);
+	enum ffloor_e field = Lua_checkoption(L, 2, ffloor_valid, ffloor_fields_ref);
 
 	if (!ffloor)
 		return luaL_error(L, "accessed ffloor_t doesn't exist anymore.");
@@ -2274,7 +2292,7 @@ static int ffloor_set(lua_State *L)
 static int slope_get(lua_State *L)
 {
 	pslope_t *slope = *((pslope_t **)luaL_checkudata(L, 1, META_SLOPE));
-	enum slope_e field = luaL_checkoption(L, 2, slope_opt[0], slope_opt);
+	enum slope_e field = Lua_checkoption(L, 2, slope_valid, slope_fields_ref);
 
 	if (!slope)
 	{
@@ -2318,7 +2336,7 @@ static int slope_get(lua_State *L)
 static int slope_set(lua_State *L)
 {
 	pslope_t *slope = *((pslope_t **)luaL_checkudata(L, 1, META_SLOPE));
-	enum slope_e field = luaL_checkoption(L, 2, slope_opt[0], slope_opt);
+	enum slope_e field = Lua_checkoption(L, 2, slope_valid, slope_fields_ref);
 
 	if (!slope)
 		return luaL_error(L, "accessed pslope_t doesn't exist anymore.");
@@ -2408,7 +2426,7 @@ static int slope_set(lua_State *L)
 static int vector2_get(lua_State *L)
 {
 	vector2_t *vec = *((vector2_t **)luaL_checkudata(L, 1, META_VECTOR2));
-	enum vector_e field = luaL_checkoption(L, 2, vector_opt[0], vector_opt);
+	enum vector_e field = Lua_checkoption(L, 2, vector_x, vector_fields_ref);
 
 	if (!vec)
 		return luaL_error(L, "accessed vector2_t doesn't exist anymore.");
@@ -2426,7 +2444,7 @@ static int vector2_get(lua_State *L)
 static int vector3_get(lua_State *L)
 {
 	vector3_t *vec = *((vector3_t **)luaL_checkudata(L, 1, META_VECTOR3));
-	enum vector_e field = luaL_checkoption(L, 2, vector_opt[0], vector_opt);
+	enum vector_e field = Lua_checkoption(L, 2, vector_x, vector_fields_ref);
 
 	if (!vec)
 		return luaL_error(L, "accessed vector3_t doesn't exist anymore.");
@@ -2593,7 +2611,7 @@ static int mapheaderinfo_get(lua_State *L)
 static int activator_get(lua_State *L)
 {
 	activator_t *activator = *((activator_t **)luaL_checkudata(L, 1, META_ACTIVATOR));
-	enum activator_e field = luaL_checkoption(L, 2, activator_opt[0], activator_opt);
+	enum activator_e field = Lua_checkoption(L, 2, activator_valid, activator_fields_ref);
 
 	if (activator == NULL)
 	{
@@ -2641,6 +2659,20 @@ static int activator_get(lua_State *L)
 
 int LUA_MapLib(lua_State *L)
 {
+	sector_fields_ref = Lua_CreateFieldTable(L, sector_opt);
+	subsector_fields_ref = Lua_CreateFieldTable(L, subsector_opt);
+	line_fields_ref = Lua_CreateFieldTable(L, line_opt);
+	side_fields_ref = Lua_CreateFieldTable(L, side_opt);
+	vertex_fields_ref = Lua_CreateFieldTable(L, vertex_opt);
+#ifdef HAVE_LUA_SEGS
+	seg_fields_ref = Lua_CreateFieldTable(L, seg_opt);
+	node_fields_ref = Lua_CreateFieldTable(L, node_opt);
+#endif
+	ffloor_fields_ref = Lua_CreateFieldTable(L, ffloor_opt);
+	slope_fields_ref = Lua_CreateFieldTable(L, slope_opt);
+	vector_fields_ref = Lua_CreateFieldTable(L, vector_opt);
+	activator_fields_ref = Lua_CreateFieldTable(L, activator_opt);
+
 	luaL_newmetatable(L, META_SECTORLINES);
 		lua_pushcfunction(L, sectorlines_get);
 		lua_setfield(L, -2, "__index");
@@ -18,12 +18,15 @@
 #include "g_game.h"
 #include "p_local.h"
 #include "d_clisrv.h"
+#include "command.h" // COM_Argv
+#include "i_system.h" // I_GetPreciseTime
 
 #include "lua_script.h"
 #include "lua_libs.h"
 #include "lua_hud.h" // hud_running errors
 #include "lua_hook.h" // hook_cmd_running errors
 #include "k_profiles.h" // GetPrettyRRID
+#include "lua_alloc.h" // LUA_ZoneAlloc
 
 static int lib_iteratePlayers(lua_State *L)
 {
@@ -173,543 +176,1270 @@ static int lib_lenDisplayplayers(lua_State *L)
 	return 1;
 }
 
+enum player_e {
+	player_valid = 0,
+	player_name,
+	player_mo,
+	player_cmd,
+	player_oldcmd,
+	player_respawn,
+	player_playerstate,
+	player_viewz,
+	player_viewheight,
+	player_viewrollangle,
+	player_tilt,
+	player_aiming,
+	player_drawangle,
+	player_karthud,
+	player_nocontrol,
+	player_carry,
+	player_dye,
+	player_position,
+	player_oldposition,
+	player_positiondelay,
+	player_distancetofinish,
+	player_distancetofinishprev,
+	player_lastpickupdistance,
+	player_lastpickuptype,
+	player_airtime,
+	player_lastairtime,
+	player_flashing,
+	player_spinouttimer,
+	player_instashield,
+	player_nullhitlag,
+	player_wipeoutslow,
+	player_justbumped,
+	player_noebrakemagnet,
+	player_tumblebounces,
+	player_tumbleheight,
+	player_justdi,
+	player_flipdi,
+	player_analoginput,
+	player_markedfordeath,
+	player_incontrol,
+	player_progressivethrust,
+	player_ringvisualwarning,
+	player_dotrickfx,
+	player_stingfx,
+	player_bumperinflate,
+	player_ringboxdelay,
+	player_ringboxaward,
+	player_itemflags,
+	player_drift,
+	player_driftcharge,
+	player_driftboost,
+	player_strongdriftboost,
+	player_gateboost,
+	player_gatesound,
+	player_aizdriftstraft,
+	player_aizdriftextend,
+	player_aizdrifttilt,
+	player_aizdriftturn,
+	player_offroad,
+	player_tiregrease,
+	player_springstars,
+	player_springcolor,
+	player_dashpadcooldown,
+	player_spindash,
+	player_spindashspeed,
+	player_spindashboost,
+	player_fastfall,
+	player_fastfallbase,
+	player_numboosts,
+	player_boostpower,
+	player_speedboost,
+	player_accelboost,
+	player_handleboost,
+	player_boostangle,
+	player_draftpower,
+	player_draftleeway,
+	player_lastdraft,
+	player_tripwirestate,
+	player_tripwirepass,
+	player_fakeboost,
+	player_tripwireleniency,
+	player_tripwirerebounddelay,
+	player_eggmantransferdelay,
+	player_wavedash,
+	player_wavedashdelay,
+	player_wavedashboost,
+	player_wavedashpower,
+	player_speedpunt,
+	player_trickcharge,
+	player_infinitether,
+	player_finalfailsafe,
+	player_lastsafelap,
+	player_lastsafecheatcheck,
+	player_ignoreairtimeleniency,
+	player_topaccel,
+	player_instawhipcharge,
+	player_pitblame,
+	player_defenselockout,
+	player_oldguard,
+	player_preventfailsafe,
+	player_tripwireunstuck,
+	player_itemtype,
+	player_itemamount,
+	player_throwdir,
+	player_sadtimer,
+	player_rings,
+	player_pickuprings,
+	player_ringdelay,
+	player_ringboost,
+	player_sparkleanim,
+	player_superring,
+	player_nextringaward,
+	player_ringvolume,
+	player_ringtransparency,
+	player_ringburst,
+	player_curshield,
+	player_bubblecool,
+	player_bubbleblowup,
+	player_flamedash,
+	player_counterdash,
+	player_flamemeter,
+	player_flamelength,
+	player_ballhogcharge,
+	player_ballhogtap,
+	player_hyudorotimer,
+	player_stealingtimer,
+	player_sneakertimer,
+	player_numsneakers,
+	player_floorboost,
+	player_growshrinktimer,
+	player_rocketsneakertimer,
+	player_invincibilitytimer,
+	player_invincibilityextensions,
+	player_eggmanexplode,
+	player_eggmanblame,
+	player_bananadrag,
+	player_lastjawztarget,
+	player_jawztargetdelay,
+	player_confirmvictim,
+	player_confirmvictimdelay,
+	player_glancedir,
+	player_trickpanel,
+	player_tricktime,
+	player_trickboostpower,
+	player_trickboostdecay,
+	player_trickboost,
+	player_tricklock,
+	player_dashringpulltics,
+	player_dashringpushtics,
+	player_roundscore,
+	player_emeralds,
+	player_karmadelay,
+	player_spheres,
+	player_spheredigestion,
+	player_pflags,
+	player_panim,
+	player_flashcount,
+	player_flashpal,
+	player_skincolor,
+	player_skin,
+	player_fakeskin,
+	player_lastfakeskin,
+	player_score,
+	player_kartspeed,
+	player_kartweight,
+	player_followerskin,
+	player_followerready,
+	player_followercolor,
+	player_follower,
+	player_rideroid,
+	player_rdnodepull,
+	player_rideroidangle,
+	player_rideroidspeed,
+	player_rideroidrollangle,
+	player_rdaddmomx,
+	player_rdaddmomy,
+	player_rdaddmomz,
+	player_bungee,
+	player_lasthover,
+	player_dlzrocket,
+	player_dlzrocketangle,
+	player_dlzrocketanglev,
+	player_dlzrocketspd,
+	player_seasaw,
+	player_seasawcooldown,
+	player_seasawdist,
+	player_seasawangle,
+	player_seasawangleadd,
+	player_seasawmoreangle,
+	player_seasawdir,
+	player_turbine,
+	player_turbineangle,
+	player_turbineheight,
+	player_turbinespd,
+	player_cloud,
+	player_cloudlaunch,
+	player_cloudbuf,
+	player_tulip,
+	player_tuliplaunch,
+	player_tulipbuf,
+	player_charflags,
+	player_followitem,
+	player_followmobj,
+	player_lives,
+	player_xtralife,
+	player_speed,
+	player_lastspeed,
+	player_deadtimer,
+	player_exiting,
+	player_cmomx,
+	player_cmomy,
+	player_rmomx,
+	player_rmomy,
+	player_totalring,
+	player_realtime,
+	player_laps,
+	player_latestlap,
+	player_ctfteam,
+	player_checkskip,
+	player_cheatchecknum,
+	player_lastsidehit,
+	player_lastlinehit,
+	player_timeshit,
+	player_timeshitprev,
+	player_onconveyor,
+	player_awayviewmobj,
+	player_awayviewtics,
+	player_spectator,
+	player_bot,
+	player_jointime,
+	player_spectatorreentry,
+	player_griefvalue,
+	player_griefstrikes,
+	player_griefwarned,
+	player_splitscreenindex,
+	player_fovadd,
+	player_ping,
+	player_publickey,
+};
+
+static const char *const player_opt[] = {
+	"valid",
+	"name",
+	"mo",
+	"cmd",
+	"oldcmd",
+	"respawn",
+	"playerstate",
+	"viewz",
+	"viewheight",
+	"viewrollangle",
+	"tilt",
+	"aiming",
+	"drawangle",
+	"karthud",
+	"nocontrol",
+	"carry",
+	"dye",
+	"position",
+	"oldposition",
+	"positiondelay",
+	"distancetofinish",
+	"distancetofinishprev",
+	"lastpickupdistance",
+	"lastpickuptype",
+	"airtime",
+	"lastairtime",
+	"flashing",
+	"spinouttimer",
+	"instashield",
+	"nullhitlag",
+	"wipeoutslow",
+	"justbumped",
+	"noebrakemagnet",
+	"tumblebounces",
+	"tumbleheight",
+	"justdi",
+	"flipdi",
+	"analoginput",
+	"markedfordeath",
+	"incontrol",
+	"progressivethrust",
+	"ringvisualwarning",
+	"dotrickfx",
+	"stingfx",
+	"bumperinflate",
+	"ringboxdelay",
+	"ringboxaward",
+	"itemflags",
+	"drift",
+	"driftcharge",
+	"driftboost",
+	"strongdriftboost",
+	"gateboost",
+	"gatesound",
+	"aizdriftstraft",
+	"aizdriftextend",
+	"aizdrifttilt",
+	"aizdriftturn",
+	"offroad",
+	"tiregrease",
+	"springstars",
+	"springcolor",
+	"dashpadcooldown",
+	"spindash",
+	"spindashspeed",
+	"spindashboost",
+	"fastfall",
+	"fastfallbase",
+	"numboosts",
+	"boostpower",
+	"speedboost",
+	"accelboost",
+	"handleboost",
+	"boostangle",
+	"draftpower",
+	"draftleeway",
+	"lastdraft",
+	"tripwirestate",
+	"tripwirepass",
+	"fakeboost",
+	"tripwireleniency",
+	"tripwirerebounddelay",
+	"eggmantransferdelay",
+	"wavedash",
+	"wavedashdelay",
+	"wavedashboost",
+	"wavedashpower",
+	"speedpunt",
+	"trickcharge",
+	"infinitether",
+	"finalfailsafe",
+	"lastsafelap",
+	"lastsafecheatcheck",
+	"ignoreairtimeleniency",
+	"topaccel",
+	"instawhipcharge",
+	"pitblame",
+	"defenselockout",
+	"oldguard",
+	"preventfailsafe",
+	"tripwireunstuck",
+	"itemtype",
+	"itemamount",
+	"throwdir",
+	"sadtimer",
+	"rings",
+	"pickuprings",
+	"ringdelay",
+	"ringboost",
+	"sparkleanim",
+	"superring",
+	"nextringaward",
+	"ringvolume",
+	"ringtransparency",
+	"ringburst",
+	"curshield",
+	"bubblecool",
+	"bubbleblowup",
+	"flamedash",
+	"counterdash",
+	"flamemeter",
+	"flamelength",
+	"ballhogcharge",
+	"ballhogtap",
+	"hyudorotimer",
+	"stealingtimer",
+	"sneakertimer",
+	"numsneakers",
+	"floorboost",
+	"growshrinktimer",
+	"rocketsneakertimer",
+	"invincibilitytimer",
+	"invincibilityextensions",
+	"eggmanexplode",
+	"eggmanblame",
+	"bananadrag",
+	"lastjawztarget",
+	"jawztargetdelay",
+	"confirmvictim",
+	"confirmvictimdelay",
+	"glancedir",
+	"trickpanel",
+	"tricktime",
+	"trickboostpower",
+	"trickboostdecay",
+	"trickboost",
+	"tricklock",
+	"dashringpulltics",
+	"dashringpushtics",
+	"roundscore",
+	"emeralds",
+	"karmadelay",
+	"spheres",
+	"spheredigestion",
+	"pflags",
+	"panim",
+	"flashcount",
+	"flashpal",
+	"skincolor",
+	"skin",
+	"fakeskin",
+	"lastfakeskin",
+	"score",
+	"kartspeed",
+	"kartweight",
+	"followerskin",
+	"followerready",
+	"followercolor",
+	"follower",
+	"rideroid",
+	"rdnodepull",
+	"rideroidangle",
+	"rideroidspeed",
+	"rideroidrollangle",
+	"rdaddmomx",
+	"rdaddmomy",
+	"rdaddmomz",
+	"bungee",
+	"lasthover",
+	"dlzrocket",
+	"dlzrocketangle",
+	"dlzrocketanglev",
+	"dlzrocketspd",
+	"seasaw",
+	"seasawcooldown",
+	"seasawdist",
+	"seasawangle",
+	"seasawangleadd",
+	"seasawmoreangle",
+	"seasawdir",
+	"turbine",
+	"turbineangle",
+	"turbineheight",
+	"turbinespd",
+	"cloud",
+	"cloudlaunch",
+	"cloudbuf",
+	"tulip",
+	"tuliplaunch",
+	"tulipbuf",
+	"charflags",
+	"followitem",
+	"followmobj",
+	"lives",
+	"xtralife",
+	"speed",
+	"lastspeed",
+	"deadtimer",
+	"exiting",
+	"cmomx",
+	"cmomy",
+	"rmomx",
+	"rmomy",
+	"totalring",
+	"realtime",
+	"laps",
+	"latestlap",
+	"ctfteam",
+	"checkskip",
+	"cheatchecknum",
+	"lastsidehit",
+	"lastlinehit",
+	"timeshit",
+	"timeshitprev",
+	"onconveyor",
+	"awayviewmobj",
+	"awayviewtics",
+	"spectator",
+	"bot",
+	"jointime",
+	"spectatorreentry",
+	"griefvalue",
+	"griefstrikes",
+	"griefwarned",
+	"splitscreenindex",
+	"fovadd",
+	"ping",
+	"publickey",
+	NULL};
+
+static int player_fields_ref = LUA_NOREF;
+
 static int player_get(lua_State *L)
 {
 	player_t *plr = *((player_t **)luaL_checkudata(L, 1, META_PLAYER));
-	const char *field = luaL_checkstring(L, 2);
+	enum player_e field = Lua_optoption(L, 2, -1, player_fields_ref);
 
 	if (!plr) {
-		if (fastcmp(field,"valid")) {
+		if (field == player_valid) {
 			lua_pushboolean(L, false);
 			return 1;
 		}
 		return LUA_ErrInvalid(L, "player_t");
 	}
 
-	if (fastcmp(field,"valid"))
+	switch (field)
+	{
+	case player_valid:
 		lua_pushboolean(L, true);
-	else if (fastcmp(field,"name"))
+		break;
+	case player_name:
 		lua_pushstring(L, player_names[plr-players]);
-	else if (fastcmp(field,"mo"))
+		break;
+	case player_mo:
 		LUA_PushUserdata(L, plr->mo, META_MOBJ);
-	else if (fastcmp(field,"cmd"))
+		break;
+	case player_cmd:
 		LUA_PushUserdata(L, &plr->cmd, META_TICCMD);
-	else if (fastcmp(field,"oldcmd"))
+		break;
+	case player_oldcmd:
 		LUA_PushUserdata(L, &plr->oldcmd, META_TICCMD);
-	else if (fastcmp(field,"respawn"))
+		break;
+	case player_respawn:
 		LUA_PushUserdata(L, &plr->respawn, META_RESPAWN);
-	else if (fastcmp(field,"playerstate"))
+		break;
+	case player_playerstate:
 		lua_pushinteger(L, plr->playerstate);
-	else if (fastcmp(field,"viewz"))
+		break;
+	case player_viewz:
 		lua_pushfixed(L, plr->viewz);
-	else if (fastcmp(field,"viewheight"))
+		break;
+	case player_viewheight:
 		lua_pushfixed(L, plr->viewheight);
-	else if (fastcmp(field,"viewrollangle"))
+		break;
+	case player_viewrollangle:
 		lua_pushangle(L, plr->viewrollangle);
-	else if (fastcmp(field, "tilt"))
+		break;
+	case player_tilt:
 		lua_pushangle(L, plr->tilt);
-	else if (fastcmp(field,"aiming"))
+		break;
+	case player_aiming:
 		lua_pushangle(L, plr->aiming);
-	else if (fastcmp(field,"drawangle"))
+		break;
+	case player_drawangle:
 		lua_pushangle(L, plr->drawangle);
-	else if (fastcmp(field,"karthud"))
+		break;
+	case player_karthud:
 		LUA_PushUserdata(L, plr->karthud, META_KARTHUD);
-	else if (fastcmp(field,"nocontrol"))
+		break;
+	case player_nocontrol:
 		lua_pushinteger(L, plr->nocontrol);
-	else if (fastcmp(field,"carry"))
+		break;
+	case player_carry:
 		lua_pushinteger(L, plr->carry);
-	else if (fastcmp(field,"dye"))
+		break;
+	case player_dye:
 		lua_pushinteger(L, plr->dye);
-	else if (fastcmp(field,"position"))
+		break;
+	case player_position:
 		lua_pushinteger(L, plr->position);
-	else if (fastcmp(field,"oldposition"))
+		break;
+	case player_oldposition:
 		lua_pushinteger(L, plr->oldposition);
-	else if (fastcmp(field,"positiondelay"))
+		break;
+	case player_positiondelay:
 		lua_pushinteger(L, plr->positiondelay);
-	else if (fastcmp(field,"distancetofinish"))
+		break;
+	case player_distancetofinish:
 		lua_pushinteger(L, plr->distancetofinish);
-	else if (fastcmp(field,"distancetofinishprev"))
+		break;
+	case player_distancetofinishprev:
 		lua_pushinteger(L, plr->distancetofinishprev);
-	else if (fastcmp(field,"lastpickupdistance"))
+		break;
+	case player_lastpickupdistance:
 		lua_pushinteger(L, plr->lastpickupdistance);
-	else if (fastcmp(field,"lastpickuptype"))
+		break;
+	case player_lastpickuptype:
 		lua_pushinteger(L, plr->lastpickuptype);
-	else if (fastcmp(field,"airtime"))
+		break;
+	case player_airtime:
 		lua_pushinteger(L, plr->airtime);
-	else if (fastcmp(field,"lastairtime"))
+		break;
+	case player_lastairtime:
 		lua_pushinteger(L, plr->lastairtime);
-	else if (fastcmp(field,"flashing"))
+		break;
+	case player_flashing:
 		lua_pushinteger(L, plr->flashing);
-	else if (fastcmp(field,"spinouttimer"))
+		break;
+	case player_spinouttimer:
 		lua_pushinteger(L, plr->spinouttimer);
-	else if (fastcmp(field,"instashield"))
+		break;
+	case player_instashield:
 		lua_pushinteger(L, plr->instashield);
-	else if (fastcmp(field,"nullhitlag"))
+		break;
+	case player_nullhitlag:
 		lua_pushinteger(L, plr->nullHitlag);
-	else if (fastcmp(field,"wipeoutslow"))
+		break;
+	case player_wipeoutslow:
 		lua_pushinteger(L, plr->wipeoutslow);
-	else if (fastcmp(field,"justbumped"))
+		break;
+	case player_justbumped:
 		lua_pushinteger(L, plr->justbumped);
-	else if (fastcmp(field,"noebrakemagnet"))
+		break;
+	case player_noebrakemagnet:
 		lua_pushinteger(L, plr->noEbrakeMagnet);
-	else if (fastcmp(field,"tumblebounces"))
+		break;
+	case player_tumblebounces:
 		lua_pushinteger(L, plr->tumbleBounces);
-	else if (fastcmp(field,"tumbleheight"))
+		break;
+	case player_tumbleheight:
 		lua_pushinteger(L, plr->tumbleHeight);
-	else if (fastcmp(field,"justdi"))
+		break;
+	case player_justdi:
 		lua_pushinteger(L, plr->justDI);
-	else if (fastcmp(field,"flipdi"))
+		break;
+	case player_flipdi:
 		lua_pushboolean(L, plr->flipDI);
-	else if (fastcmp(field,"analoginput"))
+		break;
+	case player_analoginput:
 		lua_pushboolean(L, plr->analoginput);
-	else if (fastcmp(field,"markedfordeath"))
+		break;
+	case player_markedfordeath:
 		lua_pushboolean(L, plr->markedfordeath);
-	else if (fastcmp(field,"incontrol"))
+		break;
+	case player_incontrol:
 		lua_pushboolean(L, plr->incontrol);
-	else if (fastcmp(field,"progressivethrust"))
+		break;
+	case player_progressivethrust:
 		lua_pushboolean(L, plr->progressivethrust);
-	else if (fastcmp(field,"ringvisualwarning"))
+		break;
+	case player_ringvisualwarning:
 		lua_pushboolean(L, plr->ringvisualwarning);
-	else if (fastcmp(field,"dotrickfx"))
+		break;
+	case player_dotrickfx:
 		lua_pushboolean(L, plr->dotrickfx);
-	else if (fastcmp(field,"stingfx"))
+		break;
+	case player_stingfx:
 		lua_pushboolean(L, plr->stingfx);
-	else if (fastcmp(field,"bumperinflate"))
+		break;
+	case player_bumperinflate:
 		lua_pushboolean(L, plr->bumperinflate);
-	else if (fastcmp(field,"ringboxdelay"))
+		break;
+	case player_ringboxdelay:
 		lua_pushinteger(L, plr->ringboxdelay);
-	else if (fastcmp(field,"ringboxaward"))
+		break;
+	case player_ringboxaward:
 		lua_pushinteger(L, plr->ringboxaward);
-	else if (fastcmp(field,"itemflags"))
+		break;
+	case player_itemflags:
 		lua_pushinteger(L, plr->itemflags);
-	else if (fastcmp(field,"drift"))
+		break;
+	case player_drift:
 		lua_pushinteger(L, plr->drift);
-	else if (fastcmp(field,"driftcharge"))
+		break;
+	case player_driftcharge:
 		lua_pushinteger(L, plr->driftcharge);
-	else if (fastcmp(field,"driftboost"))
+		break;
+	case player_driftboost:
 		lua_pushinteger(L, plr->driftboost);
-	else if (fastcmp(field,"strongdriftboost"))
+		break;
+	case player_strongdriftboost:
 		lua_pushinteger(L, plr->strongdriftboost);
-	else if (fastcmp(field,"gateboost"))
+		break;
+	case player_gateboost:
 		lua_pushinteger(L, plr->gateBoost);
-	else if (fastcmp(field,"gatesound"))
+		break;
+	case player_gatesound:
 		lua_pushinteger(L, plr->gateSound);
-	else if (fastcmp(field,"aizdriftstraft"))
+		break;
+	case player_aizdriftstraft:
 		lua_pushinteger(L, plr->aizdriftstrat);
-	else if (fastcmp(field,"aizdriftextend"))
+		break;
+	case player_aizdriftextend:
 		lua_pushinteger(L, plr->aizdriftextend);
-	else if (fastcmp(field,"aizdrifttilt"))
+		break;
+	case player_aizdrifttilt:
 		lua_pushinteger(L, plr->aizdrifttilt);
-	else if (fastcmp(field,"aizdriftturn"))
+		break;
+	case player_aizdriftturn:
 		lua_pushinteger(L, plr->aizdriftturn);
-	else if (fastcmp(field,"offroad"))
+		break;
+	case player_offroad:
 		lua_pushinteger(L, plr->offroad);
-	else if (fastcmp(field,"tiregrease"))
+		break;
+	case player_tiregrease:
 		lua_pushinteger(L, plr->tiregrease);
-	else if (fastcmp(field,"springstars"))
+		break;
+	case player_springstars:
 		lua_pushinteger(L, plr->springstars);
-	else if (fastcmp(field,"springcolor"))
+		break;
+	case player_springcolor:
 		lua_pushinteger(L, plr->springcolor);
-	else if (fastcmp(field,"dashpadcooldown"))
+		break;
+	case player_dashpadcooldown:
 		lua_pushinteger(L, plr->dashpadcooldown);
-	else if (fastcmp(field,"spindash"))
+		break;
+	case player_spindash:
 		lua_pushinteger(L, plr->spindash);
-	else if (fastcmp(field,"spindashspeed"))
+		break;
+	case player_spindashspeed:
 		lua_pushinteger(L, plr->spindashspeed);
-	else if (fastcmp(field,"spindashboost"))
+		break;
+	case player_spindashboost:
 		lua_pushinteger(L, plr->spindashboost);
-	else if (fastcmp(field,"fastfall"))
+		break;
+	case player_fastfall:
 		lua_pushfixed(L, plr->fastfall);
-	else if (fastcmp(field,"fastfallbase"))
+		break;
+	case player_fastfallbase:
 		lua_pushfixed(L, plr->fastfallBase);
-	else if (fastcmp(field,"numboosts"))
+		break;
+	case player_numboosts:
 		lua_pushinteger(L, plr->numboosts);
-	else if (fastcmp(field,"boostpower"))
+		break;
+	case player_boostpower:
 		lua_pushinteger(L, plr->boostpower);
-	else if (fastcmp(field,"speedboost"))
+		break;
+	case player_speedboost:
 		lua_pushinteger(L, plr->speedboost);
-	else if (fastcmp(field,"accelboost"))
+		break;
+	case player_accelboost:
 		lua_pushinteger(L, plr->accelboost);
-	else if (fastcmp(field,"handleboost"))
+		break;
+	case player_handleboost:
 		lua_pushinteger(L, plr->handleboost);
-	else if (fastcmp(field,"boostangle"))
+		break;
+	case player_boostangle:
 		lua_pushangle(L, plr->boostangle);
-	else if (fastcmp(field,"draftpower"))
+		break;
+	case player_draftpower:
 		lua_pushinteger(L, plr->draftpower);
-	else if (fastcmp(field,"draftleeway"))
+		break;
+	case player_draftleeway:
 		lua_pushinteger(L, plr->draftleeway);
-	else if (fastcmp(field,"lastdraft"))
+		break;
+	case player_lastdraft:
 		lua_pushinteger(L, plr->lastdraft);
-	else if (fastcmp(field,"tripwirestate"))
+		break;
+	case player_tripwirestate:
 		lua_pushinteger(L, plr->tripwireState);
-	else if (fastcmp(field,"tripwirepass"))
+		break;
+	case player_tripwirepass:
 		lua_pushinteger(L, plr->tripwirePass);
-	else if (fastcmp(field,"fakeboost"))
+		break;
+	case player_fakeboost:
 		lua_pushinteger(L, plr->fakeBoost);
-	else if (fastcmp(field,"tripwireleniency"))
+		break;
+	case player_tripwireleniency:
 		lua_pushinteger(L, plr->tripwireLeniency);
-	else if (fastcmp(field,"tripwirerebounddelay"))
+		break;
+	case player_tripwirerebounddelay:
 		lua_pushinteger(L, plr->tripwireReboundDelay);
-	else if (fastcmp(field,"eggmantransferdelay"))
+		break;
+	case player_eggmantransferdelay:
 		lua_pushinteger(L, plr->eggmanTransferDelay);
-	else if (fastcmp(field,"wavedash"))
+		break;
+	case player_wavedash:
 		lua_pushinteger(L, plr->wavedash);
-	else if (fastcmp(field,"wavedashdelay"))
+		break;
+	case player_wavedashdelay:
 		lua_pushinteger(L, plr->wavedashdelay);
-	else if (fastcmp(field,"wavedashboost"))
+		break;
+	case player_wavedashboost:
 		lua_pushinteger(L, plr->wavedashboost);
-	else if (fastcmp(field,"wavedashpower"))
+		break;
+	case player_wavedashpower:
 		lua_pushinteger(L, plr->wavedashpower);
-	else if (fastcmp(field,"speedpunt"))
+		break;
+	case player_speedpunt:
 		lua_pushinteger(L, plr->speedpunt);
-	else if (fastcmp(field,"trickcharge"))
+		break;
+	case player_trickcharge:
 		lua_pushinteger(L, plr->trickcharge);
-	else if (fastcmp(field,"infinitether"))
+		break;
+	case player_infinitether:
 		lua_pushinteger(L, plr->infinitether);
-	else if (fastcmp(field,"finalfailsafe"))
+		break;
+	case player_finalfailsafe:
 		lua_pushinteger(L, plr->finalfailsafe);
-	else if (fastcmp(field,"lastsafelap"))
+		break;
+	case player_lastsafelap:
 		lua_pushinteger(L, plr->lastsafelap);
-	else if (fastcmp(field,"lastsafecheatcheck"))
+		break;
+	case player_lastsafecheatcheck:
 		lua_pushinteger(L, plr->lastsafecheatcheck);
-	else if (fastcmp(field,"ignoreairtimeleniency"))
+		break;
+	case player_ignoreairtimeleniency:
 		lua_pushinteger(L, plr->ignoreAirtimeLeniency);
-	else if (fastcmp(field,"topaccel"))
+		break;
+	case player_topaccel:
 		lua_pushinteger(L, plr->topAccel);
-	else if (fastcmp(field,"instawhipcharge"))
+		break;
+	case player_instawhipcharge:
 		lua_pushinteger(L, plr->instaWhipCharge);
-	else if (fastcmp(field,"pitblame"))
+		break;
+	case player_pitblame:
 		lua_pushinteger(L, plr->pitblame);
-	else if (fastcmp(field,"defenselockout"))
+		break;
+	case player_defenselockout:
 		lua_pushinteger(L, plr->defenseLockout);
-	else if (fastcmp(field,"oldguard"))
+		break;
+	case player_oldguard:
 		lua_pushinteger(L, plr->oldGuard);
-	else if (fastcmp(field,"preventfailsafe"))
+		break;
+	case player_preventfailsafe:
 		lua_pushinteger(L, plr->preventfailsafe);
-	else if (fastcmp(field,"tripwireunstuck"))
+		break;
+	case player_tripwireunstuck:
 		lua_pushinteger(L, plr->tripwireUnstuck);
+		break;
 	/*
-	else if (fastcmp(field,"itemroulette"))
+	case player_itemroulette:
 		lua_pushinteger(L, plr->itemroulette);
+		break;
 	*/
-	else if (fastcmp(field,"itemtype"))
+	case player_itemtype:
 		lua_pushinteger(L, plr->itemtype);
-	else if (fastcmp(field,"itemamount"))
+		break;
+	case player_itemamount:
 		lua_pushinteger(L, plr->itemamount);
-	else if (fastcmp(field,"throwdir"))
+		break;
+	case player_throwdir:
 		lua_pushinteger(L, plr->throwdir);
-	else if (fastcmp(field,"sadtimer"))
+		break;
+	case player_sadtimer:
 		lua_pushinteger(L, plr->sadtimer);
-	else if (fastcmp(field,"rings"))
+		break;
+	case player_rings:
 		lua_pushinteger(L, plr->rings);
-	else if (fastcmp(field,"pickuprings"))
+		break;
+	case player_pickuprings:
 		lua_pushinteger(L, plr->pickuprings);
-	else if (fastcmp(field,"ringdelay"))
+		break;
+	case player_ringdelay:
 		lua_pushinteger(L, plr->ringdelay);
-	else if (fastcmp(field,"ringboost"))
+		break;
+	case player_ringboost:
 		lua_pushinteger(L, plr->ringboost);
-	else if (fastcmp(field,"sparkleanim"))
+		break;
+	case player_sparkleanim:
 		lua_pushinteger(L, plr->sparkleanim);
-	else if (fastcmp(field,"superring"))
+		break;
+	case player_superring:
 		lua_pushinteger(L, plr->superring);
-	else if (fastcmp(field,"nextringaward"))
+		break;
+	case player_nextringaward:
 		lua_pushinteger(L, plr->nextringaward);
-	else if (fastcmp(field,"ringvolume"))
+		break;
+	case player_ringvolume:
 		lua_pushinteger(L, plr->ringvolume);
-	else if (fastcmp(field,"ringtransparency"))
+		break;
+	case player_ringtransparency:
 		lua_pushinteger(L, plr->ringtransparency);
-	else if (fastcmp(field,"ringburst"))
+		break;
+	case player_ringburst:
 		lua_pushinteger(L, plr->ringburst);
-	else if (fastcmp(field,"curshield"))
+		break;
+	case player_curshield:
 		lua_pushinteger(L, plr->curshield);
-	else if (fastcmp(field,"bubblecool"))
+		break;
+	case player_bubblecool:
 		lua_pushinteger(L, plr->bubblecool);
-	else if (fastcmp(field,"bubbleblowup"))
+		break;
+	case player_bubbleblowup:
 		lua_pushinteger(L, plr->bubbleblowup);
-	else if (fastcmp(field,"flamedash"))
+		break;
+	case player_flamedash:
 		lua_pushinteger(L, plr->flamedash);
-	else if (fastcmp(field,"counterdash"))
+		break;
+	case player_counterdash:
 		lua_pushinteger(L, plr->counterdash);
-	else if (fastcmp(field,"flamemeter"))
+		break;
+	case player_flamemeter:
 		lua_pushinteger(L, plr->flamemeter);
-	else if (fastcmp(field,"flamelength"))
+		break;
+	case player_flamelength:
 		lua_pushinteger(L, plr->flamelength);
-	else if (fastcmp(field,"ballhogcharge"))
+		break;
+	case player_ballhogcharge:
 		lua_pushinteger(L, plr->ballhogcharge);
-	else if (fastcmp(field,"ballhogtap"))
+		break;
+	case player_ballhogtap:
 		lua_pushinteger(L, plr->ballhogtap);
-	else if (fastcmp(field,"hyudorotimer"))
+		break;
+	case player_hyudorotimer:
 		lua_pushinteger(L, plr->hyudorotimer);
-	else if (fastcmp(field,"stealingtimer"))
+		break;
+	case player_stealingtimer:
 		lua_pushinteger(L, plr->stealingtimer);
-	else if (fastcmp(field,"sneakertimer"))
+		break;
+	case player_sneakertimer:
 		lua_pushinteger(L, plr->sneakertimer);
-	else if (fastcmp(field,"numsneakers"))
+		break;
+	case player_numsneakers:
 		lua_pushinteger(L, plr->numsneakers);
-	else if (fastcmp(field,"floorboost"))
+		break;
+	case player_floorboost:
 		lua_pushinteger(L, plr->floorboost);
-	else if (fastcmp(field,"growshrinktimer"))
+		break;
+	case player_growshrinktimer:
 		lua_pushinteger(L, plr->growshrinktimer);
-	else if (fastcmp(field,"rocketsneakertimer"))
+		break;
+	case player_rocketsneakertimer:
 		lua_pushinteger(L, plr->rocketsneakertimer);
-	else if (fastcmp(field,"invincibilitytimer"))
+		break;
+	case player_invincibilitytimer:
 		lua_pushinteger(L, plr->invincibilitytimer);
-	else if (fastcmp(field,"invincibilityextensions"))
+		break;
+	case player_invincibilityextensions:
 		lua_pushinteger(L, plr->invincibilityextensions);
-	else if (fastcmp(field,"eggmanexplode"))
+		break;
+	case player_eggmanexplode:
 		lua_pushinteger(L, plr->eggmanexplode);
-	else if (fastcmp(field,"eggmanblame"))
+		break;
+	case player_eggmanblame:
 		lua_pushinteger(L, plr->eggmanblame);
-	else if (fastcmp(field,"bananadrag"))
+		break;
+	case player_bananadrag:
 		lua_pushinteger(L, plr->bananadrag);
-	else if (fastcmp(field,"lastjawztarget"))
+		break;
+	case player_lastjawztarget:
 		lua_pushinteger(L, plr->lastjawztarget);
-	else if (fastcmp(field,"jawztargetdelay"))
+		break;
+	case player_jawztargetdelay:
 		lua_pushinteger(L, plr->jawztargetdelay);
-	else if (fastcmp(field,"confirmvictim"))
+		break;
+	case player_confirmvictim:
 		lua_pushinteger(L, plr->confirmVictim);
-	else if (fastcmp(field,"confirmvictimdelay"))
+		break;
+	case player_confirmvictimdelay:
 		lua_pushinteger(L, plr->confirmVictimDelay);
-	else if (fastcmp(field,"glancedir"))
+		break;
+	case player_glancedir:
 		lua_pushinteger(L, plr->glanceDir);
-	else if (fastcmp(field,"trickpanel"))
+		break;
+	case player_trickpanel:
 		lua_pushinteger(L, plr->trickpanel);
-	else if (fastcmp(field,"tricktime"))
+		break;
+	case player_tricktime:
 		lua_pushinteger(L, plr->tricktime);
-	else if (fastcmp(field,"trickboostpower"))
+		break;
+	case player_trickboostpower:
 		lua_pushfixed(L, plr->trickboostpower);
-	else if (fastcmp(field,"trickboostdecay"))
+		break;
+	case player_trickboostdecay:
 		lua_pushinteger(L, plr->trickboostdecay);
-	else if (fastcmp(field,"trickboost"))
+		break;
+	case player_trickboost:
 		lua_pushinteger(L, plr->trickboost);
-	else if (fastcmp(field,"tricklock"))
+		break;
+	case player_tricklock:
 		lua_pushinteger(L, plr->tricklock);
-	else if (fastcmp(field,"dashringpulltics"))
+		break;
+	case player_dashringpulltics:
 		lua_pushinteger(L, plr->dashRingPullTics);
-	else if (fastcmp(field,"dashringpushtics"))
+		break;
+	case player_dashringpushtics:
 		lua_pushinteger(L, plr->dashRingPushTics);
-	else if (fastcmp(field,"roundscore"))
+		break;
+	case player_roundscore:
 		lua_pushinteger(L, plr->roundscore);
-	else if (fastcmp(field,"emeralds"))
+		break;
+	case player_emeralds:
 		lua_pushinteger(L, plr->emeralds);
-	else if (fastcmp(field,"karmadelay"))
+		break;
+	case player_karmadelay:
 		lua_pushinteger(L, plr->karmadelay);
-	else if (fastcmp(field,"spheres"))
+		break;
+	case player_spheres:
 		lua_pushinteger(L, plr->spheres);
-	else if (fastcmp(field,"spheredigestion"))
+		break;
+	case player_spheredigestion:
 		lua_pushinteger(L, plr->spheredigestion);
-	else if (fastcmp(field,"pflags"))
+		break;
+	case player_pflags:
 		lua_pushinteger(L, plr->pflags);
-	else if (fastcmp(field,"panim"))
+		break;
+	case player_panim:
 		lua_pushinteger(L, plr->panim);
-	else if (fastcmp(field,"flashcount"))
+		break;
+	case player_flashcount:
 		lua_pushinteger(L, plr->flashcount);
-	else if (fastcmp(field,"flashpal"))
+		break;
+	case player_flashpal:
 		lua_pushinteger(L, plr->flashpal);
-	else if (fastcmp(field,"skincolor"))
+		break;
+	case player_skincolor:
 		lua_pushinteger(L, plr->skincolor);
-	else if (fastcmp(field,"skin"))
+		break;
+	case player_skin:
 		lua_pushinteger(L, plr->skin);
-	else if (fastcmp(field,"fakeskin"))
+		break;
+	case player_fakeskin:
 		lua_pushinteger(L, plr->fakeskin);
-	else if (fastcmp(field,"lastfakeskin"))
+		break;
+	case player_lastfakeskin:
 		lua_pushinteger(L, plr->lastfakeskin);
-	else if (fastcmp(field,"score"))
+		break;
+	case player_score:
 		lua_pushinteger(L, plr->score);
+		break;
 	// SRB2kart
-	else if (fastcmp(field,"kartspeed"))
+	case player_kartspeed:
 		lua_pushinteger(L, plr->kartspeed);
-	else if (fastcmp(field,"kartweight"))
+		break;
+	case player_kartweight:
 		lua_pushinteger(L, plr->kartweight);
-	else if (fastcmp(field,"followerskin"))
+		break;
+	case player_followerskin:
 		lua_pushinteger(L, plr->followerskin);
-	else if (fastcmp(field,"followerready"))
+		break;
+	case player_followerready:
 		lua_pushboolean(L, plr->followerready);
-	else if (fastcmp(field,"followercolor"))
+		break;
+	case player_followercolor:
 		lua_pushinteger(L, plr->followercolor);
-	else if (fastcmp(field,"follower"))
+		break;
+	case player_follower:
 		LUA_PushUserdata(L, plr->follower, META_MOBJ);
+		break;
 	//
 
 	// rideroids
-	else if (fastcmp(field,"rideroid"))
+	case player_rideroid:
 		lua_pushboolean(L, plr->rideroid);
-	else if (fastcmp(field,"rdnodepull"))
+		break;
+	case player_rdnodepull:
 		lua_pushboolean(L, plr->rdnodepull);
-	else if (fastcmp(field,"rideroidangle"))
+		break;
+	case player_rideroidangle:
 		lua_pushinteger(L, plr->rideroidangle);
-	else if (fastcmp(field,"rideroidspeed"))
+		break;
+	case player_rideroidspeed:
 		lua_pushinteger(L, plr->rideroidspeed);
-	else if (fastcmp(field,"rideroidrollangle"))
+		break;
+	case player_rideroidrollangle:
 		lua_pushinteger(L, plr->rideroidrollangle);
-	else if (fastcmp(field,"rdaddmomx"))
+		break;
+	case player_rdaddmomx:
 		lua_pushinteger(L, plr->rdaddmomx);
-	else if (fastcmp(field,"rdaddmomy"))
+		break;
+	case player_rdaddmomy:
 		lua_pushinteger(L, plr->rdaddmomy);
-	else if (fastcmp(field,"rdaddmomz"))
+		break;
+	case player_rdaddmomz:
 		lua_pushinteger(L, plr->rdaddmomz);
+		break;
 
 	// bungee
-	else if (fastcmp(field,"bungee"))
+	case player_bungee:
 		lua_pushinteger(L, plr->bungee);
+		break;
 
 	// dlz hover
-	else if (fastcmp(field,"lasthover"))
+	case player_lasthover:
 		lua_pushinteger(L, plr->lasthover);
+		break;
 
 	// dlz rocket
-	else if (fastcmp(field,"dlzrocket"))
+	case player_dlzrocket:
 		lua_pushinteger(L, plr->dlzrocket);
-	else if (fastcmp(field,"dlzrocketangle"))
+		break;
+	case player_dlzrocketangle:
 		lua_pushinteger(L, plr->dlzrocketangle);
-	else if (fastcmp(field,"dlzrocketanglev"))
+		break;
+	case player_dlzrocketanglev:
 		lua_pushinteger(L, plr->dlzrocketanglev);
-	else if (fastcmp(field,"dlzrocketspd"))
+		break;
+	case player_dlzrocketspd:
 		lua_pushinteger(L, plr->dlzrocketspd);
+		break;
 
 	// seasaws
-	else if (fastcmp(field,"seasaw"))
+	case player_seasaw:
 		lua_pushboolean(L, plr->seasaw);
-	else if (fastcmp(field,"seasawcooldown"))
+		break;
+	case player_seasawcooldown:
 		lua_pushinteger(L, plr->seasawcooldown);
-	else if (fastcmp(field,"seasawdist"))
+		break;
+	case player_seasawdist:
 		lua_pushinteger(L, plr->seasawdist);
-	else if (fastcmp(field,"seasawangle"))
+		break;
+	case player_seasawangle:
 		lua_pushinteger(L, plr->seasawangle);
-	else if (fastcmp(field,"seasawangleadd"))
+		break;
+	case player_seasawangleadd:
 		lua_pushinteger(L, plr->seasawangleadd);
-	else if (fastcmp(field,"seasawmoreangle"))
+		break;
+	case player_seasawmoreangle:
 		lua_pushinteger(L, plr->seasawmoreangle);
-	else if (fastcmp(field,"seasawdir"))
+		break;
+	case player_seasawdir:
 		lua_pushboolean(L, plr->seasawdir);
+		break;
 
 	// turbine
-	else if (fastcmp(field,"turbine"))
+	case player_turbine:
 		lua_pushinteger(L, plr->turbine);
-	else if (fastcmp(field,"turbineangle"))
+		break;
+	case player_turbineangle:
 		lua_pushinteger(L, plr->turbineangle);
-	else if (fastcmp(field,"turbineheight"))
+		break;
+	case player_turbineheight:
 		lua_pushinteger(L, plr->turbineheight);
-	else if (fastcmp(field,"turbinespd"))
+		break;
+	case player_turbinespd:
 		lua_pushinteger(L, plr->turbinespd);
+		break;
 
 	//clouds
-	else if (fastcmp(field,"cloud"))
+	case player_cloud:
 		lua_pushinteger(L, plr->cloud);
-	else if (fastcmp(field,"cloudlaunch"))
+		break;
+	case player_cloudlaunch:
 		lua_pushinteger(L, plr->cloudlaunch);
-	else if (fastcmp(field,"cloudbuf"))
+		break;
+	case player_cloudbuf:
 		lua_pushinteger(L, plr->cloudbuf);
+		break;
 
 	//tulips
-	else if (fastcmp(field,"tulip"))
+	case player_tulip:
 		lua_pushinteger(L, plr->tulip);
-	else if (fastcmp(field,"tuliplaunch"))
+		break;
+	case player_tuliplaunch:
 		lua_pushinteger(L, plr->tuliplaunch);
-	else if (fastcmp(field,"tulipbuf"))
+		break;
+	case player_tulipbuf:
 		lua_pushinteger(L, plr->tulipbuf);
+		break;
 
-	else if (fastcmp(field,"charflags"))
+	case player_charflags:
 		lua_pushinteger(L, plr->charflags);
-	else if (fastcmp(field,"followitem"))
+		break;
+	case player_followitem:
 		lua_pushinteger(L, plr->followitem);
-	else if (fastcmp(field,"followmobj"))
+		break;
+	case player_followmobj:
 		LUA_PushUserdata(L, plr->followmobj, META_MOBJ);
-	else if (fastcmp(field,"lives"))
+		break;
+	case player_lives:
 		lua_pushinteger(L, plr->lives);
-	else if (fastcmp(field,"xtralife"))
+		break;
+	case player_xtralife:
 		lua_pushinteger(L, plr->xtralife);
-	else if (fastcmp(field,"speed"))
+		break;
+	case player_speed:
 		lua_pushfixed(L, plr->speed);
-	else if (fastcmp(field,"lastspeed"))
+		break;
+	case player_lastspeed:
 		lua_pushfixed(L, plr->lastspeed);
-	else if (fastcmp(field,"deadtimer"))
+		break;
+	case player_deadtimer:
 		lua_pushinteger(L, plr->deadtimer);
-	else if (fastcmp(field,"exiting"))
+		break;
+	case player_exiting:
 		lua_pushinteger(L, plr->exiting);
-	else if (fastcmp(field,"cmomx"))
+		break;
+	case player_cmomx:
 		lua_pushfixed(L, plr->cmomx);
-	else if (fastcmp(field,"cmomy"))
+		break;
+	case player_cmomy:
 		lua_pushfixed(L, plr->cmomy);
-	else if (fastcmp(field,"rmomx"))
+		break;
+	case player_rmomx:
 		lua_pushfixed(L, plr->rmomx);
-	else if (fastcmp(field,"rmomy"))
+		break;
+	case player_rmomy:
 		lua_pushfixed(L, plr->rmomy);
-	else if (fastcmp(field,"totalring"))
+		break;
+	case player_totalring:
 		lua_pushinteger(L, plr->totalring);
-	else if (fastcmp(field,"realtime"))
+		break;
+	case player_realtime:
 		lua_pushinteger(L, plr->realtime);
-	else if (fastcmp(field,"laps"))
+		break;
+	case player_laps:
 		lua_pushinteger(L, plr->laps);
-	else if (fastcmp(field,"latestlap"))
+		break;
+	case player_latestlap:
 		lua_pushinteger(L, plr->latestlap);
-	else if (fastcmp(field,"ctfteam"))
+		break;
+	case player_ctfteam:
 		lua_pushinteger(L, plr->ctfteam);
-	else if (fastcmp(field,"checkskip"))
+		break;
+	case player_checkskip:
 		lua_pushinteger(L, plr->checkskip);
-	else if (fastcmp(field,"cheatchecknum"))
+		break;
+	case player_cheatchecknum:
 		lua_pushinteger(L, plr->cheatchecknum);
-	else if (fastcmp(field,"lastsidehit"))
+		break;
+	case player_lastsidehit:
 		lua_pushinteger(L, plr->lastsidehit);
-	else if (fastcmp(field,"lastlinehit"))
+		break;
+	case player_lastlinehit:
 		lua_pushinteger(L, plr->lastlinehit);
-	else if (fastcmp(field,"timeshit"))
+		break;
+	case player_timeshit:
 		lua_pushinteger(L, plr->timeshit);
-	else if (fastcmp(field,"timeshitprev"))
+		break;
+	case player_timeshitprev:
 		lua_pushinteger(L, plr->timeshitprev);
-	else if (fastcmp(field,"onconveyor"))
+		break;
+	case player_onconveyor:
 		lua_pushinteger(L, plr->onconveyor);
-	else if (fastcmp(field,"awayviewmobj")) // FIXME: struct
+		break;
+	case player_awayviewmobj: // FIXME: struct
 		LUA_PushUserdata(L, plr->awayview.mobj, META_MOBJ);
-	else if (fastcmp(field,"awayviewtics")) // FIXME: struct
+		break;
+	case player_awayviewtics: // FIXME: struct
 		lua_pushinteger(L, plr->awayview.tics);
+		break;
 
-	else if (fastcmp(field,"spectator"))
+	case player_spectator:
 		lua_pushboolean(L, plr->spectator);
-	else if (fastcmp(field,"bot"))
+		break;
+	case player_bot:
 		lua_pushboolean(L, plr->bot);
-	else if (fastcmp(field,"jointime"))
+		break;
+	case player_jointime:
 		lua_pushinteger(L, plr->jointime);
-	else if (fastcmp(field,"spectatorreentry"))
+		break;
+	case player_spectatorreentry:
 		lua_pushinteger(L, plr->spectatorReentry);
-	else if (fastcmp(field,"griefvalue"))
+		break;
+	case player_griefvalue:
 		lua_pushinteger(L, plr->griefValue);
-	else if (fastcmp(field,"griefstrikes"))
+		break;
+	case player_griefstrikes:
 		lua_pushinteger(L, plr->griefStrikes);
-	else if (fastcmp(field,"griefwarned"))
+		break;
+	case player_griefwarned:
 		lua_pushinteger(L, plr->griefWarned);		
-	else if (fastcmp(field,"splitscreenindex"))
+		break;
+	case player_splitscreenindex:
 		lua_pushinteger(L, plr->splitscreenindex);
+		break;
 #ifdef HWRENDER
-	else if (fastcmp(field,"fovadd"))
+	case player_fovadd:
 		lua_pushfixed(L, plr->fovadd);
+		break;
 #endif
-	else if (fastcmp(field,"ping"))
+	case player_ping:
 		lua_pushinteger(L, playerpingtable[( plr - players )]);
-	else if (fastcmp(field, "publickey"))
+		break;
+	case player_publickey:
 		lua_pushstring(L, GetPrettyRRID(plr->public_key, false));
-	else {
+		break;
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, plr);
 		lua_rawget(L, -2);
 		if (!lua_istable(L, -1)) { // no extra values table
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no extvars table or field named '%s'; returning nil.\n"), "player_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no extvars table or field named '%s'; returning nil.\n"), "player_t", lua_tostring(L, 2));
 			return 0;
 		}
-		lua_getfield(L, -1, field);
+		lua_pushvalue(L, 2); // field name
+		lua_gettable(L, -2);
 		if (lua_isnil(L, -1)) // no value for this field
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "player_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; returning nil.\n"), "player_t", lua_tostring(L, 2));
+		break;
 	}
 
 	return 1;
 }
 
-#define NOSET luaL_error(L, LUA_QL("player_t") " field " LUA_QS " should not be set directly.", field)
+#define NOSET luaL_error(L, LUA_QL("player_t") " field " LUA_QS " should not be set directly.", player_opt[field])
 static int player_set(lua_State *L)
 {
 	player_t *plr = *((player_t **)luaL_checkudata(L, 1, META_PLAYER));
-	const char *field = luaL_checkstring(L, 2);
+	enum player_e field = Lua_optoption(L, 2, -1, player_fields_ref);
 	if (!plr)
 		return LUA_ErrInvalid(L, "player_t");
 
@@ -718,28 +1448,38 @@ static int player_set(lua_State *L)
 	if (hook_cmd_running)
 		return luaL_error(L, "Do not alter player_t in CMD building code!");
 
-	if (fastcmp(field,"mo")) {
+	switch (field)
+	{
+	case player_mo:
+	{
 		mobj_t *newmo = *((mobj_t **)luaL_checkudata(L, 3, META_MOBJ));
 		plr->mo->player = NULL; // remove player pointer from old mobj
 		(newmo->player = plr)->mo = newmo; // set player pointer for new mobj, and set new mobj as the player's mobj
+		break;
 	}
-	else if (fastcmp(field,"cmd"))
+	case player_cmd:
 		return NOSET;
-	else if (fastcmp(field,"oldcmd"))
+	case player_oldcmd:
 		return NOSET;
-	else if (fastcmp(field,"respawn"))
+	case player_respawn:
 		return NOSET;
-	else if (fastcmp(field,"playerstate"))
+	case player_playerstate:
 		plr->playerstate = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"viewz"))
+		break;
+	case player_viewz:
 		plr->viewz = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"viewheight"))
+		break;
+	case player_viewheight:
 		plr->viewheight = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"viewrollangle"))
+		break;
+	case player_viewrollangle:
 		plr->viewrollangle = luaL_checkangle(L, 3);
-	else if (fastcmp(field,"tilt"))
+		break;
+	case player_tilt:
 		plr->tilt = luaL_checkangle(L, 3);
-	else if (fastcmp(field,"aiming")) {
+		break;
+	case player_aiming:
+	{
 		UINT8 i;
 		plr->aiming = luaL_checkangle(L, 3);
 		for (i = 0; i <= r_splitscreen; i++)
@@ -749,495 +1489,708 @@ static int player_set(lua_State *L)
 				localaiming[i] = plr->aiming;
 			}
 		}
+		break;
 	}
-	else if (fastcmp(field,"drawangle"))
+	case player_drawangle:
 		plr->drawangle = luaL_checkangle(L, 3);
-	else if (fastcmp(field,"pflags"))
+		break;
+	case player_pflags:
 		plr->pflags = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"panim"))
+		break;
+	case player_panim:
 		plr->panim = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flashcount"))
+		break;
+	case player_flashcount:
 		plr->flashcount = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flashpal"))
+		break;
+	case player_flashpal:
 		plr->flashpal = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"skincolor"))
+		break;
+	case player_skincolor:
 	{
 		UINT16 newcolor = luaL_checkinteger(L,3);
 		if (newcolor >= numskincolors)
 			return luaL_error(L, "player.skincolor %d out of range (0 - %d).", newcolor, numskincolors-1);
 		plr->skincolor = newcolor;
+		break;
 	}
-	else if (fastcmp(field,"skin"))
+	case player_skin:
 		return NOSET;
-	else if (fastcmp(field,"fakeskin"))
+	case player_fakeskin:
 		return NOSET;
-	else if (fastcmp(field,"lastfakeskin"))
+	case player_lastfakeskin:
 		return NOSET;
-	else if (fastcmp(field,"score"))
+	case player_score:
 		plr->score = luaL_checkinteger(L, 3);
+		break;
 	// SRB2kart
-	else if (fastcmp(field,"nocontrol"))
+	case player_nocontrol:
 		plr->nocontrol = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"carry"))
+		break;
+	case player_carry:
 		plr->carry = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dye"))
+		break;
+	case player_dye:
 		plr->dye = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"position"))
+		break;
+	case player_position:
 		plr->position = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"oldposition"))
+		break;
+	case player_oldposition:
 		plr->oldposition = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"positiondelay"))
+		break;
+	case player_positiondelay:
 		plr->positiondelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"distancetofinish"))
+		break;
+	case player_distancetofinish:
 		return NOSET;
-	else if (fastcmp(field,"distancetofinishprev"))
+	case player_distancetofinishprev:
 		return NOSET;
-	else if (fastcmp(field,"lastpickupdistance"))
+	case player_lastpickupdistance:
 		plr->airtime = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"airtime"))
+		break;
+	case player_airtime:
 		plr->airtime = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastairtime"))
+		break;
+	case player_lastairtime:
 		plr->lastairtime = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flashing"))
+		break;
+	case player_flashing:
 		plr->flashing = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spinouttimer"))
+		break;
+	case player_spinouttimer:
 		plr->spinouttimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"instashield"))
+		break;
+	case player_instashield:
 		plr->instashield = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"nullhitlag"))
+		break;
+	case player_nullhitlag:
 		plr->nullHitlag = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"wipeoutslow"))
+		break;
+	case player_wipeoutslow:
 		plr->wipeoutslow = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"justbumped"))
+		break;
+	case player_justbumped:
 		plr->justbumped = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"noebrakemagnet"))
+		break;
+	case player_noebrakemagnet:
 		plr->noEbrakeMagnet = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tumblebounces"))
+		break;
+	case player_tumblebounces:
 		plr->tumbleBounces = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tumbleheight"))
+		break;
+	case player_tumbleheight:
 		plr->tumbleHeight = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"justdi"))
+		break;
+	case player_justdi:
 		plr->justDI = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flipdi"))
+		break;
+	case player_flipdi:
 		plr->flipDI = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"incontrol"))
+		break;
+	case player_incontrol:
 		plr->incontrol = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"progressivethrust"))
+		break;
+	case player_progressivethrust:
 		plr->progressivethrust = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"ringvisualwarning"))
+		break;
+	case player_ringvisualwarning:
 		plr->ringvisualwarning = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"analoginput"))
+		break;
+	case player_analoginput:
 		plr->markedfordeath = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"markedfordeath"))
+		break;
+	case player_markedfordeath:
 		plr->markedfordeath = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"dotrickfx"))
+		break;
+	case player_dotrickfx:
 		plr->dotrickfx = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"stingfx"))
+		break;
+	case player_stingfx:
 		plr->stingfx = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"bumperinflate"))
+		break;
+	case player_bumperinflate:
 		plr->bumperinflate = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"ringboxdelay"))
+		break;
+	case player_ringboxdelay:
 		plr->ringboxdelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringboxaward"))
+		break;
+	case player_ringboxaward:
 		plr->ringboxaward = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"itemflags"))
+		break;
+	case player_itemflags:
 		plr->itemflags = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"drift"))
+		break;
+	case player_drift:
 		plr->drift = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"driftcharge"))
+		break;
+	case player_driftcharge:
 		plr->driftcharge = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"driftboost"))
+		break;
+	case player_driftboost:
 		plr->driftboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"strongdriftboost"))
+		break;
+	case player_strongdriftboost:
 		plr->strongdriftboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"gateboost"))
+		break;
+	case player_gateboost:
 		plr->gateBoost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"gatesound"))
+		break;
+	case player_gatesound:
 		plr->gateSound = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"aizdriftstraft"))
+		break;
+	case player_aizdriftstraft:
 		plr->aizdriftstrat = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"aizdrifttilt"))
+		break;
+	case player_aizdrifttilt:
 		plr->aizdrifttilt = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"aizdriftturn"))
+		break;
+	case player_aizdriftturn:
 		plr->aizdriftturn = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"offroad"))
+		break;
+	case player_offroad:
 		plr->offroad = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tiregrease"))
+		break;
+	case player_tiregrease:
 		plr->tiregrease = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"springstars"))
+		break;
+	case player_springstars:
 		plr->springstars = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"springcolor"))
+		break;
+	case player_springcolor:
 		plr->springcolor = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dashpadcooldown"))
+		break;
+	case player_dashpadcooldown:
 		plr->dashpadcooldown = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spindash"))
+		break;
+	case player_spindash:
 		plr->spindash = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spindashspeed"))
+		break;
+	case player_spindashspeed:
 		plr->spindashspeed = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spindashboost"))
+		break;
+	case player_spindashboost:
 		plr->spindashboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"fastfall"))
+		break;
+	case player_fastfall:
 		plr->fastfall = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"fastfallbase"))
+		break;
+	case player_fastfallbase:
 		plr->fastfallBase = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"numboosts"))
+		break;
+	case player_numboosts:
 		plr->numboosts = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"boostpower"))
+		break;
+	case player_boostpower:
 		plr->boostpower = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"speedboost"))
+		break;
+	case player_speedboost:
 		plr->speedboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"accelboost"))
+		break;
+	case player_accelboost:
 		plr->accelboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"handleboost"))
+		break;
+	case player_handleboost:
 		plr->handleboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"boostangle"))
+		break;
+	case player_boostangle:
 		plr->boostangle = luaL_checkangle(L, 3);
-	else if (fastcmp(field,"draftpower"))
+		break;
+	case player_draftpower:
 		plr->draftpower = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"draftleeway"))
+		break;
+	case player_draftleeway:
 		plr->draftleeway = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastdraft"))
+		break;
+	case player_lastdraft:
 		plr->lastdraft = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tripwirestate"))
+		break;
+	case player_tripwirestate:
 		plr->tripwireState = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tripwirepass"))
+		break;
+	case player_tripwirepass:
 		plr->tripwirePass = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"fakeboost"))
+		break;
+	case player_fakeboost:
 		plr->fakeBoost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tripwireleniency"))
+		break;
+	case player_tripwireleniency:
 		plr->tripwireLeniency = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tripwirerebounddelay"))
+		break;
+	case player_tripwirerebounddelay:
 		plr->tripwireReboundDelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"eggmantransferdelay"))
+		break;
+	case player_eggmantransferdelay:
 		plr->eggmanTransferDelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"wavedash"))
+		break;
+	case player_wavedash:
 		plr->wavedash = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"wavedashdelay"))
+		break;
+	case player_wavedashdelay:
 		plr->wavedashdelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"wavedashboost"))
+		break;
+	case player_wavedashboost:
 		plr->wavedashboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"wavedashpower"))
+		break;
+	case player_wavedashpower:
 		plr->wavedashpower = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"speedpunt"))
+		break;
+	case player_speedpunt:
 		plr->speedpunt = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"trickcharge"))
+		break;
+	case player_trickcharge:
 		plr->trickcharge = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"infinitether"))
+		break;
+	case player_infinitether:
 		plr->infinitether = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"finalfailsafe"))
+		break;
+	case player_finalfailsafe:
 		plr->finalfailsafe = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastsafelap"))
+		break;
+	case player_lastsafelap:
 		plr->lastsafelap = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastsafecheatcheck"))
+		break;
+	case player_lastsafecheatcheck:
 		plr->lastsafecheatcheck = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ignoreairtimeleniency"))
+		break;
+	case player_ignoreairtimeleniency:
 		plr->ignoreAirtimeLeniency = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"topaccel"))
+		break;
+	case player_topaccel:
 		plr->topAccel = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"instawhipcharge"))
+		break;
+	case player_instawhipcharge:
 		plr->instaWhipCharge = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"pitblame"))
+		break;
+	case player_pitblame:
 		plr->pitblame = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"defenselockout"))
+		break;
+	case player_defenselockout:
 		plr->defenseLockout = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"oldguard"))
+		break;
+	case player_oldguard:
 		plr->oldGuard = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"preventfailsafe"))
+		break;
+	case player_preventfailsafe:
 		plr->preventfailsafe = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tripwireunstuck"))
+		break;
+	case player_tripwireunstuck:
 		plr->tripwireUnstuck = luaL_checkinteger(L, 3);
+		break;
 	/*
-	else if (fastcmp(field,"itemroulette"))
+	case player_itemroulette:
 		plr->itemroulette = luaL_checkinteger(L, 3);
+		break;
 	*/
-	else if (fastcmp(field,"itemtype"))
+	case player_itemtype:
 		plr->itemtype = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"itemamount"))
+		break;
+	case player_itemamount:
 		plr->itemamount = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"throwdir"))
+		break;
+	case player_throwdir:
 		plr->throwdir = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"sadtimer"))
+		break;
+	case player_sadtimer:
 		plr->sadtimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"rings"))
+		break;
+	case player_rings:
 		plr->rings = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"pickuprings"))
+		break;
+	case player_pickuprings:
 		plr->pickuprings = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringdelay"))
+		break;
+	case player_ringdelay:
 		plr->ringdelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringboost"))
+		break;
+	case player_ringboost:
 		plr->ringboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"sparkleanim"))
+		break;
+	case player_sparkleanim:
 		plr->sparkleanim = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"superring"))
+		break;
+	case player_superring:
 		plr->superring = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"nextringaward"))
+		break;
+	case player_nextringaward:
 		plr->nextringaward = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringvolume"))
+		break;
+	case player_ringvolume:
 		plr->ringvolume = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringtransparency"))
+		break;
+	case player_ringtransparency:
 		plr->ringtransparency = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ringburst"))
+		break;
+	case player_ringburst:
 		plr->ringburst = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"curshield"))
+		break;
+	case player_curshield:
 		plr->curshield = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"bubblecool"))
+		break;
+	case player_bubblecool:
 		plr->bubblecool = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"bubbleblowup"))
+		break;
+	case player_bubbleblowup:
 		plr->bubbleblowup = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flamedash"))
+		break;
+	case player_flamedash:
 		plr->flamedash = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"counterdash"))
+		break;
+	case player_counterdash:
 		plr->counterdash = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flamemeter"))
+		break;
+	case player_flamemeter:
 		plr->flamemeter = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"flamelength"))
+		break;
+	case player_flamelength:
 		plr->flamelength = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ballhogcharge"))
+		break;
+	case player_ballhogcharge:
 		plr->ballhogcharge = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ballhogtap"))
+		break;
+	case player_ballhogtap:
 		plr->ballhogtap = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"hyudorotimer"))
+		break;
+	case player_hyudorotimer:
 		plr->hyudorotimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"stealingtimer"))
+		break;
+	case player_stealingtimer:
 		plr->stealingtimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"sneakertimer"))
+		break;
+	case player_sneakertimer:
 		plr->sneakertimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"numsneakers"))
+		break;
+	case player_numsneakers:
 		plr->numsneakers = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"floorboost"))
+		break;
+	case player_floorboost:
 		plr->floorboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"growshrinktimer"))
+		break;
+	case player_growshrinktimer:
 		plr->growshrinktimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"rocketsneakertimer"))
+		break;
+	case player_rocketsneakertimer:
 		plr->rocketsneakertimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"invincibilitytimer"))
+		break;
+	case player_invincibilitytimer:
 		plr->invincibilitytimer = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"invincibilityextensions"))
+		break;
+	case player_invincibilityextensions:
 		plr->invincibilityextensions = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"eggmanexplode"))
+		break;
+	case player_eggmanexplode:
 		plr->eggmanexplode = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"eggmanblame"))
+		break;
+	case player_eggmanblame:
 		plr->eggmanblame = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"bananadrag"))
+		break;
+	case player_bananadrag:
 		plr->bananadrag = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastjawztarget"))
+		break;
+	case player_lastjawztarget:
 		plr->lastjawztarget = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"jawztargetdelay"))
+		break;
+	case player_jawztargetdelay:
 		plr->jawztargetdelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"confirmvictim"))
+		break;
+	case player_confirmvictim:
 		plr->confirmVictim = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"confirmvictimdelay"))
+		break;
+	case player_confirmvictimdelay:
 		plr->confirmVictimDelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"glancedir"))
+		break;
+	case player_glancedir:
 		plr->glanceDir = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"trickpanel"))
+		break;
+	case player_trickpanel:
 		plr->trickpanel = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tricktime"))
+		break;
+	case player_tricktime:
 		plr->tricktime = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"trickboostpower"))
+		break;
+	case player_trickboostpower:
 		plr->trickboostpower = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"trickboostdecay"))
+		break;
+	case player_trickboostdecay:
 		plr->trickboostdecay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"trickboost"))
+		break;
+	case player_trickboost:
 		plr->trickboost = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tricklock"))
+		break;
+	case player_tricklock:
 		plr->tricklock = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dashringpulltics"))
+		break;
+	case player_dashringpulltics:
 		plr->dashRingPullTics = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dashringpushtics"))
+		break;
+	case player_dashringpushtics:
 		plr->dashRingPushTics = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"roundscore"))
+		break;
+	case player_roundscore:
 		plr->roundscore = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"emeralds"))
+		break;
+	case player_emeralds:
 		plr->emeralds = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"karmadelay"))
+		break;
+	case player_karmadelay:
 		plr->karmadelay = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spheres"))
+		break;
+	case player_spheres:
 		plr->spheres = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"spheredigestion"))
+		break;
+	case player_spheredigestion:
 		plr->spheredigestion = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"kartspeed"))
+		break;
+	case player_kartspeed:
 		plr->kartspeed = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"kartweight"))
+		break;
+	case player_kartweight:
 		plr->kartweight = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"followerskin"))
+		break;
+	case player_followerskin:
 		plr->followerskin = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"followercolor"))
+		break;
+	case player_followercolor:
 		plr->followercolor = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"followerready"))
+		break;
+	case player_followerready:
 		plr->followerready = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"follower"))	// it's probably best we don't allow the follower mobj to change.
+		break;
+	case player_follower:	// it's probably best we don't allow the follower mobj to change.
 		return NOSET;
 
-	// time to add to the endless elseif list!!!!
 	// rideroids
-	else if (fastcmp(field,"rideroid"))
+	case player_rideroid:
 		plr->rideroid = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"rdnodepull"))
+		break;
+	case player_rdnodepull:
 		plr->rdnodepull = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"rideroidangle"))
+		break;
+	case player_rideroidangle:
 		plr->rideroidangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"rideroidspeed"))
+		break;
+	case player_rideroidspeed:
 		plr->rideroidspeed = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"rideroidrollangle"))
+		break;
+	case player_rideroidrollangle:
 		plr->rideroidrollangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"rdaddmomx"))
+		break;
+	case player_rdaddmomx:
 		plr->rdaddmomx = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"rdaddmomy"))
+		break;
+	case player_rdaddmomy:
 		plr->rdaddmomy = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"rdaddmomz"))
+		break;
+	case player_rdaddmomz:
 		plr->rdaddmomz = luaL_checkfixed(L, 3);
+		break;
 
 	// bungee
-	else if (fastcmp(field,"bungee"))
+	case player_bungee:
 		plr->bungee = luaL_checkinteger(L, 3);
+		break;
 
 	// dlz hover
-	else if (fastcmp(field,"lasthover"))
+	case player_lasthover:
 		plr->lasthover = luaL_checkinteger(L, 3);
+		break;
 
 	// dlz rocket
-	else if (fastcmp(field,"dlzrocket"))
+	case player_dlzrocket:
 		plr->dlzrocket = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dlzrocketangle"))
+		break;
+	case player_dlzrocketangle:
 		plr->dlzrocketangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dlzrocketanglev"))
+		break;
+	case player_dlzrocketanglev:
 		plr->dlzrocketanglev = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"dlzrocketspd"))
+		break;
+	case player_dlzrocketspd:
 		plr->dlzrocketspd = luaL_checkfixed(L, 3);
+		break;
 
 	// seasaws
-	else if (fastcmp(field,"seasaw"))
+	case player_seasaw:
 		plr->seasaw = luaL_checkboolean(L, 3);
-	else if (fastcmp(field,"seasawcooldown"))
+		break;
+	case player_seasawcooldown:
 		plr->seasawcooldown = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seasawdist"))
+		break;
+	case player_seasawdist:
 		plr->seasawdist = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"seasawangle"))
+		break;
+	case player_seasawangle:
 		plr->seasawangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seasawangleadd"))
+		break;
+	case player_seasawangleadd:
 		plr->seasawangleadd = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seasawmoreangle"))
+		break;
+	case player_seasawmoreangle:
 		plr->seasawmoreangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"seasawdir"))
+		break;
+	case player_seasawdir:
 		plr->seasawdir = luaL_checkboolean(L, 3);
+		break;
 
 	// turbines
-	else if (fastcmp(field,"turbine"))
+	case player_turbine:
 		plr->turbine = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"turbineangle"))
+		break;
+	case player_turbineangle:
 		plr->turbineangle = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"turbineheight"))
+		break;
+	case player_turbineheight:
 		plr->turbineheight = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"turbinespd"))
+		break;
+	case player_turbinespd:
 		plr->turbinespd = luaL_checkinteger(L, 3);
+		break;
 
 	// clouds
-	else if (fastcmp(field,"cloud"))
+	case player_cloud:
 		plr->cloud = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"cloudlaunch"))
+		break;
+	case player_cloudlaunch:
 		plr->cloudlaunch = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"cloudbuf"))
+		break;
+	case player_cloudbuf:
 		plr->cloudbuf = luaL_checkinteger(L, 3);
+		break;
 
 	// tulips
-	else if (fastcmp(field,"tulip"))
+	case player_tulip:
 		plr->tulip = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tuliplaunch"))
+		break;
+	case player_tuliplaunch:
 		plr->tuliplaunch = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"tulipbuf"))
+		break;
+	case player_tulipbuf:
 		plr->tulipbuf = luaL_checkinteger(L, 3);
+		break;
 
 	//
-	else if (fastcmp(field,"charflags"))
+	case player_charflags:
 		plr->charflags = (UINT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"followitem"))
+		break;
+	case player_followitem:
 		plr->followitem = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"followmobj"))
+		break;
+	case player_followmobj:
 	{
 		mobj_t *mo = NULL;
 		if (!lua_isnil(L, 3))
 			mo = *((mobj_t **)luaL_checkudata(L, 3, META_MOBJ));
 		P_SetTarget(&plr->followmobj, mo);
+		break;
 	}
-	else if (fastcmp(field,"lives"))
+	case player_lives:
 		plr->lives = (SINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"xtralife"))
+		break;
+	case player_xtralife:
 		plr->xtralife = (SINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"speed"))
+		break;
+	case player_speed:
 		plr->speed = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"lastspeed"))
+		break;
+	case player_lastspeed:
 		plr->lastspeed = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"deadtimer"))
+		break;
+	case player_deadtimer:
 		plr->deadtimer = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"exiting"))
+		break;
+	case player_exiting:
 		plr->exiting = (tic_t)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"cmomx"))
+		break;
+	case player_cmomx:
 		plr->cmomx = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"cmomy"))
+		break;
+	case player_cmomy:
 		plr->cmomy = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"rmomx"))
+		break;
+	case player_rmomx:
 		plr->rmomx = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"rmomy"))
+		break;
+	case player_rmomy:
 		plr->rmomy = luaL_checkfixed(L, 3);
-	else if (fastcmp(field,"totalring"))
+		break;
+	case player_totalring:
 		plr->totalring = (INT16)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"realtime"))
+		break;
+	case player_realtime:
 		plr->realtime = (tic_t)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"laps"))
+		break;
+	case player_laps:
 		plr->laps = (UINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"latestlap"))
+		break;
+	case player_latestlap:
 		plr->latestlap = (UINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"ctfteam"))
+		break;
+	case player_ctfteam:
 		plr->ctfteam = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"checkskip"))
+		break;
+	case player_checkskip:
 		plr->checkskip = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"cheatchecknum"))
+		break;
+	case player_cheatchecknum:
 		plr->cheatchecknum = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastsidehit"))
+		break;
+	case player_lastsidehit:
 		plr->lastsidehit = (INT16)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"lastlinehit"))
+		break;
+	case player_lastlinehit:
 		plr->lastlinehit = (INT16)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"timeshit"))
+		break;
+	case player_timeshit:
 		plr->timeshit = (UINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"timeshitprev"))
+		break;
+	case player_timeshitprev:
 		plr->timeshitprev = (UINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"onconveyor"))
+		break;
+	case player_onconveyor:
 		plr->onconveyor = (INT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"awayviewmobj")) // FIXME: struct
+		break;
+	case player_awayviewmobj: // FIXME: struct
 	{
 		mobj_t *mo = NULL;
 		if (!lua_isnil(L, 3))
 			mo = *((mobj_t **)luaL_checkudata(L, 3, META_MOBJ));
 		P_SetTarget(&plr->awayview.mobj, mo);
+		break;
 	}
-	else if (fastcmp(field,"awayviewtics")) // FIXME: struct
+	case player_awayviewtics: // FIXME: struct
 	{
 		plr->awayview.tics = (INT32)luaL_checkinteger(L, 3);
 		if (plr->awayview.tics && !plr->awayview.mobj) // awayviewtics must ALWAYS have an awayviewmobj set!!
 			P_SetTarget(&plr->awayview.mobj, plr->mo); // but since the script might set awayviewmobj immediately AFTER setting awayviewtics, use player mobj as filler for now.
+		break;
 	}
-	else if (fastcmp(field,"spectator"))
+	case player_spectator:
 		plr->spectator = lua_toboolean(L, 3);
-	else if (fastcmp(field,"bot"))
+		break;
+	case player_bot:
 		return NOSET;
-	else if (fastcmp(field,"jointime"))
+	case player_jointime:
 		return NOSET;
-	else if (fastcmp(field,"spectatorreentry"))
+	case player_spectatorreentry:
 		plr->spectatorReentry = (UINT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"griefvalue"))
+		break;
+	case player_griefvalue:
 		plr->griefValue = (UINT32)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"griefstrikes"))
+		break;
+	case player_griefstrikes:
 		plr->griefStrikes = (UINT8)luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"griefwarned"))
+		break;
+	case player_griefwarned:
 		plr->griefWarned = luaL_checkinteger(L, 3);
-	else if (fastcmp(field,"splitscreenindex"))
+		break;
+	case player_splitscreenindex:
 		return NOSET;
 #ifdef HWRENDER
-	else if (fastcmp(field,"fovadd"))
+	case player_fovadd:
 		plr->fovadd = luaL_checkfixed(L, 3);
+		break;
 #endif
-	else {
+	default:
 		lua_getfield(L, LUA_REGISTRYINDEX, LREG_EXTVARS);
 		I_Assert(lua_istable(L, -1));
 		lua_pushlightuserdata(L, plr);
@@ -1245,15 +2198,17 @@ static int player_set(lua_State *L)
 		if (lua_isnil(L, -1)) {
 			// This index doesn't have a table for extra values yet, let's make one.
 			lua_pop(L, 1);
-			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; adding it as Lua data.\n"), "player_t", field);
+			CONS_Debug(DBG_LUA, M_GetText("'%s' has no field named '%s'; adding it as Lua data.\n"), "player_t", lua_tostring(L, 2));
 			lua_newtable(L);
 			lua_pushlightuserdata(L, plr);
 			lua_pushvalue(L, -2); // ext value table
 			lua_rawset(L, -4); // LREG_EXTVARS table
 		}
+		lua_pushvalue(L, 2); // field name
 		lua_pushvalue(L, 3); // value to store
-		lua_setfield(L, -2, field);
+		lua_settable(L, -3);
 		lua_pop(L, 2);
+		break;
 	}
 
 	return 0;
@@ -1443,8 +2398,77 @@ static int respawn_set(lua_State *L)
 #undef RUNIMPLEMENTED
 
 
+// luafieldbench [iterations]
+// Times player_t field lookups, going through every name like the old
+// fastcmp chain did versus hashing into the field table.
+void Command_LuaFieldBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	INT32 iterations = 1000000;
+	INT32 numfields, keys[3];
+	INT32 i, k;
+	size_t linearsum = 0, tablesum = 0;
+	precise_t start, lineartime, tabletime;
+	lua_State *L;
+	int ref;
+
+	if (COM_Argc() > 1)
+		iterations = max(1, atoi(COM_Argv(1)));
+
+	for (numfields = 0; player_opt[numfields]; numfields++)
+		;
+
+	// Best, typical and worst case for the linear search
+	keys[0] = 0;
+	keys[1] = numfields / 2;
+	keys[2] = numfields - 1;
+
+	L = lua_newstate(LUA_ZoneAlloc, NULL);
+	ref = Lua_CreateFieldTable(L, player_opt);
+
+	for (k = 0; k < 3; k++)
+		lua_pushstring(L, player_opt[keys[k]]);
+
+	start = I_GetPreciseTime();
+	for (i = 0; i < iterations; i++)
+	{
+		for (k = 1; k <= 3; k++)
+		{
+			const char *field = luaL_checkstring(L, k);
+			INT32 j;
+
+			for (j = 0; player_opt[j]; j++)
+				if (fastcmp(player_opt[j], field))
+					break;
+
+			linearsum += j;
+		}
+	}
+	lineartime = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (i = 0; i < iterations; i++)
+	{
+		for (k = 1; k <= 3; k++)
+			tablesum += Lua_optoption(L, k, -1, ref);
+	}
+	tabletime = I_GetPreciseTime() - start;
+
+	lua_close(L);
+
+	CONS_Printf("%d iterations of \"%s\", \"%s\", \"%s\" (%d fields)\n", iterations,
+		player_opt[keys[0]], player_opt[keys[1]], player_opt[keys[2]], numfields);
+	CONS_Printf("string compares: %s us\n", sizeu1((size_t)(lineartime * 1000000 / precision)));
+	CONS_Printf("field table: %s us\n", sizeu1((size_t)(tabletime * 1000000 / precision)));
+
+	if (linearsum != tablesum)
+		CONS_Alert(CONS_WARNING, "luafieldbench: lookups disagree!\n");
+}
+
 int LUA_PlayerLib(lua_State *L)
 {
+	player_fields_ref = Lua_CreateFieldTable(L, player_opt);
+
 	luaL_newmetatable(L, META_PLAYER);
 		lua_pushcfunction(L, player_get);
 		lua_setfield(L, -2, "__index");
@@ -69,6 +69,8 @@ static const char *const polyobj_opt[] = {
 
 static const char *const valid_opt[] ={"valid",NULL};
 
+static int polyobj_fields_ref = LUA_NOREF;
+
 ////////////////////////
 // polyobj.vertices[] //
 ////////////////////////
@@ -263,7 +265,7 @@ static int lib_polyobj_rotate(lua_State *L)
 static int polyobj_get(lua_State *L)
 {
 	polyobj_t *polyobj = *((polyobj_t **)luaL_checkudata(L, 1, META_POLYOBJ));
-	enum polyobj_e field = luaL_checkoption(L, 2, NULL, polyobj_opt);
+	enum polyobj_e field = Lua_checkoption(L, 2, -1, polyobj_fields_ref);
 
 	if (!polyobj) {
 		if (field == polyobj_valid) {
@@ -336,7 +338,7 @@ static int polyobj_get(lua_State *L)
 static int polyobj_set(lua_State *L)
 {
 	polyobj_t *polyobj = *((polyobj_t **)luaL_checkudata(L, 1, META_POLYOBJ));
-	enum polyobj_e field = luaL_checkoption(L, 2, NULL, polyobj_opt);
+	enum polyobj_e field = Lua_checkoption(L, 2, -1, polyobj_fields_ref);
 
 	if (!polyobj)
 		return LUA_ErrInvalid(L, "polyobj_t");
@@ -448,6 +450,8 @@ static int lib_numPolyObjects(lua_State *L)
 
 int LUA_PolyObjLib(lua_State *L)
 {
+	polyobj_fields_ref = Lua_CreateFieldTable(L, polyobj_opt);
+
 	luaL_newmetatable(L, META_POLYOBJVERTICES);
 		lua_pushcfunction(L, polyobjvertices_get);
 		lua_setfield(L, -2, "__index");
@@ -53,6 +53,7 @@ struct lua_timer_t
 	};
 
 	Stat running, avg;
+	bool hud = false;
 };
 
 namespace
@@ -62,7 +63,10 @@ std::unordered_map<std::string, lua_timer_t> g_tic_timers;
 
 }; // namespace
 
-lua_timer_t* LUA_BeginFunctionTimer(lua_State* L, int fn_idx, const char* name)
+namespace
+{
+
+lua_timer_t* begin_timer(lua_State* L, int fn_idx, const char* name, bool hud)
 {
 	lua_Debug ar;
 
@@ -91,14 +95,28 @@ lua_timer_t* LUA_BeginFunctionTimer(lua_State* L, int fn_idx, const char* name)
 		return view;
 	};
 
-	auto [it, ins] = g_tic_timers.try_emplace(fmt::format("{}:{} ({})", label(), ar.linedefined, name));
+	auto [it, ins] = g_tic_timers.try_emplace(fmt::format("{}:{} ({}{})", label(), ar.linedefined, hud ? "HUD " : "", name));
 	auto& [key, timer] = *it;
 
+	timer.hud = hud;
+
 	g_time_reference = I_GetPreciseTime();
 
 	return &timer;
 }
 
+}; // namespace
+
+lua_timer_t* LUA_BeginFunctionTimer(lua_State* L, int fn_idx, const char* name)
+{
+	return begin_timer(L, fn_idx, name, false);
+}
+
+lua_timer_t* LUA_BeginHUDTimer(lua_State* L, int fn_idx, const char* name)
+{
+	return begin_timer(L, fn_idx, name, true);
+}
+
 void LUA_EndFunctionTimer(lua_timer_t* timer)
 {
 	precise_t t = I_GetPreciseTime() - g_time_reference;
@@ -177,12 +195,13 @@ void LUA_RenderTimers(void)
 
 	{
 		double cum = 0.0;
+		double hud = 0.0;
 
 		for (auto it = g_tic_timers.begin(); it != g_tic_timers.end(); ++it)
 		{
 			auto& [key, timer] = *it;
 
-			cum += timer.avg.time;
+			(timer.hud ? hud : cum) += timer.avg.time;
 
 			if (timer.avg.time > 0.0)
 			{
@@ -200,8 +219,9 @@ void LUA_RenderTimers(void)
 			cum * TICRATE,
 			g_avg_tic_time * TICRATE
 		);
+		row.y(kRowHeight * 3).flags(color_flag(hud * 1'000'000.0)).text("{:8.2f} us - HUD", hud * 1'000'000.0);
 
-		row = row.y(kRowHeight * 4);
+		row = row.y(kRowHeight * 5);
 	}
 
 	std::sort(
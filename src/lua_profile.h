@@ -24,6 +24,10 @@ struct lua_timer_t;
 void LUA_ResetTicTimers(void);
 
 lua_timer_t *LUA_BeginFunctionTimer(lua_State *L, int fn_idx, const char *name);
+
+// Same as above, but for HUD hooks. These are listed separately and don't count
+// towards game logic overhead.
+lua_timer_t *LUA_BeginHUDTimer(lua_State *L, int fn_idx, const char *name);
 void LUA_EndFunctionTimer(lua_timer_t *timer);
 
 void LUA_RenderTimers(void);
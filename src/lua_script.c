@@ -28,6 +28,9 @@
 #include "p_local.h"
 #include "p_slopes.h" // for P_SlopeById and slopelist
 #include "p_polyobj.h" // polyobj_t, PolyObjects
+#include "lua_alloc.h"
+#include "i_system.h" // I_GetPreciseTime
+#include "m_perfstats.h"
 #ifdef LUA_ALLOW_BYTECODE
 #include "d_netfil.h" // for LUA_DumpFile
 #endif
@@ -63,16 +66,29 @@ static lua_CFunction liblist[] = {
 	NULL
 };
 
-// Lua asks for memory using this.
-static void *LUA_Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+// Incremental garbage collection is driven from LUA_Step, once per game loop,
+// instead of by allocations landing in the middle of a busy tic. Lua's own
+// collector is deferred far enough to stay out of the way unless scripts
+// allocate much faster than usual.
+#define LUAGC_PAUSE 200 // start a new cycle when the heap has grown this much, in percent
+#define LUAGC_MAXSTEPKB 1024
+#define LUAGC_MINSLACKKB 256
+
+static struct
+{
+	size_t lastheap; // heap size when the last LUA_Step returned
+	size_t allocrate; // smoothed bytes allocated between LUA_Step calls
+	size_t pausetarget; // heap size that starts the next cycle
+	precise_t steptime; // smoothed cost of one step
+	boolean cycledone; // waiting for pausetarget
+} luagc;
+
+// Lua asks for memory from this, see lua_alloc.c.
+static luaallocator_t *gLalloc = NULL;
+
+size_t LUA_MemoryUsage(void)
 {
-	(void)ud;
-	if (nsize == 0) {
-		if (osize != 0)
-			Z_Free(ptr);
-		return NULL;
-	} else
-		return Z_Realloc(ptr, nsize, PU_LUA, NULL);
+	return gLalloc ? LUA_GetAllocatorStats(gLalloc)->reserved : 0;
 }
 
 // Panic function Lua calls when there's an unprotected error.
@@ -495,10 +511,15 @@ void LUA_ClearState(void)
 		lua_close(gL);
 	gL = NULL;
 
+	// everything the old state allocated is gone, give the pages back
+	LUA_DestroyAllocator(gLalloc);
+	gLalloc = LUA_CreateAllocator();
+	memset(&luagc, 0, sizeof luagc);
+
 	CONS_Printf(M_GetText("Pardon me while I initialize the Lua scripting interface...\n"));
 
 	// allocate state
-	L = lua_newstate(LUA_Alloc, NULL);
+	L = lua_newstate(LUA_PoolAlloc, gLalloc);
 	lua_atpanic(L, LUA_Panic);
 
 	// open base libraries
@@ -694,8 +715,8 @@ fixed_t LUA_EvalMath(const char *word)
 	fixed_t res = 0;
 
 	// make a new state so SOC can't interefere with scripts
-	// allocate state
-	L = lua_newstate(LUA_Alloc, NULL);
+	// allocate state; too short-lived to be worth its own pages
+	L = lua_newstate(LUA_ZoneAlloc, NULL);
 	lua_atpanic(L, LUA_Panic);
 
 	// open only enum lib
@@ -1629,12 +1650,67 @@ static void UnArchiveTables(UINT8 **p)
 	}
 }
 
-void LUA_Step(void)
+static size_t LUA_HeapSize(void)
 {
+	return ((size_t)lua_gc(gL, LUA_GCCOUNT, 0) << 10) + lua_gc(gL, LUA_GCCOUNTB, 0);
+}
+
+// deadline is when the current frame's time budget runs out, or 0 if there is no budget.
+// At least one step sized to keep up with allocation always runs while a cycle is going,
+// anything more only runs while there is time left before the deadline.
+void LUA_Step(precise_t deadline)
+{
+	precise_t start, now;
+	size_t heap, stepkb, slackkb;
+
 	if (!gL)
 		return;
 	lua_settop(gL, 0);
-	lua_gc(gL, LUA_GCSTEP, 1);
+
+	now = start = I_GetPreciseTime();
+	heap = LUA_HeapSize();
+
+	if (heap > luagc.lastheap)
+		luagc.allocrate = (luagc.allocrate * 7 + (heap - luagc.lastheap)) / 8;
+	else
+		luagc.allocrate = (luagc.allocrate * 7) / 8;
+
+	// Collect about twice as fast as scripts allocate.
+	stepkb = min(max((luagc.allocrate * 2) >> 10, 1), LUAGC_MAXSTEPKB);
+
+	if (luagc.cycledone == false || heap >= luagc.pausetarget)
+	{
+		luagc.cycledone = false;
+
+		do
+		{
+			const precise_t stepstart = now;
+			const boolean finished = lua_gc(gL, LUA_GCSTEP, (int)stepkb);
+
+			now = I_GetPreciseTime();
+			luagc.steptime = (luagc.steptime * 3 + (now - stepstart)) / 4;
+
+			if (finished)
+			{
+				luagc.cycledone = true;
+				luagc.pausetarget = (LUA_HeapSize() / 100) * LUAGC_PAUSE;
+				break;
+			}
+		} while (now + luagc.steptime < deadline);
+	}
+
+	heap = LUA_HeapSize();
+
+	// Let Lua step on its own only well past what a normal frame allocates.
+	slackkb = max((luagc.allocrate * 8) >> 10, LUAGC_MINSLACKKB);
+	if (luagc.cycledone && luagc.pausetarget > heap)
+		slackkb += (luagc.pausetarget - heap) >> 10;
+	lua_gc(gL, LUA_GCDEFER, (int)min(slackkb, INT32_MAX >> 10));
+
+	luagc.lastheap = heap;
+
+	ps_lua_gc_time = now - start;
+	ps_lua_heap_kb = (int)(heap >> 10);
 }
 
 void LUA_Archive(savebuffer_t *save, boolean network)
@@ -1718,16 +1794,58 @@ void LUA_UnArchive(savebuffer_t *save, boolean network)
 		lua_pop(gL, 1); // pop tables
 }
 
-// For mobj_t, player_t, etc. to take custom variables.
-int Lua_optoption(lua_State *L, int narg,
-	const char *def, const char *const lst[])
+// Builds a name -> index table out of a userdata's field list, so
+// lookups hash the interned key instead of comparing every name.
+// Returns a registry reference for Lua_optoption.
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[])
 {
-	const char *name = (def) ? luaL_optstring(L, narg, def) :  luaL_checkstring(L, narg);
 	int i;
-	for (i=0; lst[i]; i++)
-		if (fastcmp(lst[i], name))
-			return i;
-	return -1;
+
+	lua_newtable(L);
+	for (i = 0; lst[i] != NULL; i++)
+	{
+		lua_pushstring(L, lst[i]);
+		lua_pushinteger(L, i);
+		lua_settable(L, -3);
+	}
+
+	return luaL_ref(L, LUA_REGISTRYINDEX);
+}
+
+// For mobj_t, player_t, etc. to take custom variables.
+// Returns def for a missing key (or errors, if def is -1), and -1
+// for a name that isn't in the table.
+int Lua_optoption(lua_State *L, int narg, int def, int list_ref)
+{
+	int result = -1;
+
+	if (def != -1 && lua_isnoneornil(L, narg))
+		return def;
+
+	// Also turns numbers into strings, like luaL_checkoption
+	luaL_checkstring(L, narg);
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, list_ref);
+	I_Assert(lua_istable(L, -1));
+	lua_pushvalue(L, narg);
+	lua_rawget(L, -2);
+
+	if (lua_isnumber(L, -1))
+		result = lua_tointeger(L, -1);
+
+	lua_pop(L, 2);
+	return result;
+}
+
+// Like luaL_checkoption, for fields without custom variables.
+int Lua_checkoption(lua_State *L, int narg, int def, int list_ref)
+{
+	int result = Lua_optoption(L, narg, def, list_ref);
+
+	if (result == -1)
+		return luaL_argerror(L, narg, lua_pushfstring(L, "invalid option " LUA_QS, lua_tostring(L, narg)));
+
+	return result;
 }
 
 void LUA_PushTaggableObjectArray
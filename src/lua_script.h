@@ -47,6 +47,7 @@ void LUA_ClearExtVars(void);
 #endif
 
 void LUA_ClearState(void);
+size_t LUA_MemoryUsage(void); // bytes held by the Lua state's allocator
 
 extern INT32 lua_lumploading; // is LUA_LoadLump being called?
 
@@ -57,7 +58,7 @@ void LUA_LoadLump(UINT16 wad, UINT16 lump, boolean noresults);
 void LUA_DumpFile(const char *filename);
 #endif
 fixed_t LUA_EvalMath(const char *word);
-void LUA_Step(void);
+void LUA_Step(precise_t deadline);
 void LUA_Archive(savebuffer_t *save, boolean network);
 void LUA_UnArchive(savebuffer_t *save, boolean network);
 
@@ -66,8 +67,10 @@ int LUA_WriteGlobals(lua_State *L, const char *word);
 
 void Got_Luacmd(const UINT8 **cp, INT32 playernum); // lua_consolelib.c
 void LUA_CVarChanged(void *cvar); // lua_consolelib.c
-int Lua_optoption(lua_State *L, int narg,
-	const char *def, const char *const lst[]);
+int Lua_CreateFieldTable(lua_State *L, const char *const lst[]);
+int Lua_optoption(lua_State *L, int narg, int def, int list_ref);
+int Lua_checkoption(lua_State *L, int narg, int def, int list_ref);
+void Command_LuaFieldBench_f(void); // lua_playerlib.c
 void LUA_HookNetArchive(lua_CFunction archFunc, savebuffer_t *save);
 
 void LUA_PushTaggableObjectArray
@@ -33,6 +33,8 @@
 #include "k_podium.h"
 #include "k_pwrlv.h"
 #include "k_profiles.h"
+#include "command.h" // COM_Argv
+#include "i_system.h" // I_GetPreciseTime
 
 gamedata_t *gamedata = NULL;
 boolean netUnlocked[MAXUNLOCKABLES];
@@ -40,6 +42,16 @@ boolean netUnlocked[MAXUNLOCKABLES];
 // The meat of this system lies in condition sets
 conditionset_t conditionSets[MAXCONDITIONSETS];
 
+// The condition sets not achieved yet, in order: those that could pass
+// without a player, and those that could pass with one, with what each of
+// the latter depends on. Rebuilt after the condition sets change.
+static UINT16 gamedataconditionsets[MAXCONDITIONSETS];
+static UINT16 numgamedataconditionsets;
+static UINT16 playerconditionsets[MAXCONDITIONSETS];
+static UINT16 numplayerconditionsets;
+static UINT32 conditionsetdeps[MAXCONDITIONSETS];
+static boolean conditionindexdirty = true;
+
 // Emblem locations
 emblem_t emblemlocations[MAXEMBLEMS];
 
@@ -615,6 +627,8 @@ void M_AddRawCondition(UINT16 set, UINT8 id, conditiontype_t c, INT32 r, INT16 x
 	cond[wnum].extrainfo1 = x1;
 	cond[wnum].extrainfo2 = x2;
 	cond[wnum].stringvar = stringvar;
+
+	conditionindexdirty = true;
 }
 
 void M_ClearConditionSet(UINT16 set)
@@ -631,6 +645,14 @@ void M_ClearConditionSet(UINT16 set)
 		conditionSets[set].condition = NULL;
 	}
 	gamedata->achieved[set] = false;
+
+	conditionindexdirty = true;
+}
+
+// Call after un-achieving a condition set, so it's checked again.
+void M_ResetConditionIndex(void)
+{
+	conditionindexdirty = true;
 }
 
 // Clear ALL secrets.
@@ -723,6 +745,7 @@ void M_ClearSecrets(void)
 	memset(gamedata->unlockpending, 0, sizeof(gamedata->unlockpending));
 	memset(netUnlocked, 0, sizeof(netUnlocked));
 	memset(gamedata->achieved, 0, sizeof(gamedata->achieved));
+	conditionindexdirty = true;
 
 	Z_Free(gamedata->spraycans);
 	gamedata->spraycans = NULL;
@@ -1337,6 +1360,8 @@ void M_UpdateConditionSetsPending(void)
 	conditionset_t *c;
 	condition_t *cn;
 
+	conditionindexdirty = true;
+
 	for (i = 0; i < MAXCONDITIONSETS; ++i)
 	{
 		c = &conditionSets[i];
@@ -3102,30 +3127,206 @@ char *M_BuildConditionSetString(UINT16 unlockid)
 	);
 }
 
-static boolean M_CheckUnlockConditions(player_t *player)
+// Can't change once the round has started
+static boolean M_IsRoundConstant(conditiontype_t type)
 {
-	UINT32 i;
+	switch (type)
+	{
+		case UCRP_PREFIX_GRANDPRIX:
+		case UCRP_PREFIX_BONUSROUND:
+		case UCRP_PREFIX_TIMEATTACK:
+		case UCRP_PREFIX_PRISONBREAK:
+		case UCRP_PREFIX_SEALEDSTAR:
+		case UCRP_PREFIX_ISMAP:
+		case UCRP_ISMAP:
+		case UCRP_ISCHARACTER: // only ever turns false, by switching skin
+		case UCRP_ISENGINECLASS:
+		case UCRP_ISDIFFICULTY:
+		case UCRP_ISGEAR:
+		case UCRP_PODIUMCUP:
+		case UCRP_PODIUMEMERALD:
+		case UCRP_PODIUMPRIZE:
+		case UCRP_PODIUMNOCONTINUES:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// What a round condition waits on, as roundconditions.checkthisframe
+// reports it. Anything that can become true without one of those being
+// raised has to be UCD_ANY. Round constants are left to the caller.
+static UINT32 M_ConditionDependencies(condition_t *cn)
+{
+	switch (cn->type)
+	{
+		case UCRP_FINISHCOOL:
+		case UCRP_FINISHPERFECT:
+		case UCRP_SURVIVE:
+		case UCRP_NOCONTEST:
+		case UCRP_FINISHPLACE:
+		case UCRP_FINISHPLACEEXACT:
+		case UCRP_FINISHGRADE:
+		case UCRP_FINISHTIME:
+		case UCRP_FINISHTIMEEXACT:
+		case UCRP_FINISHTIMELEFT:
+			return UCD_FINISH;
+
+		// Either it happened, or the round ended without it
+		case UCRP_FALLOFF:
+			return (cn->requirement == 1) ? UCD_FELLOFF : UCD_FINISH;
+		case UCRP_TOUCHOFFROAD:
+			return (cn->requirement == 1) ? UCD_OFFROAD : UCD_FINISH;
+		case UCRP_TOUCHSNEAKERPANEL:
+			return (cn->requirement == 1) ? UCD_SNEAKERPANEL : UCD_FINISH;
+		case UCRP_RINGDEBT:
+			return (cn->requirement == 1) ? UCD_RINGDEBT : UCD_FINISH;
+		case UCRP_FAULTED:
+			return (cn->requirement == 1) ? UCD_FAULTED : UCD_ANY; // not faulting passes on a lap change
+
+		case UCRP_TRIPWIREHYUU:
+		case UCRP_WHIPHYUU:
+			return UCD_HYUU;
+		case UCRP_SPBNEUTER:
+			return UCD_SPBNEUTER;
+		case UCRP_LANDMINEDUNK:
+			return UCD_LANDMINEDUNK;
+		case UCRP_HITMIDAIR:
+			return UCD_HITMIDAIR;
+		case UCRP_HITDRAFTERLOOKBACK:
+			return UCD_HITDRAFTERLOOKBACK;
+		case UCRP_GIANTRACERSHRUNKENORBI:
+			return UCD_SHRUNKENORBI;
+		case UCRP_RETURNMARKTOSENDER:
+			return UCD_RETURNTOSENDER;
+
+		case UCRP_TRACKHAZARD:
+			// Getting hit on a given lap. The rest also wait on lap changes.
+			if (cn->requirement == 1 && cn->extrainfo1 != -1)
+				return UCD_TRACKHAZARD;
+			return UCD_ANY;
+
+		case UCRP_TRIGGER:
+			return UCD_TRIGGER;
+
+		default:
+			return UCD_ANY;
+	}
+}
+
+static void M_BuildConditionIndex(void)
+{
+	UINT16 i;
+	UINT32 j;
 	conditionset_t *c;
-	boolean ret;
+	condition_t *cn;
+
+	numgamedataconditionsets = numplayerconditionsets = 0;
 
 	for (i = 0; i < MAXCONDITIONSETS; ++i)
 	{
+		boolean withoutplayer = false, withplayer = false;
+		UINT32 deps = 0, groupdeps = 0, groupid = 0;
+		boolean groupplayer = false;
+
 		c = &conditionSets[i];
 		if (!c->numconditions || gamedata->achieved[i])
 			continue;
 
-		if ((gamedata->achieved[i] = (M_CheckConditionSet(c, player))) != true)
+		// Conditions sharing an ID are ANDed, and each ID is an alternative.
+		// Constants ANDed with anything else can only pass when that does,
+		// but an ID made only of them needs checking once as the round starts.
+		for (j = 0; j <= c->numconditions; ++j)
+		{
+			cn = (j < c->numconditions) ? &c->condition[j] : NULL;
+
+			if (cn && (cn->type == UC_AND || cn->type == UC_THEN || cn->type == UC_COMMA || cn->type == UC_DESCRIPTIONOVERRIDE))
+				continue;
+
+			if (cn == NULL || cn->id != groupid)
+			{
+				if (groupplayer)
+					deps |= groupdeps ? groupdeps : UCD_ROUNDSTART;
+
+				if (cn == NULL)
+					break;
+
+				groupid = cn->id;
+				groupdeps = 0;
+				groupplayer = false;
+			}
+
+			// M_CheckConditionSet fails whichever kind it isn't given the player for
+			if (cn->type >= UCRP_REQUIRESPLAYING)
+			{
+				withplayer = groupplayer = true;
+				if (!M_IsRoundConstant(cn->type))
+					groupdeps |= M_ConditionDependencies(cn);
+			}
+			else
+			{
+				withoutplayer = true;
+			}
+		}
+
+		// Only strings, which pass either way
+		if (!withoutplayer && !withplayer)
+		{
+			withoutplayer = withplayer = true;
+			deps = UCD_ANY;
+		}
+
+		if (withoutplayer)
+			gamedataconditionsets[numgamedataconditionsets++] = i;
+
+		if (withplayer)
+		{
+			playerconditionsets[numplayerconditionsets++] = i;
+			conditionsetdeps[i] = deps;
+		}
+	}
+
+	conditionindexdirty = false;
+}
+
+static boolean M_CheckUnlockConditions(player_t *player, UINT32 deps)
+{
+	UINT16 *list = player ? playerconditionsets : gamedataconditionsets;
+	UINT16 *count = player ? &numplayerconditionsets : &numgamedataconditionsets;
+	UINT16 i, kept = 0, set;
+	boolean ret = false;
+
+	if (conditionindexdirty)
+		M_BuildConditionIndex();
+
+	for (i = 0; i < *count; ++i)
+	{
+		set = list[i];
+
+		// Achieved for good, so stop checking it
+		if (gamedata->achieved[set])
 			continue;
 
-		ret = true;
+		if ((player == NULL || (conditionsetdeps[set] & deps))
+			&& (gamedata->achieved[set] = M_CheckConditionSet(&conditionSets[set], player)) == true)
+		{
+			ret = true;
+			continue;
+		}
+
+		list[kept++] = set;
 	}
 
+	*count = kept;
+
 	return ret;
 }
 
 boolean M_UpdateUnlockablesAndExtraEmblems(boolean loud, boolean doall)
 {
 	UINT16 i = 0, response = 0, newkeys = 0;
+	boolean checkgamedata = false;
+	UINT32 playerdeps = 0, deps;
 
 	if (!gamedata)
 	{
@@ -3145,13 +3346,21 @@ boolean M_UpdateUnlockablesAndExtraEmblems(boolean loud, boolean doall)
 	if (gamedata->deferredconditioncheck == true)
 	{
 		// Handle deferred all-condition checks
+		// (round conditions only as far as they could have changed)
 		gamedata->deferredconditioncheck = false;
-		doall = true;
+		checkgamedata = true;
+		playerdeps = UCD_ANY;
 	}
 
 	if (doall)
 	{
-		response = M_CheckUnlockConditions(NULL);
+		checkgamedata = true;
+		playerdeps = UCD_ALL;
+	}
+
+	if (checkgamedata)
+	{
+		response = M_CheckUnlockConditions(NULL, UCD_ALL);
 
 		M_UpdateNextPrisonEggPickup();
 
@@ -3177,10 +3386,12 @@ boolean M_UpdateUnlockablesAndExtraEmblems(boolean loud, boolean doall)
 				continue;
 			if (players[g_localplayers[i]].spectator)
 				continue;
-			if (!doall && players[g_localplayers[i]].roundconditions.checkthisframe == false)
+			deps = players[g_localplayers[i]].roundconditions.checkthisframe | playerdeps;
+			if (deps == 0)
 				continue;
-			response |= M_CheckUnlockConditions(&players[g_localplayers[i]]);
-			players[g_localplayers[i]].roundconditions.checkthisframe = false;
+			// Whatever was raised, the ones nobody raises might have changed too
+			response |= M_CheckUnlockConditions(&players[g_localplayers[i]], deps | UCD_ANY);
+			players[g_localplayers[i]].roundconditions.checkthisframe = 0;
 		}
 	}
 
@@ -3236,6 +3447,119 @@ boolean M_UpdateUnlockablesAndExtraEmblems(boolean loud, boolean doall)
 	return false;
 }
 
+// condbench [sets] [checks]
+// Fills empty condition set slots with conditions that can never pass, and
+// times checking everything for one announced event and one deferred check,
+// by scanning every set like before and through the index.
+void Command_CondBench_f(void)
+{
+	static const conditiontype_t roundtypes[] = {
+		UCRP_TRIGGER, UCRP_TRIPWIREHYUU, UCRP_HITDRAFTERLOOKBACK, UCRP_GIANTRACERSHRUNKENORBI,
+		UCRP_RETURNMARKTOSENDER, UCRP_HITMIDAIR, UCRP_SPBNEUTER, UCRP_LANDMINEDUNK,
+	};
+	static const conditiontype_t gamedatatypes[] = {
+		UC_PLAYTIME, UC_TOTALRINGS, UC_GAMECLEAR,
+	};
+	const UINT64 precision = I_GetPrecisePrecision();
+	boolean achieved[MAXCONDITIONSETS];
+	UINT16 added[MAXCONDITIONSETS];
+	UINT16 i, numadded = 0;
+	INT32 sets = MAXCONDITIONSETS, checks = 100, n;
+	player_t *player = &players[consoleplayer];
+	precise_t start, roundscan, roundindex, gamedatascan, gamedataindex;
+	conditionset_t *c;
+	boolean result = false;
+
+	if (gamestate != GS_LEVEL || gamedata == NULL)
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		sets = atoi(COM_Argv(1));
+	if (COM_Argc() > 2)
+		checks = max(1, atoi(COM_Argv(2)));
+
+	for (i = 0; i < MAXCONDITIONSETS && numadded < sets; ++i)
+	{
+		if (conditionSets[i].numconditions)
+			continue;
+
+		// Half for a player, half for gamedata, none of which can pass.
+		// The player ones wait on a single event each; the map that can't
+		// be is a round constant, so it doesn't add to that.
+		if (numadded & 1)
+		{
+			M_AddRawCondition(i, 1, gamedatatypes[(numadded/2) % (sizeof gamedatatypes / sizeof *gamedatatypes)], INT32_MAX, 0, 0, NULL);
+		}
+		else
+		{
+			M_AddRawCondition(i, 1, roundtypes[(numadded/2) % (sizeof roundtypes / sizeof *roundtypes)], 1, 0, 0, NULL);
+			M_AddRawCondition(i, 1, UCRP_ISMAP, -2, 0, 0, NULL);
+		}
+
+		added[numadded++] = i;
+	}
+
+	// Don't let this unlock anything for real
+	memcpy(achieved, gamedata->achieved, sizeof achieved);
+	M_BuildConditionIndex();
+
+	start = I_GetPreciseTime();
+	for (n = 0; n < checks; n++)
+	{
+		for (i = 0; i < MAXCONDITIONSETS; ++i)
+		{
+			c = &conditionSets[i];
+			if (!c->numconditions || gamedata->achieved[i])
+				continue;
+
+			result |= M_CheckConditionSet(c, player);
+		}
+	}
+	roundscan = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (n = 0; n < checks; n++)
+		result |= M_CheckUnlockConditions(player, UCD_HITMIDAIR | UCD_ANY);
+	roundindex = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (n = 0; n < checks; n++)
+	{
+		for (i = 0; i < MAXCONDITIONSETS; ++i)
+		{
+			c = &conditionSets[i];
+			if (!c->numconditions || gamedata->achieved[i])
+				continue;
+
+			result |= M_CheckConditionSet(c, NULL);
+		}
+	}
+	gamedatascan = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (n = 0; n < checks; n++)
+		result |= M_CheckUnlockConditions(NULL, UCD_ALL);
+	gamedataindex = I_GetPreciseTime() - start;
+
+	memcpy(gamedata->achieved, achieved, sizeof achieved);
+
+	for (i = 0; i < numadded; ++i)
+		M_ClearConditionSet(added[i]);
+
+	conditionindexdirty = true;
+
+	CONS_Printf("%d checks, %u condition sets added (%u live for a player, %u for gamedata)\n",
+		checks, numadded, numplayerconditionsets, numgamedataconditionsets);
+	CONS_Printf("Announced event, scanning: %s us\n", sizeu1((size_t)(roundscan * 1000000 / precision)));
+	CONS_Printf("Announced event, indexed: %s us\n", sizeu1((size_t)(roundindex * 1000000 / precision)));
+	CONS_Printf("Deferred check, scanning: %s us\n", sizeu1((size_t)(gamedatascan * 1000000 / precision)));
+	CONS_Printf("Deferred check, indexed: %s us\n", sizeu1((size_t)(gamedataindex * 1000000 / precision)));
+	(void)result;
+}
+
 UINT16 M_GetNextAchievedUnlock(boolean canskipchaokeys)
 {
 	UINT16 i;
@@ -455,6 +455,8 @@ UINT16 M_CheckCupEmeralds(UINT8 difficulty);
 // Updating conditions and unlockables
 boolean M_CheckCondition(condition_t *cn, player_t *player);
 boolean M_UpdateUnlockablesAndExtraEmblems(boolean loud, boolean doall);
+void M_ResetConditionIndex(void);
+void Command_CondBench_f(void);
 
 #define PENDING_CHAOKEYS (UINT16_MAX-1)
 UINT16 M_GetNextAchievedUnlock(boolean canskipchaokeys);
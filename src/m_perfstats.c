@@ -20,6 +20,7 @@
 #include "z_zone.h"
 #include "p_local.h"
 #include "g_game.h"
+#include "core/trace.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -57,10 +58,15 @@ precise_t ps_thlist_times[NUM_ACTIVETHINKERLISTS];
 precise_t ps_acs_time = 0;
 
 int ps_checkposition_calls = 0;
+int ps_sweep_moves = 0;
+int ps_sweep_culled = 0;
 
 precise_t ps_lua_thinkframe_time = 0;
 int ps_lua_mobjhooks = 0;
 
+precise_t ps_lua_gc_time = 0;
+int ps_lua_heap_kb = 0;
+
 // dynamically allocated resizeable array for thinkframe hook stats
 ps_hookinfo_t *thinkframe_hooks = NULL;
 int thinkframe_hooks_length = 0;
@@ -97,6 +103,31 @@ void PS_ResetBotInfo(void)
 	ps_botticcmd_time = 0;
 }
 
+// Microseconds, so the trace viewer's counter tracks read sensibly
+static INT64 PS_Micros(precise_t time)
+{
+	return (INT64)(time * 1000000 / I_GetPrecisePrecision());
+}
+
+void PS_TraceTicCounters(void)
+{
+	if (!TR_Enabled())
+		return;
+
+	TR_Counter("tictime_us", PS_Micros(ps_tictime));
+	TR_Counter("playerthink_us", PS_Micros(ps_playerthink_time));
+	TR_Counter("thinkertime_us", PS_Micros(ps_thinkertime));
+	TR_Counter("botticcmd_us", PS_Micros(ps_botticcmd_time));
+	TR_Counter("acs_us", PS_Micros(ps_acs_time));
+	TR_Counter("lua_thinkframe_us", PS_Micros(ps_lua_thinkframe_time));
+	TR_Counter("lua_gc_us", PS_Micros(ps_lua_gc_time));
+	TR_Counter("lua_heap_kb", ps_lua_heap_kb);
+	TR_Counter("lua_mobjhooks", ps_lua_mobjhooks);
+	TR_Counter("checkposition_calls", ps_checkposition_calls);
+	TR_Counter("sweep_moves", ps_sweep_moves);
+	TR_Counter("sweep_culled", ps_sweep_culled);
+}
+
 static void PS_SetFrameTime(void)
 {
 	precise_t currenttime = I_GetPreciseTime();
@@ -211,6 +242,16 @@ static void M_DrawRenderStats(void)
 		{0}
 	};
 
+	perfstatrow_t luagctime_row[] = {
+		{"luagc  ", "Lua GC:        ", &ps_lua_gc_time},
+		{0}
+	};
+
+	perfstatrow_t luaheap_row[] = {
+		{"luaheap", "Lua heap (KB): ", &ps_lua_heap_kb},
+		{0}
+	};
+
 	perfstatrow_t rendercalls_row[] = {
 		{"bspcall", "BSP calls:   ", &ps_numbspcalls},
 		{"sprites", "Sprites:     ", &ps_numsprites},
@@ -248,6 +289,8 @@ static void M_DrawRenderStats(void)
 
 	perfstatcol_t     uiswaptime_col =  {20,  20, V_YELLOWMAP,     uiswaptime_row};
 	perfstatcol_t        tictime_col =  {20,  20, V_GRAYMAP,          tictime_row};
+	perfstatcol_t      luagctime_col =  {20,  20, V_GRAYMAP,        luagctime_row};
+	perfstatcol_t        luaheap_col =  {20,  20, V_GRAYMAP,          luaheap_row};
 
 	perfstatcol_t    rendercalls_col =  {90, 115, V_BLUEMAP,      rendercalls_row};
 
@@ -306,6 +349,10 @@ static void M_DrawRenderStats(void)
 	draw_row += half_row;
 	M_DrawPerfTiming(&tictime_col);
 
+	draw_row += half_row;
+	M_DrawPerfTiming(&luagctime_col);
+	M_DrawPerfCount(&luaheap_col);
+
 	if (rendering)
 	{
 		draw_row = 10;
@@ -413,6 +460,8 @@ static void M_DrawTickStats(void)
 	perfstatrow_t misc_calls_row[] = {
 		{"lmhook", "Lua mobj hooks: ", &ps_lua_mobjhooks},
 		{"chkpos", "P_CheckPosition:", &ps_checkposition_calls},
+		{"sweep ", "Swept moves:    ", &ps_sweep_moves},
+		{"culled", "Lines culled:   ", &ps_sweep_culled},
 		{0}
 	};
 
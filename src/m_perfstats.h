@@ -41,10 +41,15 @@ extern precise_t ps_thlist_times[];
 extern precise_t ps_acs_time;
 
 extern int       ps_checkposition_calls;
+extern int       ps_sweep_moves;
+extern int       ps_sweep_culled;
 
 extern precise_t ps_lua_thinkframe_time;
 extern int       ps_lua_mobjhooks;
 
+extern precise_t ps_lua_gc_time;
+extern int       ps_lua_heap_kb;
+
 struct ps_hookinfo_t
 {
 	precise_t time_taken;
@@ -66,6 +71,9 @@ extern ps_botinfo_t ps_bots[MAXPLAYERS];
 
 void PS_ResetBotInfo(void);
 
+// Record this tic's numbers as counters while "trace on" is running.
+void PS_TraceTicCounters(void);
+
 void M_DrawPerfStats(void);
 
 #ifdef __cplusplus
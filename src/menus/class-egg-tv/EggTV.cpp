@@ -755,7 +755,7 @@ void EggTV::draw_grid() const
 			return;
 		}
 
-		if (replay->invalid())
+		if (replay->invalid() && !replay->pending())
 		{
 			cell.flags(V_MODULATE).colorize(SKINCOLOR_RED).patch(patches_.empty);
 			return;
@@ -774,6 +774,13 @@ void EggTV::draw_grid() const
 			return;
 		}
 
+		if (replay->pending())
+		{
+			// Static until the index has read it
+			cell.patch(patches_.tv.animate(2));
+			return;
+		}
+
 		if (replay->invalid())
 		{
 			cell.flags(V_MODULATE).patch(patches_.corrupt[mode].animate(2));
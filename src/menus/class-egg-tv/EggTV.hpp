@@ -53,6 +53,7 @@ public:
 
 	bool favorited() const;
 
+	void tick() { index().update(); }
 	void draw() const;
 
 private:
@@ -16,6 +16,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 
 #include <fmt/format.h>
 #include <fmt/std.h> // std::filesystem::path formatter
@@ -128,7 +129,8 @@ EggTVData::Folder::Cache::Cache(Folder& folder) : folder_(folder)
 				replays_.emplace_back(
 					*this,
 					entry.path().filename(),
-					time_point_conv<time_point_t>(entry.last_write_time())
+					time_point_conv<time_point_t>(entry.last_write_time()),
+					ReplayIndex::Stat::of(entry)
 				);
 			}
 			catch (const fs::filesystem_error& ex)
@@ -157,6 +159,26 @@ EggTVData::Folder::Cache::Cache(Folder& folder) : folder_(folder)
 
 	// Refresh folder size
 	folder_.size_ = replays_.size();
+
+	// Read anything the index doesn't know about yet in the
+	// background, in the order the grid shows them.
+	ReplayIndex& index = folder_.tv().index_;
+	std::unordered_set<std::string> keep;
+
+	for (const ReplayRef& ref : replays_)
+	{
+		std::string key = ref.favorites_path();
+
+		if (!index.find(key, ref.stat()))
+		{
+			index.request(key, folder_.path() / ref.filename(), ref.stat(), /*urgent*/ false);
+		}
+
+		keep.insert(std::move(key));
+	}
+
+	index.prune(folder_.name(), keep);
+	index.folder(folder_.name(), {folder_.mtime_, folder_.size_, folder_.time_.time_since_epoch().count()});
 }
 
 std::shared_ptr<EggTVData::Replay> EggTVData::Folder::Cache::replay(std::size_t idx)
@@ -185,6 +207,17 @@ EggTVData::Folder::Folder(EggTVData& tv, const fs::directory_entry& entry) :
 {
 	SRB2_ASSERT(entry.path().parent_path() == tv_->root_);
 
+	// Adding or removing a replay changes the directory's own
+	// modification time, so the last count can be reused until then.
+	mtime_ = entry.last_write_time().time_since_epoch().count();
+
+	if (const ReplayIndex::FolderSummary* summary = tv_->index_.folder(name_, mtime_))
+	{
+		size_ = summary->size;
+		time_ = time_point_t(time_point_t::duration(summary->newest));
+		return;
+	}
+
 	time_ = time_point_t::min();
 	size_ = 0;
 
@@ -197,6 +230,8 @@ EggTVData::Folder::Folder(EggTVData& tv, const fs::directory_entry& entry) :
 
 		size_++;
 	}
+
+	tv_->index_.folder(name_, {mtime_, size_, time_.time_since_epoch().count()});
 }
 
 EggTVData::Replay::Title::operator const std::string() const
@@ -208,17 +243,28 @@ EggTVData::Replay::Replay(Folder::Cache::ReplayRef& ref) : ref_(&ref)
 {
 	const fs::path path = this->path();
 
-	menudemo_t info = {};
-
-	if (path.native().size() >= sizeof info.filepath)
+	if (path.native().size() >= sizeof menudemo_t::filepath)
 	{
 		return;
 	}
 
-	std::copy_n(path.string().c_str(), path.native().size() + 1, info.filepath);
+	const std::string key = ref.favorites_path();
+	const menudemo_t* info = ref.index().find(key, ref.stat());
+
+	if (!info)
+	{
+		// Not read yet, or changed since it was. It's on screen,
+		// so put it first in line.
+		pending_ = true;
+		ref.index().request(key, path, ref.stat(), /*urgent*/ true);
+		return;
+	}
 
-	G_LoadDemoInfo(&info, /*allownonmultiplayer*/ false);
+	load(*info);
+}
 
+void EggTVData::Replay::load(const menudemo_t& info)
+{
 	if (info.type != MD_LOADED)
 	{
 		return;
@@ -330,6 +376,8 @@ void EggTVData::Replay::toggle_favorite() const
 
 void EggTVData::cache_folders()
 {
+	std::unordered_set<std::string> names;
+
 	for (const fs::directory_entry& entry : fs::directory_iterator(root_))
 	{
 		try
@@ -341,6 +389,8 @@ void EggTVData::cache_folders()
 
 			Folder folder(*this, entry);
 
+			names.insert(folder.name());
+
 			if (!folder.empty())
 			{
 				folders_.push_back(folder);
@@ -353,6 +403,8 @@ void EggTVData::cache_folders()
 		}
 	}
 
+	index_.prune_folders(names);
+
 	sort_folders();
 }
 
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -26,6 +27,7 @@
 #include <nlohmann/json.hpp>
 
 #include "../../cxxutil.hpp"
+#include "EggTVIndex.hpp"
 
 #include "../../d_main.h" // srb2home
 #include "../../doomstat.h" // gametype_t
@@ -43,6 +45,8 @@ private:
 	nlohmann::json favoritesFile_ = cache_favorites();
 	nlohmann::json& favorites_;
 
+	ReplayIndex index_{root_ / "replayindex.ubj"};
+
 	nlohmann::json cache_favorites() const;
 
 	void cache_folders();
@@ -64,21 +68,25 @@ public:
 			class ReplayRef
 			{
 			public:
-				explicit ReplayRef(Cache& cache, std::filesystem::path filename, time_point_t time) :
-					cache_(&cache), filename_(filename), time_(time)
+				explicit ReplayRef(Cache& cache, std::filesystem::path filename, time_point_t time, ReplayIndex::Stat stat) :
+					cache_(&cache), filename_(filename), time_(time), stat_(stat)
 				{
 				}
 
 				Cache& cache() const { return *cache_; }
 				const std::filesystem::path& filename() const { return filename_; }
 				const time_point_t& time() const { return time_; }
+				const ReplayIndex::Stat& stat() const { return stat_; }
 
 				std::shared_ptr<Replay> replay()
 				{
 					SRB2_ASSERT(!released_); // do not call after released
 
-					if (!replay_)
+					// Replays still waiting on the index are tried
+					// again whenever it gets new entries.
+					if (!replay_ || (replay_->pending() && generation_ != index().generation()))
 					{
+						generation_ = index().generation();
 						replay_ = std::make_shared<Replay>(*this);
 					}
 
@@ -93,6 +101,7 @@ public:
 
 				bool favorited() const { return iterator_to_favorite() != favorites().end(); }
 				nlohmann::json& favorites() const { return cache().folder().tv().favorites_; }
+				ReplayIndex& index() const { return cache().folder().tv().index_; }
 
 				std::string favorites_path() const
 				{
@@ -111,7 +120,9 @@ public:
 				Cache* cache_;
 				std::filesystem::path filename_;
 				time_point_t time_;
+				ReplayIndex::Stat stat_;
 				std::shared_ptr<Replay> replay_;
+				std::size_t generation_ = 0;
 				bool released_ = false;
 			};
 
@@ -149,6 +160,7 @@ public:
 	private:
 		std::size_t size_;
 		time_point_t time_;
+		std::int64_t mtime_; // of the directory, for the index
 		EggTVData* tv_;
 		std::string name_;
 	};
@@ -247,6 +259,7 @@ public:
 		void toggle_favorite() const;
 
 		bool invalid() const { return invalid_; }
+		bool pending() const { return pending_; } // not in the index yet, also invalid
 		bool favorited() const { return ref_->iterator_to_favorite() != ref_->favorites().end(); }
 
 		std::filesystem::path path() const { return ref_->cache().folder().path() / ref_->filename(); }
@@ -263,12 +276,15 @@ public:
 		Folder::Cache::ReplayRef* ref_;
 
 		bool invalid_ = true;
+		bool pending_ = false;
 		bool erased_ = false;
 
 		std::vector<Standing> standings_;
 		std::size_t map_;
 		Title title_;
 		Gametype gametype_;
+
+		void load(const menudemo_t& info);
 	};
 
 	enum class FolderSort
@@ -283,6 +299,8 @@ public:
 	FolderSort folderSort_ = FolderSort::kDate;
 
 	void sort_folders();
+
+	ReplayIndex& index() { return index_; }
 };
 
 }; // namsepace srb2::menus::egg_tv
@@ -0,0 +1,468 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "EggTVIndex.hpp"
+
+#include "../../core/thread_pool.h"
+#include "../../io/streams.hpp"
+#include "../../doomdef.h" // CONS_Alert, VERSION
+#include "../../p_saveg.h" // savebuffer_t
+
+using namespace srb2::menus::egg_tv;
+
+namespace fs = std::filesystem;
+
+using nlohmann::json;
+
+namespace
+{
+
+// Bump when the saved format changes
+constexpr int kVersion = 1;
+
+// Replays being read at once. Each one is a whole file in memory.
+constexpr std::size_t kMaxInFlight = 4;
+
+json info_to_json(const menudemo_t& info)
+{
+	json standings = json::array();
+
+	for (const auto& standing : info.standings)
+	{
+		if (!standing.ranking)
+		{
+			break;
+		}
+
+		standings.push_back({standing.ranking, standing.name, standing.skin, standing.color, standing.timeorscore});
+	}
+
+	return {
+		{"type", info.type},
+		{"title", info.title},
+		{"map", info.map},
+		{"addonstatus", info.addonstatus},
+		{"gametype", info.gametype},
+		{"kartspeed", info.kartspeed},
+		{"numlaps", info.numlaps},
+		{"gp", info.gp},
+		{"standings", standings},
+	};
+}
+
+void info_from_json(const json& object, menudemo_t& info)
+{
+	info.type = static_cast<menudemotype_e>(object.at("type").get<int>());
+	strlcpy(info.title, object.at("title").get<std::string>().c_str(), sizeof info.title);
+	info.map = object.at("map").get<UINT16>();
+	info.addonstatus = object.at("addonstatus").get<UINT8>();
+	info.gametype = object.at("gametype").get<INT16>();
+	info.kartspeed = object.at("kartspeed").get<SINT8>();
+	info.numlaps = object.at("numlaps").get<UINT8>();
+	info.gp = object.at("gp").get<UINT8>();
+
+	const json& standings = object.at("standings");
+	const std::size_t count = std::min<std::size_t>(standings.size(), MAXPLAYERS);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const json& in = standings[i];
+		auto& out = info.standings[i];
+
+		out.ranking = in.at(0).get<UINT8>();
+		strlcpy(out.name, in.at(1).get<std::string>().c_str(), sizeof out.name);
+		out.skin = in.at(2).get<UINT8>();
+		out.color = in.at(3).get<UINT8>();
+		out.timeorscore = in.at(4).get<UINT32>();
+	}
+}
+
+}; // namespace
+
+struct ReplayIndex::Reads
+{
+	struct Result
+	{
+		Request request;
+		std::vector<UINT8> data;
+		bool ok;
+	};
+
+	std::mutex mutex;
+	std::vector<Result> done;
+};
+
+ReplayIndex::Stat ReplayIndex::Stat::of(const fs::directory_entry& entry)
+{
+	return {entry.file_size(), entry.last_write_time().time_since_epoch().count()};
+}
+
+ReplayIndex::ReplayIndex(fs::path file) :
+	file_(std::move(file)),
+	// Map numbers, gametypes, skins and colors in a parsed header
+	// all depend on what is currently loaded, so entries are only
+	// good for the same set of files.
+	signature_(G_DemoContentSignature()),
+	reads_(std::make_shared<Reads>())
+{
+	load();
+}
+
+ReplayIndex::~ReplayIndex()
+{
+	// Reads still in flight keep their own reference to reads_
+	// and are simply dropped.
+	save();
+}
+
+void ReplayIndex::load()
+{
+	json object;
+
+	try
+	{
+		std::ifstream f(file_, std::ios::binary);
+
+		if (!f.is_open())
+		{
+			return;
+		}
+
+		std::vector<UINT8> data {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+
+		object = json::from_ubjson(data);
+
+		if (object.at("version").get<int>() != kVersion)
+		{
+			return;
+		}
+
+		for (const auto& [name, summary] : object.at("folders").items())
+		{
+			folders_[name] = {summary.at(0).get<std::int64_t>(), summary.at(1).get<std::size_t>(), summary.at(2).get<std::int64_t>()};
+		}
+
+		if (object.at("signature").get<std::uint32_t>() != signature_)
+		{
+			// Loaded files changed, every replay has to be read again.
+			dirty_ = true;
+			return;
+		}
+
+		for (const auto& [key, value] : object.at("replays").items())
+		{
+			Entry& entry = entries_[key];
+
+			entry.stat = {value.at("size").get<std::uintmax_t>(), value.at("mtime").get<std::int64_t>()};
+			entry.info = {};
+			info_from_json(value.at("info"), entry.info);
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		CONS_Alert(CONS_WARNING, "Egg TV: replay index is unreadable, rebuilding (%s)\n", ex.what());
+
+		entries_.clear();
+		folders_.clear();
+		dirty_ = true;
+	}
+}
+
+void ReplayIndex::save()
+{
+	if (!dirty_)
+	{
+		return;
+	}
+
+	try
+	{
+		json replays = json::object();
+		json folders = json::object();
+
+		for (const auto& [key, entry] : entries_)
+		{
+			replays[key] = {
+				{"size", entry.stat.size},
+				{"mtime", entry.stat.mtime},
+				{"info", info_to_json(entry.info)},
+			};
+		}
+
+		for (const auto& [name, summary] : folders_)
+		{
+			folders[name] = {summary.mtime, summary.size, summary.newest};
+		}
+
+		const json object = {
+			{"version", kVersion},
+			{"signature", signature_},
+			{"replays", replays},
+			{"folders", folders},
+		};
+
+		const std::vector<UINT8> data = json::to_ubjson(object);
+		const std::string path = file_.string();
+		const std::string tmppath = fmt::format("{}_{}.tmp", path, rand());
+
+		// Never leave a half-written index behind
+		srb2::io::FileStream f {tmppath, srb2::io::FileStreamMode::kWrite};
+		srb2::io::write_exact(f, tcb::as_bytes(tcb::make_span(data)));
+		f.close();
+
+		fs::rename(tmppath, path);
+
+		dirty_ = false;
+	}
+	catch (const std::exception& ex)
+	{
+		CONS_Alert(CONS_ERROR, "Egg TV: %s\n", ex.what());
+	}
+}
+
+const menudemo_t* ReplayIndex::find(const std::string& key, const Stat& stat) const
+{
+	const auto it = entries_.find(key);
+
+	if (it == entries_.end() || it->second.stat != stat)
+	{
+		return nullptr;
+	}
+
+	return &it->second.info;
+}
+
+void ReplayIndex::request(const std::string& key, fs::path path, const Stat& stat, bool urgent)
+{
+	const auto [it, inserted] = requested_.try_emplace(key, State::kQueued);
+
+	if (!inserted && (!urgent || it->second != State::kQueued))
+	{
+		return;
+	}
+
+	// An urgent request for something already queued just adds a
+	// second copy at the front. Whichever comes out first is read,
+	// the other is skipped.
+	Request req {key, std::move(path), stat};
+
+	if (urgent)
+	{
+		queue_.push_front(std::move(req));
+	}
+	else
+	{
+		queue_.push_back(std::move(req));
+	}
+
+	dispatch();
+}
+
+void ReplayIndex::dispatch()
+{
+	bool scheduled = false;
+
+	while (inflight_ < kMaxInFlight && !queue_.empty())
+	{
+		Request req = std::move(queue_.front());
+		queue_.pop_front();
+
+		const auto it = requested_.find(req.key);
+
+		if (it == requested_.end() || it->second != State::kQueued)
+		{
+			continue;
+		}
+
+		it->second = State::kReading;
+		inflight_++;
+
+		auto task = [reads = reads_, req = std::move(req)]() mutable
+		{
+			Reads::Result result {std::move(req), {}, false};
+
+			// Workers only read the file. Parsing touches the zone
+			// allocator and game state, so that waits for update().
+			try
+			{
+				std::ifstream f(result.request.path, std::ios::binary | std::ios::ate);
+
+				if (f.is_open())
+				{
+					const std::streamoff size = f.tellg();
+
+					if (size >= 0)
+					{
+						result.data.resize(static_cast<std::size_t>(size));
+						f.seekg(0);
+						f.read(reinterpret_cast<char*>(result.data.data()), size);
+						result.ok = !f.fail();
+					}
+				}
+			}
+			catch (...)
+			{
+				result.ok = false;
+			}
+
+			std::lock_guard<std::mutex> lock(reads->mutex);
+			reads->done.push_back(std::move(result));
+		};
+
+		if (srb2::g_main_threadpool)
+		{
+			srb2::g_main_threadpool->schedule(std::move(task));
+			scheduled = true;
+		}
+		else
+		{
+			task();
+		}
+	}
+
+	if (scheduled)
+	{
+		srb2::g_main_threadpool->notify();
+	}
+}
+
+void ReplayIndex::update()
+{
+	std::vector<Reads::Result> done;
+
+	{
+		std::lock_guard<std::mutex> lock(reads_->mutex);
+		done.swap(reads_->done);
+	}
+
+	for (Reads::Result& result : done)
+	{
+		const Request& req = result.request;
+
+		inflight_--;
+		requested_.erase(req.key);
+
+		Entry entry;
+
+		entry.stat = req.stat;
+		entry.info = {};
+
+		// filepath only names the replay in error messages
+		strlcpy(entry.info.filepath, req.path.string().c_str(), sizeof entry.info.filepath);
+
+		if (result.ok)
+		{
+			savebuffer_t buffer = {};
+
+			buffer.buffer = buffer.p = result.data.data();
+			buffer.size = result.data.size();
+			buffer.end = buffer.buffer + buffer.size;
+
+			G_LoadDemoInfoFromBuffer(&entry.info, &buffer, /*allownonmultiplayer*/ false);
+		}
+		else
+		{
+			CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), entry.info.filepath);
+			entry.info.type = MD_INVALID;
+		}
+
+		entry.info.filepath[0] = '\0';
+
+		entries_[req.key] = entry;
+		dirty_ = true;
+	}
+
+	if (!done.empty())
+	{
+		generation_++;
+	}
+
+	dispatch();
+}
+
+const ReplayIndex::FolderSummary* ReplayIndex::folder(const std::string& name, std::int64_t mtime) const
+{
+	const auto it = folders_.find(name);
+
+	if (it == folders_.end() || it->second.mtime != mtime)
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+void ReplayIndex::folder(const std::string& name, const FolderSummary& summary)
+{
+	FolderSummary& old = folders_[name];
+
+	if (old.mtime != summary.mtime || old.size != summary.size || old.newest != summary.newest)
+	{
+		old = summary;
+		dirty_ = true;
+	}
+}
+
+void ReplayIndex::prune(const std::string& folder, const std::unordered_set<std::string>& keep)
+{
+	const std::string prefix = folder + '/';
+
+	for (auto it = entries_.begin(); it != entries_.end();)
+	{
+		if (it->first.compare(0, prefix.size(), prefix) == 0 && keep.find(it->first) == keep.end())
+		{
+			it = entries_.erase(it);
+			dirty_ = true;
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void ReplayIndex::prune_folders(const std::unordered_set<std::string>& keep)
+{
+	for (auto it = folders_.begin(); it != folders_.end();)
+	{
+		if (keep.find(it->first) == keep.end())
+		{
+			it = folders_.erase(it);
+			dirty_ = true;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (auto it = entries_.begin(); it != entries_.end();)
+	{
+		if (keep.find(it->first.substr(0, it->first.find('/'))) == keep.end())
+		{
+			it = entries_.erase(it);
+			dirty_ = true;
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
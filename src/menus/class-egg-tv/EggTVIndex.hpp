@@ -0,0 +1,128 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+
+#ifndef __EGGTVINDEX_HPP__
+#define __EGGTVINDEX_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../g_demo.h" // menudemo_t
+
+namespace srb2::menus::egg_tv
+{
+
+// Replay headers, saved between sessions so opening a folder
+// doesn't mean reading every replay in it again. Entries are
+// keyed by path relative to the replay root and only trusted
+// while the file's size and modification time still match.
+//
+// Anything missing or out of date gets read by the thread
+// pool in the background, then parsed on the main thread in
+// update().
+class ReplayIndex
+{
+public:
+	struct Stat
+	{
+		std::uintmax_t size = 0;
+		std::int64_t mtime = 0;
+
+		static Stat of(const std::filesystem::directory_entry& entry);
+
+		bool operator==(const Stat& b) const { return size == b.size && mtime == b.mtime; }
+		bool operator!=(const Stat& b) const { return !(*this == b); }
+	};
+
+	struct FolderSummary
+	{
+		std::int64_t mtime; // of the directory itself
+		std::size_t size;
+		std::int64_t newest; // EggTVData::time_point_t ticks
+	};
+
+	explicit ReplayIndex(std::filesystem::path file);
+	ReplayIndex(const ReplayIndex&) = delete;
+	~ReplayIndex();
+
+	ReplayIndex& operator=(const ReplayIndex&) = delete;
+
+	// nullptr if this replay has not been read yet, or has changed since
+	const menudemo_t* find(const std::string& key, const Stat& stat) const;
+
+	// Read a replay in the background. Urgent requests (replays
+	// currently on screen) skip ahead of the rest of the queue.
+	void request(const std::string& key, std::filesystem::path path, const Stat& stat, bool urgent);
+
+	// Parse replays that have finished reading and start reading
+	// more. Call every tic.
+	void update();
+
+	// Changes whenever update() adds new entries
+	std::size_t generation() const { return generation_; }
+
+	const FolderSummary* folder(const std::string& name, std::int64_t mtime) const;
+	void folder(const std::string& name, const FolderSummary& summary);
+
+	// Forget replays in a folder that are no longer there
+	void prune(const std::string& folder, const std::unordered_set<std::string>& keep);
+
+	// Forget folders that are no longer there
+	void prune_folders(const std::unordered_set<std::string>& keep);
+
+	void save();
+
+private:
+	struct Entry
+	{
+		Stat stat;
+		menudemo_t info;
+	};
+
+	struct Request
+	{
+		std::string key;
+		std::filesystem::path path;
+		Stat stat;
+	};
+
+	struct Reads; // shared with workers
+
+	enum class State
+	{
+		kQueued,
+		kReading,
+	};
+
+	std::filesystem::path file_;
+	std::uint32_t signature_;
+	bool dirty_ = false;
+	std::size_t generation_ = 0;
+
+	std::unordered_map<std::string, Entry> entries_;
+	std::unordered_map<std::string, FolderSummary> folders_;
+
+	std::deque<Request> queue_;
+	std::unordered_map<std::string, State> requested_;
+	std::size_t inflight_ = 0;
+	std::shared_ptr<Reads> reads_;
+
+	void load();
+	void dispatch();
+};
+
+}; // namespace srb2::menus::egg_tv
+
+#endif // __EGGTVINDEX_HPP__
@@ -868,6 +868,7 @@ boolean M_ChallengesInputs(INT32 ch)
 				if (set > 0 && set <= MAXCONDITIONSETS)
 				{
 					gamedata->achieved[set - 1] = false;
+					M_ResetConditionIndex();
 				}
 
 				M_UpdateChallengeGridVisuals();
@@ -30,6 +30,11 @@ void M_DrawEggTV()
 	g_egg_tv->draw();
 }
 
+void M_TickEggTV()
+{
+	g_egg_tv->tick();
+}
+
 boolean M_QuitEggTV()
 {
 	g_egg_tv = {};
@@ -124,7 +129,7 @@ menu_t EXTRAS_EggTVDef =
 	41, 1,
 	M_DrawEggTV,
 	NULL,
-	NULL,
+	M_TickEggTV,
 	NULL,
 	M_QuitEggTV,
 	M_HandleEggTV
@@ -716,6 +716,31 @@ void T_BounceCheese(bouncecheese_t *bouncer)
 	}
 }
 
+// Keeps sector->crumblers in thinker order, so
+// PIT_ChangeSector can find them without a
+// thinker list scan.
+void P_AddCrumbler(crumble_t *crumble)
+{
+	crumble_t **link = &crumble->sector->crumblers;
+
+	while (*link)
+		link = &(*link)->next;
+
+	crumble->next = NULL;
+	*link = crumble;
+}
+
+void P_RemoveCrumbler(crumble_t *crumble)
+{
+	crumble_t **link = &crumble->sector->crumblers;
+
+	while (*link && *link != crumble)
+		link = &(*link)->next;
+
+	if (*link)
+		*link = crumble->next;
+}
+
 //////////////////////////////////////////////////
 // T_StartCrumble ////////////////////////////////
 //////////////////////////////////////////////////
@@ -879,6 +904,7 @@ void T_StartCrumble(crumble_t *crumble)
 		crumble->sector->ceilspeed = 0;
 		crumble->sector->floorspeed = 0;
 		crumble->sector->moved = true;
+		P_RemoveCrumbler(crumble);
 		P_RemoveThinker(&crumble->thinker);
 	}
 
@@ -2299,6 +2325,7 @@ INT32 EV_StartCrumble(sector_t *sec, ffloor_t *rover, boolean floating,
 	crumble->sourceline = rover->master;
 
 	sec->floordata = crumble;
+	P_AddCrumbler(crumble);
 
 	if (crumblereturn)
 		crumble->flags |= CF_RETURN;
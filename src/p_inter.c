@@ -1926,6 +1926,7 @@ void P_KillMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, UINT8 damaget
 				if (!target->player->exiting)
 				{
 					target->player->pflags |= PF_NOCONTEST;
+					target->player->roundconditions.checkthisframe |= UCD_FINISH;
 					K_InitPlayerTally(target->player);
 				}
 			}
@@ -2558,7 +2559,7 @@ static boolean P_KillPlayer(player_t *player, mobj_t *inflictor, mobj_t *source,
 				&& beforeexit == true)
 			{
 				player->roundconditions.fell_off = true;
-				player->roundconditions.checkthisframe = true;
+				player->roundconditions.checkthisframe |= UCD_FELLOFF;
 			}
 
 			if (gametyperules & (GTR_BUMPERS|GTR_CHECKPOINTS))
@@ -2806,7 +2807,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 				&& source->player->roundconditions.spb_neuter == false)
 			{
 				source->player->roundconditions.spb_neuter = true;
-				source->player->roundconditions.checkthisframe = true;
+				source->player->roundconditions.checkthisframe |= UCD_SPBNEUTER;
 			}
 			break;
 
@@ -2906,7 +2907,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 				&& source->player->airtime > TICRATE/2)
 			{
 				source->player->roundconditions.hit_midair = true;
-				source->player->roundconditions.checkthisframe = true;
+				source->player->roundconditions.checkthisframe |= UCD_HITMIDAIR;
 			}
 
 			if (source->player->roundconditions.hit_drafter_lookback == false
@@ -2916,7 +2917,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 				/*&& (AngleDelta(K_MomentumAngle(source), R_PointToAngle2(source->x, source->y, target->x, target->y)) > ANGLE_90)*/)
 			{
 				source->player->roundconditions.hit_drafter_lookback = true;
-				source->player->roundconditions.checkthisframe = true;
+				source->player->roundconditions.checkthisframe |= UCD_HITDRAFTERLOOKBACK;
 			}
 
 			if (source->player->roundconditions.giant_foe_shrunken_orbi == false
@@ -2927,7 +2928,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 				&& inflictor->scale < FixedMul((FRACUNIT + SHRINK_SCALE), mapobjectscale * 2)) // halfway between base scale and shrink scale, a little bit of leeway
 			{
 				source->player->roundconditions.giant_foe_shrunken_orbi = true;
-				source->player->roundconditions.checkthisframe = true;
+				source->player->roundconditions.checkthisframe |= UCD_SHRUNKENORBI;
 			}
 
 			if (source == target
@@ -2940,7 +2941,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 				&& inflictor->tracer->player->roundconditions.returntosender_mark == false)
 			{
 				inflictor->tracer->player->roundconditions.returntosender_mark = true;
-				inflictor->tracer->player->roundconditions.checkthisframe = true;
+				inflictor->tracer->player->roundconditions.checkthisframe |= UCD_RETURNTOSENDER;
 			}
 		}
 		else if (!(inflictor && inflictor->player)
@@ -2953,7 +2954,7 @@ boolean P_DamageMobj(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 da
 			if (!(player->roundconditions.hittrackhazard[player->laps/8] & requiredbit))
 			{
 				player->roundconditions.hittrackhazard[player->laps/8] |= requiredbit;
-				player->roundconditions.checkthisframe = true;
+				player->roundconditions.checkthisframe |= UCD_TRACKHAZARD;
 			}
 		}
 
@@ -79,6 +79,7 @@ typedef enum
 } thinklistnum_t; /**< Thinker lists. */
 extern thinker_t thlist[];
 extern mobj_t *mobjcache;
+extern precipmobj_t *precipcache;
 
 void P_InitThinkers(void);
 void P_InvalidateThinkersWithoutInit(void);
@@ -262,6 +263,8 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type);
 
 void P_CalculatePrecipFloor(precipmobj_t *mobj);
 void P_RecalcPrecipInSector(sector_t *sector);
+void P_QueuePrecipRecalc(sector_t *sector);
+void P_FlushPrecipRecalc(void);
 void P_PrecipitationEffects(void);
 
 void P_RemoveMobj(mobj_t *th);
@@ -492,6 +495,7 @@ extern fixed_t bmaporgx;
 extern fixed_t bmaporgy; // origin of block map
 extern mobj_t **blocklinks; // for thing chains
 extern precipmobj_t **precipblocklinks; // special blockmap for precip rendering
+extern precipcell_t *precipcells; // the same, as arrays
 
 extern struct minimapinfo
 {
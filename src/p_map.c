@@ -1994,6 +1994,169 @@ static BlockItReturn_t PIT_CheckLine(line_t *ld)
 //                         MOVEMENT CLIPPING
 // =========================================================================
 
+//
+// Swept broadphase
+//
+// increment_move splits a move into steps of at most 16 map units, and
+// every step runs P_CheckPosition over nearly the same blocks. Static
+// lines can't move, so gather the ones touching the whole move's bounding
+// box once, and have each step read from that instead of the blockmap.
+// A line outside the swept box is outside every step's box too, which
+// PIT_CheckLine rejects before doing anything else, so results match.
+//
+// Things and polyobjects are still walked live: PIT_CheckThing (and Lua
+// hooks through it) can move or remove them between steps.
+//
+
+#define MAXSWEEPCELLS 64
+
+static mobj_t *sweepthing = NULL; // Owner of the cache, NULL when unused
+static fixed_t sweepbox[4];
+static INT32 sweepxl, sweepxh, sweepyl, sweepyh;
+
+static size_t sweepcells[MAXSWEEPCELLS + 1]; // Offsets into sweeplines
+static line_t **sweeplines = NULL;
+static size_t sweeplines_max = 0U;
+
+static boolean P_BeginSweep(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	const fixed_t radius = thing->radius;
+	INT32 xl, xh, yl, yh, bx, by;
+	size_t count = 0U, cell = 0U;
+
+	if (sweepthing != NULL)
+		return false; // Nested move, let the outer one keep it
+
+	sweepbox[BOXLEFT] = min(thing->x, x) - radius;
+	sweepbox[BOXRIGHT] = max(thing->x, x) + radius;
+	sweepbox[BOXBOTTOM] = min(thing->y, y) - radius;
+	sweepbox[BOXTOP] = max(thing->y, y) + radius;
+
+	// Same bounds as P_CheckPosition
+	xl = (unsigned)(sweepbox[BOXLEFT] - bmaporgx - MAXRADIUS)>>MAPBLOCKSHIFT;
+	xh = (unsigned)(sweepbox[BOXRIGHT] - bmaporgx + MAXRADIUS)>>MAPBLOCKSHIFT;
+	yl = (unsigned)(sweepbox[BOXBOTTOM] - bmaporgy - MAXRADIUS)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(sweepbox[BOXTOP] - bmaporgy + MAXRADIUS)>>MAPBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	if (xl > xh || yl > yh
+		|| (INT64)(xh - xl + 1) * (yh - yl + 1) > MAXSWEEPCELLS)
+		return false; // Huge move, not worth it
+
+	for (bx = xl; bx <= xh; bx++)
+	{
+		for (by = yl; by <= yh; by++)
+		{
+			const INT32 *list;
+
+			sweepcells[cell++] = count;
+
+			if (bx < 0 || by < 0 || bx >= bmapwidth || by >= bmapheight)
+				continue;
+
+			// First index is really empty, so +1 it.
+			for (list = blockmaplump + *(blockmap + by*bmapwidth + bx) + 1; *list != -1; list++)
+			{
+				line_t *ld = &lines[*list];
+
+				// Polyobject lines move, keep them
+				if (ld->polyobj == NULL
+					&& (sweepbox[BOXRIGHT] <= ld->bbox[BOXLEFT] || sweepbox[BOXLEFT] >= ld->bbox[BOXRIGHT]
+					|| sweepbox[BOXTOP] <= ld->bbox[BOXBOTTOM] || sweepbox[BOXBOTTOM] >= ld->bbox[BOXTOP]))
+				{
+					ps_sweep_culled++;
+					continue;
+				}
+
+				if (count >= sweeplines_max)
+				{
+					sweeplines_max = sweeplines_max ? sweeplines_max * 2 : 64;
+					sweeplines = Z_Realloc(sweeplines, sweeplines_max * sizeof (*sweeplines), PU_STATIC, NULL);
+				}
+
+				sweeplines[count++] = ld;
+			}
+		}
+	}
+
+	sweepcells[cell] = count;
+
+	sweepxl = xl;
+	sweepxh = xh;
+	sweepyl = yl;
+	sweepyh = yh;
+	sweepthing = thing;
+
+	ps_sweep_moves++;
+
+	return true;
+}
+
+static void P_EndSweep(void)
+{
+	sweepthing = NULL;
+}
+
+// Can this P_CheckPosition read from the cache?
+static boolean P_SweepCovers(mobj_t *thing, INT32 xl, INT32 xh, INT32 yl, INT32 yh)
+{
+	return (sweepthing == thing
+		&& g_tm.bbox[BOXLEFT] >= sweepbox[BOXLEFT] && g_tm.bbox[BOXRIGHT] <= sweepbox[BOXRIGHT]
+		&& g_tm.bbox[BOXBOTTOM] >= sweepbox[BOXBOTTOM] && g_tm.bbox[BOXTOP] <= sweepbox[BOXTOP]
+		&& xl >= sweepxl && xh <= sweepxh && yl >= sweepyl && yh <= sweepyh);
+}
+
+// P_BlockLinesIterator, reading static lines from the cache.
+static void P_SweepLinesIterator(INT32 x, INT32 y, BlockItReturn_t (*func)(line_t *))
+{
+	const size_t cell = (x - sweepxl) * (sweepyh - sweepyl + 1) + (y - sweepyl);
+	polymaplink_t *plink;
+	size_t i;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return;
+
+	for (plink = polyblocklinks[y*bmapwidth + x]; plink; plink = (polymaplink_t *)(plink->link.next))
+	{
+		polyobj_t *po = plink->po;
+
+		if (po->validcount == validcount)
+			continue;
+
+		po->validcount = validcount;
+
+		for (i = 0; i < po->numLines; ++i)
+		{
+			BlockItReturn_t ret;
+
+			if (po->lines[i]->validcount == validcount)
+				continue;
+
+			po->lines[i]->validcount = validcount;
+			ret = func(po->lines[i]);
+
+			if (ret == BMIT_ABORT || ret == BMIT_STOP)
+				return;
+		}
+	}
+
+	for (i = sweepcells[cell]; i < sweepcells[cell + 1]; i++)
+	{
+		line_t *ld = sweeplines[i];
+		BlockItReturn_t ret;
+
+		if (ld->validcount == validcount)
+			continue;
+
+		ld->validcount = validcount;
+		ret = func(ld);
+
+		if (ret == BMIT_ABORT || ret == BMIT_STOP)
+			return;
+	}
+}
+
 //
 // P_CheckPosition
 // This is purely informative, nothing is modified
@@ -2326,11 +2489,24 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y, TryMoveResult_t *re
 	validcount++;
 
 	// check lines
-	for (bx = xl; bx <= xh; bx++)
+	if (P_SweepCovers(thing, xl, xh, yl, yh))
 	{
-		for (by = yl; by <= yh; by++)
+		for (bx = xl; bx <= xh; bx++)
+		{
+			for (by = yl; by <= yh; by++)
+			{
+				P_SweepLinesIterator(bx, by, PIT_CheckLine);
+			}
+		}
+	}
+	else
+	{
+		for (bx = xl; bx <= xh; bx++)
 		{
-			P_BlockLinesIterator(bx, by, PIT_CheckLine);
+			for (by = yl; by <= yh; by++)
+			{
+				P_BlockLinesIterator(bx, by, PIT_CheckLine);
+			}
 		}
 	}
 
@@ -2773,7 +2949,7 @@ fixed_t P_GetThingStepUp(mobj_t *thing, fixed_t destX, fixed_t destY)
 }
 
 static boolean
-increment_move
+increment_move_steps
 (		mobj_t * thing,
 		fixed_t x,
 		fixed_t y,
@@ -2962,6 +3138,36 @@ increment_move
 	return true;
 }
 
+static boolean
+increment_move
+(		mobj_t * thing,
+		fixed_t x,
+		fixed_t y,
+		boolean allowdropoff,
+		fixed_t * return_stairjank,
+		TryMoveResult_t * result)
+{
+	const fixed_t radius = min(max(thing->radius, mapobjectscale), 16*mapobjectscale);
+	boolean swept = false;
+	boolean moveok;
+
+	// Only worth it when increment_move_steps will take more than one step
+	if (!(thing->flags & MF_NOCLIP)
+		&& (abs(x - thing->x) > radius || abs(y - thing->y) > radius))
+	{
+		swept = P_BeginSweep(thing, x, y);
+	}
+
+	moveok = increment_move_steps(thing, x, y, allowdropoff, return_stairjank, result);
+
+	if (swept)
+	{
+		P_EndSweep();
+	}
+
+	return moveok;
+}
+
 //
 // P_CheckMove
 // Check if a P_TryMove would be successful.
@@ -4331,20 +4537,13 @@ static boolean PIT_ChangeSector(mobj_t *thing, boolean realcrush)
 					else
 					{
 						//If the thing was crushed by a crumbling FOF, reward the player who made it crumble!
-						thinker_t *think;
 						crumble_t *crumbler;
 
-						for (think = thlist[THINK_MAIN].next; think != &thlist[THINK_MAIN]; think = think->next)
+						for (crumbler = rover->master->frontsector->crumblers; crumbler; crumbler = crumbler->next)
 						{
-							if (think->function.acp1 != (actionf_p1)T_StartCrumble)
-								continue;
-
-							crumbler = (crumble_t *)think;
-
 							if (crumbler->player && crumbler->player->mo
 								&& crumbler->player->mo != thing
-								&& crumbler->actionsector == thing->subsector->sector
-								&& crumbler->sector == rover->master->frontsector)
+								&& crumbler->actionsector == thing->subsector->sector)
 							{
 								killer = crumbler->player->mo;
 							}
@@ -4372,12 +4571,45 @@ static boolean PIT_ChangeSector(mobj_t *thing, boolean realcrush)
 	return true;
 }
 
+// Bumped whenever a touching_thinglist gains or loses a node,
+// or has its visited marks reset.
+static UINT32 secnodegen = 0;
+
+static void P_ResetSecnodes(sector_t *sec)
+{
+	msecnode_t *n;
+
+	for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
+		n->visited = false;
+
+	secnodegen++;
+}
+
+//
+// P_NextUnvisitedSecnode
+//
+// Processing a thing can link or unlink others, which is why the scan
+// used to restart from the head of the list every time. If secnodegen
+// hasn't moved since last was picked, everything up to and including
+// it is still visited, so carry on from there instead.
+//
+static msecnode_t *P_NextUnvisitedSecnode(sector_t *sec, msecnode_t *last, UINT32 gen)
+{
+	msecnode_t *n = (last && gen == secnodegen) ? last->m_thinglist_next : sec->touching_thinglist;
+
+	while (n && n->visited)
+		n = n->m_thinglist_next;
+
+	return n;
+}
+
 //
 // P_CheckSector
 //
 boolean P_CheckSector(sector_t *sector, boolean crunch)
 {
 	msecnode_t *n;
+	UINT32 gen = 0;
 	size_t i;
 
 	nofit = false;
@@ -4390,6 +4622,9 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 	// Things can arbitrarily be inserted and removed and it won't mess up.
 	//
 	// killough 4/7/98: simplified to avoid using complicated counter
+	//
+	// Only restarts when the list actually changed now, see
+	// P_NextUnvisitedSecnode.
 
 
 	// First, let's see if anything will keep it from crushing.
@@ -4448,59 +4683,49 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 		for (i = 0; i < sector->numattached; i++)
 		{
 			sec = &sectors[sector->attached[i]];
-			for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				n->visited = false;
+			P_ResetSecnodes(sec);
 
 			sec->moved = true;
 
-			P_RecalcPrecipInSector(sec);
+			P_QueuePrecipRecalc(sec);
 
 			if (!sector->attachedsolid[i])
 				continue;
 
-			do
+			for (n = P_NextUnvisitedSecnode(sec, NULL, gen); n; n = P_NextUnvisitedSecnode(sec, n, gen))
 			{
-				for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				if (!n->visited)
+				n->visited = true;
+				gen = secnodegen;
+				if (!(n->m_thing->flags & MF_NOBLOCKMAP))
 				{
-					n->visited = true;
-					if (!(n->m_thing->flags & MF_NOBLOCKMAP))
+					if (!PIT_ChangeSector(n->m_thing, false))
 					{
-						if (!PIT_ChangeSector(n->m_thing, false))
-						{
-							nofit = true;
-							return nofit;
-						}
+						nofit = true;
+						return nofit;
 					}
-					break;
 				}
-			} while (n);
+			}
 		}
 	}
 
 	// Mark all things invalid
 	sector->moved = true;
 
-	for (n = sector->touching_thinglist; n; n = n->m_thinglist_next)
-		n->visited = false;
+	P_ResetSecnodes(sector);
 
-	do
+	for (n = P_NextUnvisitedSecnode(sector, NULL, gen); n; n = P_NextUnvisitedSecnode(sector, n, gen))
 	{
-		for (n = sector->touching_thinglist; n; n = n->m_thinglist_next) // go through list
-			if (!n->visited) // unprocessed thing found
+		n->visited = true; // mark thing as processed
+		gen = secnodegen;
+		if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
+		{
+			if (!PIT_ChangeSector(n->m_thing, false)) // process it
 			{
-				n->visited = true; // mark thing as processed
-				if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
-				{
-					if (!PIT_ChangeSector(n->m_thing, false)) // process it
-					{
-						nofit = true;
-						return nofit;
-					}
-				}
-				break; // exit and start over
+				nofit = true;
+				return nofit;
 			}
-	} while (n); // repeat from scratch until all things left are marked valid
+		}
+	}
 
 	// Nothing blocked us, so lets crush for real!
 
@@ -4554,53 +4779,43 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 		for (i = 0; i < sector->numattached; i++)
 		{
 			sec = &sectors[sector->attached[i]];
-			for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				n->visited = false;
+			P_ResetSecnodes(sec);
 
 			sec->moved = true;
 
-			P_RecalcPrecipInSector(sec);
+			P_QueuePrecipRecalc(sec);
 
 			if (!sector->attachedsolid[i])
 				continue;
 
-			do
+			for (n = P_NextUnvisitedSecnode(sec, NULL, gen); n; n = P_NextUnvisitedSecnode(sec, n, gen))
 			{
-				for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				if (!n->visited)
+				n->visited = true;
+				gen = secnodegen;
+				if (!(n->m_thing->flags & MF_NOBLOCKMAP))
 				{
-					n->visited = true;
-					if (!(n->m_thing->flags & MF_NOBLOCKMAP))
-					{
-						PIT_ChangeSector(n->m_thing, true);
-						return nofit;
-					}
-					break;
+					PIT_ChangeSector(n->m_thing, true);
+					return nofit;
 				}
-			} while (n);
+			}
 		}
 	}
 
 	// Mark all things invalid
 	sector->moved = true;
 
-	for (n = sector->touching_thinglist; n; n = n->m_thinglist_next)
-		n->visited = false;
+	P_ResetSecnodes(sector);
 
-	do
+	for (n = P_NextUnvisitedSecnode(sector, NULL, gen); n; n = P_NextUnvisitedSecnode(sector, n, gen))
 	{
-		for (n = sector->touching_thinglist; n; n = n->m_thinglist_next) // go through list
-			if (!n->visited) // unprocessed thing found
-			{
-				n->visited = true; // mark thing as processed
-				if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
-				{
-					PIT_ChangeSector(n->m_thing, true); // process it
-					return nofit;
-				}
-				break; // exit and start over
-			}
-	} while (n); // repeat from scratch until all things left are marked valid
+		n->visited = true; // mark thing as processed
+		gen = secnodegen;
+		if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
+		{
+			PIT_ChangeSector(n->m_thing, true); // process it
+			return nofit;
+		}
+	}
 
 	return nofit;
 }
@@ -4689,6 +4904,7 @@ static msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode
 	// of the list.
 
 	node = P_GetSecnode();
+	secnodegen++;
 
 	// mark new nodes unvisited.
 	node->visited = 0;
@@ -4787,6 +5003,8 @@ static msecnode_t *P_DelSecnode(msecnode_t *node)
 	if (sn)
 		sn->m_thinglist_prev = sp;
 
+	secnodegen++;
+
 	// Return this node to the freelist
 
 	P_PutSecnode(node);
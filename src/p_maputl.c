@@ -1383,6 +1383,171 @@ boolean P_BlockThingsIterator(INT32 x, INT32 y, BlockItReturn_t (*func)(mobj_t *
 	return true;
 }
 
+//
+// Blockmap snapshot
+//
+static blocksnapthing_t *blocksnapthings = NULL;
+static size_t blocksnapcapacity = 0;
+static UINT32 *blocksnapcells = NULL; // bmapwidth*bmapheight + 1 offsets into blocksnapthings
+
+//
+// P_BuildBlockSnapshot
+//
+// Packs the thing blockmap into blocksnapthings. Run once per tic, after thinkers.
+//
+void P_BuildBlockSnapshot(void)
+{
+	const size_t numcells = (size_t)bmapwidth * bmapheight;
+	size_t cell, count = 0;
+	mobj_t *mobj;
+
+	if (blocklinks == NULL || numcells == 0)
+		return;
+
+	if (blocksnapcells == NULL)
+		Z_Malloc((numcells + 1) * sizeof (*blocksnapcells), PU_LEVEL, &blocksnapcells);
+
+	if (blocksnapthings == NULL)
+		blocksnapcapacity = 0;
+
+	for (cell = 0; cell < numcells; cell++)
+	{
+		blocksnapcells[cell] = (UINT32)count;
+
+		for (mobj = blocklinks[cell]; mobj; mobj = mobj->bnext)
+		{
+			blocksnapthing_t *snap;
+
+			if (count >= blocksnapcapacity)
+			{
+				blocksnapcapacity = blocksnapcapacity ? blocksnapcapacity * 2 : 256;
+				blocksnapthings = Z_Realloc(blocksnapthings, blocksnapcapacity * sizeof (*blocksnapthings), PU_LEVEL, &blocksnapthings);
+			}
+
+			snap = &blocksnapthings[count++];
+			snap->mobj = mobj;
+			snap->serial = mobj->serial;
+			snap->x = mobj->x;
+			snap->y = mobj->y;
+			snap->z = mobj->z;
+			snap->radius = mobj->radius;
+			snap->flags = mobj->flags;
+		}
+	}
+
+	blocksnapcells[numcells] = (UINT32)count;
+}
+
+static boolean P_BlockSnapshotReady(void)
+{
+	if (blocksnapcells != NULL)
+		return true;
+
+	// Nothing has ticked on this level yet.
+	if (gamestate == GS_LEVEL)
+		P_BuildBlockSnapshot();
+
+	return (blocksnapcells != NULL);
+}
+
+static boolean P_BlockSnapshotCells
+(		INT32 xl, INT32 xh, INT32 yl, INT32 yh,
+		const fixed_t *box,
+		blocksnapfunc_t func, void *userdata)
+{
+	INT32 bx, by;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	if (xl < 0)
+		xl = 0;
+	if (yl < 0)
+		yl = 0;
+	if (xh >= bmapwidth)
+		xh = bmapwidth - 1;
+	if (yh >= bmapheight)
+		yh = bmapheight - 1;
+
+	for (bx = xl; bx <= xh; bx++)
+	{
+		for (by = yl; by <= yh; by++)
+		{
+			const size_t cell = (size_t)by * bmapwidth + bx;
+			const blocksnapthing_t *snap = &blocksnapthings[blocksnapcells[cell]];
+			const blocksnapthing_t *end = &blocksnapthings[blocksnapcells[cell + 1]];
+
+			for (; snap < end; snap++)
+			{
+				BlockItReturn_t ret;
+
+				if (box != NULL
+					&& (snap->x + snap->radius < box[BOXLEFT]
+					|| snap->x - snap->radius > box[BOXRIGHT]
+					|| snap->y + snap->radius < box[BOXBOTTOM]
+					|| snap->y - snap->radius > box[BOXTOP]))
+					continue;
+
+				// Removed since the snapshot was taken, and maybe
+				// already reused for something else by P_SpawnMobj.
+				if (snap->mobj->serial != snap->serial || P_MobjWasRemoved(snap->mobj))
+					continue;
+
+				ret = func(snap, userdata);
+
+				if (ret == BMIT_ABORT)
+					return false;
+
+				if (ret == BMIT_STOP)
+					break;
+			}
+		}
+	}
+
+	return true;
+}
+
+//
+// P_BlockSnapshotBox
+//
+boolean P_BlockSnapshotBox(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2, blocksnapfunc_t func, void *userdata)
+{
+	if (!P_BlockSnapshotReady())
+		return true;
+
+	return P_BlockSnapshotCells(
+		(unsigned)(x1 - bmaporgx)>>MAPBLOCKSHIFT,
+		(unsigned)(x2 - bmaporgx)>>MAPBLOCKSHIFT,
+		(unsigned)(y1 - bmaporgy)>>MAPBLOCKSHIFT,
+		(unsigned)(y2 - bmaporgy)>>MAPBLOCKSHIFT,
+		NULL, func, userdata
+	);
+}
+
+//
+// P_BlockSnapshotRadius
+//
+boolean P_BlockSnapshotRadius(fixed_t x, fixed_t y, fixed_t radius, blocksnapfunc_t func, void *userdata)
+{
+	fixed_t box[4];
+
+	if (!P_BlockSnapshotReady())
+		return true;
+
+	box[BOXTOP] = y + radius;
+	box[BOXBOTTOM] = y - radius;
+	box[BOXRIGHT] = x + radius;
+	box[BOXLEFT] = x - radius;
+
+	// Things are linked by their centre, so widen the cell search by the largest radius.
+	return P_BlockSnapshotCells(
+		(unsigned)(box[BOXLEFT] - MAXRADIUS - bmaporgx)>>MAPBLOCKSHIFT,
+		(unsigned)(box[BOXRIGHT] + MAXRADIUS - bmaporgx)>>MAPBLOCKSHIFT,
+		(unsigned)(box[BOXBOTTOM] - MAXRADIUS - bmaporgy)>>MAPBLOCKSHIFT,
+		(unsigned)(box[BOXTOP] + MAXRADIUS - bmaporgy)>>MAPBLOCKSHIFT,
+		box, func, userdata
+	);
+}
+
 //
 // INTERCEPT ROUTINES
 //
@@ -90,6 +90,33 @@ typedef enum
 boolean P_BlockLinesIterator(INT32 x, INT32 y, BlockItReturn_t(*func)(line_t *));
 boolean P_BlockThingsIterator(INT32 x, INT32 y, BlockItReturn_t(*func)(mobj_t *));
 
+// Read-only copy of the thing blockmap, taken at the end of every tic.
+// Things are packed cell by cell, in blocklinks order, so a query visits
+// them in the same order as P_BlockThingsIterator over the same cells.
+// Queries take no references and write no global state, so they may run on
+// other threads while the main thread is not ticking the game. They do not see
+// anything that moved since the last tic; game logic inside P_Ticker should
+// keep using P_BlockThingsIterator.
+struct blocksnapthing_t
+{
+	mobj_t *mobj;
+	UINT32 serial; // mobj->serial when taken
+	fixed_t x, y, z;
+	fixed_t radius;
+	UINT32 flags;
+};
+
+typedef BlockItReturn_t (*blocksnapfunc_t)(const blocksnapthing_t *thing, void *userdata);
+
+void P_BuildBlockSnapshot(void);
+
+// Every thing in the blockmap cells touched by the box. BMIT_STOP ends the
+// current cell, like P_BlockThingsIterator; BMIT_ABORT ends the whole query.
+boolean P_BlockSnapshotBox(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2, blocksnapfunc_t func, void *userdata);
+
+// Things whose bounding box touches the square of the given radius around (x, y).
+boolean P_BlockSnapshotRadius(fixed_t x, fixed_t y, fixed_t radius, blocksnapfunc_t func, void *userdata);
+
 #define PT_ADDLINES		(1)
 #define PT_ADDTHINGS	(2)
 
@@ -65,6 +65,13 @@ mobj_t *waypointcap = NULL;
 mobj_t *trackercap = NULL;
 
 mobj_t *mobjcache = NULL;
+static UINT32 mobjserial = 0;
+
+// Free precipmobjs, linked through bnext. Precipitation is allocated in blocks
+// of PRECIPBLOCKSIZE, so a whole map's worth is a few allocations laid out in
+// spawn order (which is blockmap cell order), instead of one per particle.
+precipmobj_t *precipcache = NULL;
+#define PRECIPBLOCKSIZE 1024
 
 void P_InitCachedActions(void)
 {
@@ -3385,14 +3392,14 @@ void P_MobjCheckWater(mobj_t *mobj)
 			&& (mobj->eflags & MFE_TOUCHWATER))
 		{
 			p->roundconditions.wet_player |= MFE_TOUCHWATER;
-			p->roundconditions.checkthisframe = true;
+			p->roundconditions.checkthisframe |= UCD_ANY;
 		}
 
 		if (!(p->roundconditions.wet_player & MFE_UNDERWATER)
 			&& (mobj->eflags & MFE_UNDERWATER))
 		{
 			p->roundconditions.wet_player |= MFE_UNDERWATER;
-			p->roundconditions.checkthisframe = true;
+			p->roundconditions.checkthisframe |= UCD_ANY;
 		}
 	}
 
@@ -4112,6 +4119,8 @@ void P_CalculatePrecipFloor(precipmobj_t *mobj)
 	{
 		mobj->precipflags |= PCF_INVISIBLE;
 	}
+
+	P_RefreshPrecipMobj(mobj);
 }
 
 void P_RecalcPrecipInSector(sector_t *sector)
@@ -4127,6 +4136,55 @@ void P_RecalcPrecipInSector(sector_t *sector)
 		P_CalculatePrecipFloor(psecnode->m_thing);
 }
 
+static sector_t **precipqueue = NULL; // numsectors long
+static size_t precipqueuelen = 0;
+
+//
+// P_QueuePrecipRecalc
+//
+// P_RecalcPrecipInSector, but only once per tic however many times the
+// sector moves. Precipitation is purely visual, so it only has to be
+// right by the time anything is drawn.
+//
+void P_QueuePrecipRecalc(sector_t *sector)
+{
+	if (!sector)
+		return;
+
+	sector->moved = true;
+
+	if (sector->precipdirty)
+		return;
+
+	if (precipqueue == NULL)
+	{
+		Z_Malloc(numsectors * sizeof (*precipqueue), PU_LEVEL, &precipqueue);
+		precipqueuelen = 0;
+	}
+
+	sector->precipdirty = true;
+	precipqueue[precipqueuelen++] = sector;
+}
+
+void P_FlushPrecipRecalc(void)
+{
+	size_t i;
+
+	if (precipqueue == NULL)
+	{
+		precipqueuelen = 0;
+		return;
+	}
+
+	for (i = 0; i < precipqueuelen; i++)
+	{
+		precipqueue[i]->precipdirty = false;
+		P_RecalcPrecipInSector(precipqueue[i]);
+	}
+
+	precipqueuelen = 0;
+}
+
 //
 // P_NullPrecipThinker
 //
@@ -4219,6 +4277,154 @@ boolean P_PrecipThinker(precipmobj_t *mobj)
 	return true;
 }
 
+// Copies what P_PrecipThinker needs to leave alone into the cell. Only
+// falling with no end to the state gets done there.
+static void P_LoadPrecipCell(precipmobj_t *mobj)
+{
+	precipcell_t *cell = mobj->cell;
+	const UINT32 i = mobj->cellindex;
+	const boolean falling = (mobj->tics == -1
+		&& !(mobj->frame & FF_ANIMATE)
+		&& !(mobj->precipflags & (PCF_SPLASH|PCF_INVISIBLE))
+		&& mobj->state != &states[S_RAINRETURN]);
+
+	cell->x[i] = mobj->x;
+	cell->y[i] = mobj->y;
+	cell->z[i] = mobj->z;
+	cell->oldz[i] = mobj->old_z;
+	cell->momz[i] = falling ? mobj->momz : 0;
+	cell->stopz[i] = (mobj->precipflags & PCF_FLIP) ? mobj->ceilingz : mobj->floorz;
+}
+
+static void P_AddPrecipToCell(precipmobj_t *mobj)
+{
+	const INT32 blockx = (unsigned)(mobj->x - bmaporgx) >> MAPBLOCKSHIFT;
+	const INT32 blocky = (unsigned)(mobj->y - bmaporgy) >> MAPBLOCKSHIFT;
+	precipcell_t *cell;
+
+	mobj->cell = NULL;
+
+	// Same cell as P_SetPrecipitationThingPosition links it into
+	if (precipcells == NULL || blockx < 0 || blockx >= bmapwidth || blocky < 0 || blocky >= bmapheight)
+		return;
+
+	cell = &precipcells[(blocky * bmapwidth) + blockx];
+
+	if (cell->count == cell->capacity)
+	{
+		cell->capacity = cell->capacity ? cell->capacity * 2 : 16;
+		cell->mobjs = Z_Realloc(cell->mobjs, cell->capacity * sizeof (*cell->mobjs), PU_LEVEL, NULL);
+		cell->x = Z_Realloc(cell->x, cell->capacity * sizeof (*cell->x), PU_LEVEL, NULL);
+		cell->y = Z_Realloc(cell->y, cell->capacity * sizeof (*cell->y), PU_LEVEL, NULL);
+		cell->z = Z_Realloc(cell->z, cell->capacity * sizeof (*cell->z), PU_LEVEL, NULL);
+		cell->oldz = Z_Realloc(cell->oldz, cell->capacity * sizeof (*cell->oldz), PU_LEVEL, NULL);
+		cell->momz = Z_Realloc(cell->momz, cell->capacity * sizeof (*cell->momz), PU_LEVEL, NULL);
+		cell->stopz = Z_Realloc(cell->stopz, cell->capacity * sizeof (*cell->stopz), PU_LEVEL, NULL);
+	}
+
+	mobj->cell = cell;
+	mobj->cellindex = cell->count++;
+	cell->mobjs[mobj->cellindex] = mobj;
+	P_LoadPrecipCell(mobj);
+}
+
+static void P_RemovePrecipFromCell(precipmobj_t *mobj)
+{
+	precipcell_t *cell = mobj->cell;
+	UINT32 i, last;
+
+	if (cell == NULL)
+		return;
+
+	i = mobj->cellindex;
+	last = --cell->count;
+
+	// The last one takes its place
+	if (i != last)
+	{
+		cell->mobjs[i] = cell->mobjs[last];
+		cell->x[i] = cell->x[last];
+		cell->y[i] = cell->y[last];
+		cell->z[i] = cell->z[last];
+		cell->oldz[i] = cell->oldz[last];
+		cell->momz[i] = cell->momz[last];
+		cell->stopz[i] = cell->stopz[last];
+		cell->mobjs[i]->cellindex = i;
+	}
+
+	mobj->cell = NULL;
+}
+
+// Gives the precipmobj_t the z its cell has been moving
+void P_SyncPrecipMobj(precipmobj_t *mobj)
+{
+	precipcell_t *cell = mobj->cell;
+
+	if (cell == NULL || cell->momz[mobj->cellindex] == 0)
+		return;
+
+	mobj->z = cell->z[mobj->cellindex];
+	mobj->old_z = cell->oldz[mobj->cellindex];
+}
+
+// For after changing a precipmobj_t outside of its thinker
+void P_RefreshPrecipMobj(precipmobj_t *mobj)
+{
+	if (mobj->cell == NULL)
+		return;
+
+	P_SyncPrecipMobj(mobj);
+	P_LoadPrecipCell(mobj);
+}
+
+// Once a tic, for cells the renderer gets to. Everything that's just
+// falling moves here; the rest, and what reaches the ground this tic,
+// runs P_PrecipThinker.
+void P_PrecipCellThinker(precipcell_t *cell)
+{
+	precipmobj_t *mobj;
+	UINT32 i = 0;
+
+	if (cell->lastthink == leveltime)
+		return;
+
+	cell->lastthink = leveltime;
+
+	while (i < cell->count)
+	{
+		const fixed_t momz = cell->momz[i];
+
+		if (momz != 0)
+		{
+			const fixed_t z = cell->z[i] + momz;
+
+			if ((momz > 0) ? (z < cell->stopz[i]) : (z > cell->stopz[i]))
+			{
+				cell->oldz[i] = cell->z[i];
+				cell->z[i] = z;
+				i++;
+				continue;
+			}
+		}
+		else if (cell->mobjs[i]->precipflags & PCF_INVISIBLE)
+		{
+			// Not drawn, so it doesn't think either
+			i++;
+			continue;
+		}
+
+		mobj = cell->mobjs[i];
+		P_SyncPrecipMobj(mobj);
+
+		// Freed, and the last one has been moved into i
+		if (!P_PrecipThinker(mobj))
+			continue;
+
+		P_LoadPrecipCell(mobj);
+		i++;
+	}
+}
+
 static void P_RingThinker(mobj_t *mobj)
 {
 	mobj_t *spark;	// Ring Fuse
@@ -10761,6 +10967,8 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
 	}
 
+	mobj->serial = ++mobjserial;
+
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
 	mobj->type = type;
@@ -11246,7 +11454,24 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 	const mobjinfo_t *info = &mobjinfo[type];
 	state_t *st;
 	fixed_t start_z = INT32_MIN;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	precipmobj_t *mobj;
+
+	if (precipcache == NULL)
+	{
+		precipmobj_t *block = Z_Calloc(PRECIPBLOCKSIZE * sizeof (*block), PU_LEVEL, NULL);
+		INT32 i;
+
+		// Push in reverse so that they come back out in address order.
+		for (i = PRECIPBLOCKSIZE - 1; i >= 0; i--)
+		{
+			block[i].bnext = precipcache;
+			precipcache = &block[i];
+		}
+	}
+
+	mobj = precipcache;
+	precipcache = precipcache->bnext;
+	memset(mobj, 0, sizeof(*mobj));
 
 	mobj->type = type;
 	mobj->info = info;
@@ -11308,6 +11533,8 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 
 	R_ResetPrecipitationMobjInterpolationState(mobj);
 
+	P_AddPrecipToCell(mobj);
+
 	return mobj;
 }
 
@@ -11566,6 +11793,7 @@ void P_FreePrecipMobj(precipmobj_t *mobj)
 {
 	// unlink from sector and block lists
 	P_UnsetPrecipThingPosition(mobj);
+	P_RemovePrecipFromCell(mobj);
 
 	if (precipsector_list)
 	{
@@ -11586,6 +11814,7 @@ void P_RemoveSavegameMobj(mobj_t *mobj)
 	if (((thinker_t *)mobj)->function.acp1 == (actionf_p1)P_NullPrecipThinker)
 	{
 		P_UnsetPrecipThingPosition((precipmobj_t *)mobj);
+		P_RemovePrecipFromCell((precipmobj_t *)mobj);
 
 		if (precipsector_list)
 		{
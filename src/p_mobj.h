@@ -392,6 +392,7 @@ struct mobj_t
 	fixed_t waterbottom; // bottom of the water FOF the mobj is in
 
 	UINT32 mobjnum; // A unique number for this mobj. Used for restoring pointers on save games.
+	UINT32 serial; // New every spawn, so a pointer kept past removal can tell the memory was reused.
 
 	fixed_t scale;
 	fixed_t old_scale; // interpolation
@@ -521,6 +522,23 @@ struct precipmobj_t
 	UINT32 flags; // flags from mobjinfo tables
 
 	tic_t lastThink;
+
+	precipcell_t *cell; // NULL if off the blockmap
+	UINT32 cellindex;
+};
+
+// The precipitation in one precipblocklinks cell, as arrays, so what's
+// only falling moves in one pass and the renderer can cull it without
+// touching each precipmobj_t. While momz here isn't 0, these z values
+// are the real ones; P_SyncPrecipMobj copies them back.
+struct precipcell_t
+{
+	precipmobj_t **mobjs;
+	fixed_t *x, *y, *z, *oldz;
+	fixed_t *momz; // 0 while its own thinker has to run instead
+	fixed_t *stopz; // floorz, or ceilingz when flipped
+	UINT32 count, capacity;
+	tic_t lastthink;
 };
 
 // It's extremely important that all mobj_t*-reading code have access to this.
@@ -574,6 +592,9 @@ boolean P_BossTargetPlayer(mobj_t *actor, boolean closest);
 boolean P_SupermanLook4Players(mobj_t *actor);
 void P_DestroyRobots(void);
 boolean P_PrecipThinker(precipmobj_t *mobj);
+void P_PrecipCellThinker(precipcell_t *cell);
+void P_SyncPrecipMobj(precipmobj_t *mobj);
+void P_RefreshPrecipMobj(precipmobj_t *mobj);
 void P_NullPrecipThinker(precipmobj_t *mobj);
 void P_FreePrecipMobj(precipmobj_t *mobj);
 void P_SetScale(mobj_t *mobj, fixed_t newscale);
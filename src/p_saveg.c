@@ -49,6 +49,8 @@
 #include "k_vote.h"
 #include "k_zvote.h"
 #include "k_endcam.h"
+#include "command.h" // COM_Argv
+#include "i_system.h" // I_GetPreciseTime
 
 #include <tracy/tracy/TracyC.h>
 
@@ -2707,6 +2709,8 @@ static void UnArchiveLines(savebuffer_t *save)
 		if (diff3 & LD_ACTIVATION)
 			li->activation = READUINT32(save->p);
 	}
+
+	Taglist_InvalidateLineSpecials();
 }
 
 static void P_NetArchiveWorld(savebuffer_t *save)
@@ -4334,6 +4338,62 @@ static void P_NetUnArchiveTubeWaypoints(savebuffer_t *save)
 	TracyCZoneEnd(__zone);
 }
 
+// Loaded mobjs by mobjnum, from P_NetUnArchiveThinkers until the end of
+// P_LoadNetGame, so relinking doesn't search the whole thinker list for
+// every pointer.
+static mobj_t **loadedmobjs = NULL;
+static UINT32 numloadedmobjs = 0;
+static boolean mobjtable = true; // netloadbench turns this off
+
+static void P_FreeMobjTable(void)
+{
+	Z_Free(loadedmobjs);
+	loadedmobjs = NULL;
+	numloadedmobjs = 0;
+}
+
+static void P_BuildMobjTable(void)
+{
+	thinker_t *th;
+	mobj_t *mobj;
+	UINT32 count = 0, maxnum = 0;
+
+	P_FreeMobjTable();
+
+	if (!mobjtable)
+		return;
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	{
+		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+			continue;
+
+		mobj = (mobj_t *)th;
+		count++;
+		if (mobj->mobjnum > maxnum)
+			maxnum = mobj->mobjnum;
+	}
+
+	// P_SaveNetGame numbers mobjs from 1 without gaps, so this is only
+	// for a save that didn't, which can keep searching.
+	if (maxnum == 0 || maxnum > 4*count + 64)
+		return;
+
+	numloadedmobjs = maxnum + 1;
+	loadedmobjs = Z_Calloc(numloadedmobjs * sizeof *loadedmobjs, PU_STATIC, NULL);
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	{
+		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+			continue;
+
+		// The first one wins, like searching did
+		mobj = (mobj_t *)th;
+		if (loadedmobjs[mobj->mobjnum] == NULL)
+			loadedmobjs[mobj->mobjnum] = mobj;
+	}
+}
+
 // Now save the pointers, tracer and target, but at load time we must
 // relink to this; the savegame contains the old position in the pointer
 // field copyed in the info field temporarily, but finally we just search
@@ -4343,6 +4403,21 @@ mobj_t *P_FindNewPosition(UINT32 oldposition)
 	thinker_t *th;
 	mobj_t *mobj;
 
+	if (loadedmobjs)
+	{
+		mobj = oldposition < numloadedmobjs ? loadedmobjs[oldposition] : NULL;
+
+		// Removed since loading, e.g. by Lua
+		if (mobj && mobj->thinker.function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
+			mobj = NULL;
+
+		if (mobj)
+			return mobj;
+
+		CONS_Debug(DBG_GAMELOGIC, "mobj %d not found\n", oldposition);
+		return NULL;
+	}
+
 	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
@@ -4384,14 +4459,8 @@ static inline player_t *LoadPlayer(UINT32 player)
 
 static inline pslope_t *LoadSlope(UINT32 slopeid)
 {
-	pslope_t *p = slopelist;
 	if (slopeid > slopecount) return NULL;
-	do
-	{
-		if (p->id == slopeid)
-			return p;
-	} while ((p = p->next));
-	return NULL;
+	return P_SlopeById((UINT16)slopeid);
 }
 
 static thinker_t* LoadMobjThinker(savebuffer_t *save, actionf_p1 thinker)
@@ -5109,7 +5178,10 @@ static thinker_t* LoadCrumbleThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->flags = READUINT8(save->p);
 
 	if (ht->sector)
+	{
 		ht->sector->floordata = ht;
+		P_AddCrumbler(ht);
+	}
 
 	return &ht->thinker;
 }
@@ -5468,6 +5540,7 @@ static void P_NetUnArchiveThinkers(savebuffer_t *save)
 	for (i = 0; i < numsectors; i++)
 	{
 		sectors[i].floordata = sectors[i].ceilingdata = sectors[i].lightingdata = sectors[i].fadecolormapdata = NULL;
+		sectors[i].crumblers = NULL;
 	}
 
 	// read in saved thinkers
@@ -5658,6 +5731,8 @@ static void P_NetUnArchiveThinkers(savebuffer_t *save)
 		CONS_Debug(DBG_NETPLAY, "%u thinkers loaded in list %d\n", numloaded, i);
 	}
 
+	P_BuildMobjTable();
+
 	if (restoreNum)
 	{
 		executor_t *delay = NULL;
@@ -7094,6 +7169,8 @@ boolean P_LoadNetGame(savebuffer_t *save, boolean reloading)
 	ACS_UnArchive(save);
 	LUA_UnArchive(save, true);
 
+	P_FreeMobjTable();
+
 	P_NetUnArchiveRNG(save);
 
 	// The precipitation would normally be spawned in P_SetupLevel, which is called by
@@ -7207,3 +7284,120 @@ size_t P_SaveBufferRemaining(const savebuffer_t *save)
 		return 0;
 	}
 }
+
+// netloadbench [mobjs] [loads]
+// Spawns mobjs pointing at each other, saves the game with them and times
+// loading that back, by searching for every pointer like before and
+// through the mobjnum table. The game is put back how it was afterwards.
+void Command_NetLoadBench_f(void)
+{
+	const UINT64 precision = I_GetPrecisePrecision();
+	savebuffer_t save = {0};
+	UINT8 *before, *bench;
+	size_t beforesize, benchsize, alloc;
+	INT32 mobjs = 4000, loads = 3, n;
+	mobj_t *mobj, *prev = NULL, *first = NULL;
+	precise_t start, scan = 0, table = 0;
+	boolean loaded = true;
+
+	if (gamestate != GS_LEVEL)
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+
+	if (netgame || demo.playback)
+	{
+		CONS_Printf(M_GetText("You can't use this in a netgame or demo.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		mobjs = min(max(1, atoi(COM_Argv(1))), 100000);
+	if (COM_Argc() > 2)
+		loads = max(1, atoi(COM_Argv(2)));
+
+	// Room for the level as it is, and then some for every new mobj
+	alloc = NETSAVEGAMESIZE + (size_t)mobjs * 256;
+	before = malloc(alloc);
+	bench = malloc(alloc);
+
+	if (!before || !bench)
+	{
+		free(before);
+		free(bench);
+		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+		return;
+	}
+
+	P_SaveBufferFromExisting(&save, before, alloc);
+	P_SaveNetGame(&save, false);
+	beforesize = save.p - save.buffer;
+	save.buffer = NULL;
+
+	for (n = 0; n < mobjs; n++)
+	{
+		mobj = P_SpawnMobj(0, 0, 0, MT_THOK);
+
+		if (first == NULL)
+			first = mobj;
+
+		if (prev)
+		{
+			P_SetTarget(&mobj->target, prev);
+			P_SetTarget(&mobj->hprev, prev);
+			P_SetTarget(&prev->hnext, mobj);
+		}
+
+		P_SetTarget(&mobj->tracer, first);
+		prev = mobj;
+	}
+
+	P_SaveBufferFromExisting(&save, bench, alloc);
+	P_SaveNetGame(&save, false);
+	benchsize = save.p - save.buffer;
+	save.buffer = NULL;
+
+	for (n = 0; n < loads && loaded; n++)
+	{
+		mobjtable = false;
+		P_SaveBufferFromExisting(&save, bench, benchsize);
+		start = I_GetPreciseTime();
+		loaded = P_LoadNetGame(&save, false);
+		scan += I_GetPreciseTime() - start;
+		save.buffer = NULL;
+
+		mobjtable = true;
+		if (!loaded)
+			break;
+
+		P_SaveBufferFromExisting(&save, bench, benchsize);
+		start = I_GetPreciseTime();
+		loaded = P_LoadNetGame(&save, false);
+		table += I_GetPreciseTime() - start;
+		save.buffer = NULL;
+	}
+
+	mobjtable = true;
+
+	P_SaveBufferFromExisting(&save, before, beforesize);
+	if (!P_LoadNetGame(&save, false))
+		CONS_Alert(CONS_ERROR, "Couldn't put the level back after benchmarking\n");
+	save.buffer = NULL;
+
+	wipegamestate = gamestate; // No fading back in!
+	timeinmap = leveltime;
+
+	free(before);
+	free(bench);
+
+	if (!loaded)
+	{
+		CONS_Alert(CONS_ERROR, "Couldn't load the benchmark save\n");
+		return;
+	}
+
+	CONS_Printf("%d loads of a %s byte save with %d extra mobjs\n", loads, sizeu1(benchsize), mobjs);
+	CONS_Printf("Searching: %s us\n", sizeu1((size_t)(scan * 1000000 / precision)));
+	CONS_Printf("Mobj table: %s us\n", sizeu1((size_t)(table * 1000000 / precision)));
+}
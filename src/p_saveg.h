@@ -92,6 +92,8 @@ size_t P_SaveBufferRemaining(const savebuffer_t *save);
 
 boolean TypeIsNetSynced(mobjtype_t type);
 
+void Command_NetLoadBench_f(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
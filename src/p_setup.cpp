@@ -186,6 +186,7 @@ fixed_t bmaporgx, bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
 precipmobj_t **precipblocklinks;
+precipcell_t *precipcells;
 
 // REJECT
 // For fast sight rejection.
@@ -981,8 +982,10 @@ static void P_InitializeSector(sector_t *ss)
 
 	ss->floorlightsec = ss->ceilinglightsec = -1;
 	ss->crumblestate = CRUMBLE_NONE;
+	ss->crumblers = NULL;
 
 	ss->touching_thinglist = NULL;
+	ss->precipdirty = false;
 
 	ss->linecount = 0;
 	ss->lines = NULL;
@@ -4169,6 +4172,9 @@ static boolean P_LoadBlockMap(UINT8 *data, size_t count)
 	count = sizeof (*precipblocklinks)* bmapwidth*bmapheight;
 	precipblocklinks = static_cast<precipmobj_t**>(Z_Calloc(count, PU_LEVEL, NULL));
 
+	count = sizeof (*precipcells)* bmapwidth*bmapheight;
+	precipcells = static_cast<precipcell_t*>(Z_Calloc(count, PU_LEVEL, NULL));
+
 	return true;
 }
 
@@ -4425,6 +4431,9 @@ static void P_CreateBlockMap(void)
 
 		count = sizeof (*precipblocklinks)* bmapwidth*bmapheight;
 		precipblocklinks = static_cast<precipmobj_t**>(Z_Calloc(count, PU_LEVEL, NULL));
+
+		count = sizeof (*precipcells)* bmapwidth*bmapheight;
+		precipcells = static_cast<precipcell_t*>(Z_Calloc(count, PU_LEVEL, NULL));
 	}
 }
 
@@ -7465,6 +7474,7 @@ static void P_ConvertBinaryLinedefFlags(void)
 static void P_ConvertBinaryMap(void)
 {
 	P_ConvertBinaryLinedefTypes();
+	Taglist_InvalidateLineSpecials();
 	P_ConvertBinarySectorTypes();
 	P_ConvertBinaryThingTypes();
 	P_ConvertBinaryLinedefFlags();
@@ -7550,6 +7560,7 @@ static boolean P_LoadMapFromFile(void)
 
 	P_LoadMapBSP(curmapvirt);
 	P_LoadMapLUT(curmapvirt);
+	R_BuildSubsectorGrid();
 
 	P_LinkMapData();
 
@@ -8604,10 +8615,12 @@ boolean P_LoadLevel(boolean fromnetsave, boolean reloadinggamestate)
 #endif
 
 	G_FreeGhosts(); // ghosts are allocated with PU_LEVEL
+	R_FlushTextureCache(); // waits for compose jobs still running, then frees the composites
 	Patch_FreeTag(PU_PATCH_LOWPRIORITY);
 	Patch_FreeTag(PU_PATCH_ROTATED);
 	Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
 	mobjcache = NULL;
+	precipcache = NULL;
 
 	R_InitializeLevelInterpolators();
 
@@ -9236,7 +9249,7 @@ UINT8 P_InitMapData(void)
 					auto ghostdata_finalizer = srb2::finally([=]() { Z_Free(ghostdata); });
 
 					W_ReadLumpPwad(wadindex, lumpnum, ghostdata);
-					staffbrief_t* briefghost = G_GetStaffGhostBrief(ghostdata);
+					staffbrief_t* briefghost = G_GetStaffGhostBrief(ghostdata, lumplength);
 					if (briefghost == nullptr)
 					{
 						continue;
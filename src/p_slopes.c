@@ -29,6 +29,10 @@
 pslope_t *slopelist = NULL;
 UINT16 slopecount = 0;
 
+// Slopes indexed by id - 1, for P_SlopeById.
+static pslope_t **slopetable = NULL;
+static size_t slopetablesize = 0;
+
 static void P_BuildSlopeAnchorList (void);
 static void P_SetupAnchoredSlopes  (void);
 
@@ -336,17 +340,31 @@ static inline void P_AddDynVertexSlopeThinker (pslope_t* slope, const INT16 tags
 	P_AddThinker(THINK_DYNSLOPE, &th->thinker);
 }
 
+/// Adds a slope to the slope list and gives it the next ID.
+void P_LinkSlope(pslope_t *slope)
+{
+	slope->next = slopelist;
+	slopelist = slope;
+
+	slopecount++;
+	slope->id = slopecount;
+
+	if (slopecount > slopetablesize)
+	{
+		slopetablesize = slopetablesize ? slopetablesize * 2 : 64;
+		slopetable = Z_Realloc(slopetable, slopetablesize * sizeof(*slopetable), PU_LEVEL, &slopetable);
+	}
+
+	slopetable[slopecount - 1] = slope;
+}
+
 /// Create a new slope and add it to the slope list.
 static inline pslope_t* Slope_Add (const UINT8 flags)
 {
 	pslope_t *ret = Z_Calloc(sizeof(pslope_t), PU_LEVEL, NULL);
 	ret->flags = flags;
 
-	ret->next = slopelist;
-	slopelist = ret;
-
-	slopecount++;
-	ret->id = slopecount;
+	P_LinkSlope(ret);
 
 	return ret;
 }
@@ -811,13 +829,13 @@ void P_CopySectorSlope(line_t *line)
 //
 // P_SlopeById
 //
-// Looks in the slope list for a slope with a specified ID. Mostly useful for netgame sync
+// Looks up the slope with a specified ID. Mostly useful for netgame sync
 //
 pslope_t *P_SlopeById(UINT16 id)
 {
-	pslope_t *ret;
-	for (ret = slopelist; ret && ret->id != id; ret = ret->next);
-	return ret;
+	if (id == 0 || id > slopecount || slopetable == NULL)
+		return NULL;
+	return slopetable[id - 1];
 }
 
 /// Creates a new slope from equation constants.
@@ -882,6 +900,10 @@ void P_InitSlopes(void)
 {
 	slopelist = NULL;
 	slopecount = 0;
+
+	Z_Free(slopetable);
+	slopetable = NULL;
+	slopetablesize = 0;
 }
 
 // ============================================================================
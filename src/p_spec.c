@@ -234,6 +234,33 @@ void P_InitPicAnims(void)
 	animdefs = NULL;
 }
 
+/** Marks every frame of each texture animation that has
+  * any of its frames marked, so they can be precached.
+  */
+void P_MarkAnimatedTextures(char *texturepresent)
+{
+	anim_t *anim;
+	INT32 i;
+
+	for (anim = anims; anim && anim < lastanim; anim++)
+	{
+		if (!anim->istexture)
+			continue;
+
+		for (i = 0; i < anim->numpics; i++)
+		{
+			if (texturepresent[anim->basepic + i])
+				break;
+		}
+
+		if (i == anim->numpics)
+			continue;
+
+		for (i = 0; i < anim->numpics; i++)
+			texturepresent[anim->basepic + i] = 1;
+	}
+}
+
 void P_ParseANIMDEFSLump(INT32 wadNum, UINT16 lumpnum)
 {
 	char *animdefsLump;
@@ -1900,6 +1927,8 @@ void P_SwitchWeather(preciptype_t newWeather)
 			{
 				P_CalculatePrecipFloor(precipmobj);
 			}
+
+			P_RefreshPrecipMobj(precipmobj);
 		}
 	}
 
@@ -1955,7 +1984,7 @@ static void K_HandleLapIncrement(player_t *player)
 			if (player->roundconditions.faulted == false)
 			{
 				player->roundconditions.faulted = true;
-				player->roundconditions.checkthisframe = true;
+				player->roundconditions.checkthisframe |= UCD_FAULTED;
 			}
 
 			if (P_IsDisplayPlayer(player))
@@ -2198,7 +2227,7 @@ static void K_HandleLapIncrement(player_t *player)
 
 			if (P_IsPartyPlayer(player))
 			{
-				player->roundconditions.checkthisframe = true;
+				player->roundconditions.checkthisframe |= UCD_ANY;
 				gamedata->deferredconditioncheck = true;
 			}
 		}
@@ -2913,7 +2942,11 @@ boolean P_ProcessSpecial(activator_t *activator, INT16 special, INT32 *args, cha
 					}
 					else // floormove
 					{
-						P_RemoveThinker(&((floormove_t *)sectors[secnum].floordata)->thinker);
+						thinker_t *th = &((floormove_t *)sectors[secnum].floordata)->thinker;
+						// Crumblers sit here too
+						if (th->function.acp1 == (actionf_p1)T_StartCrumble)
+							P_RemoveCrumbler((crumble_t *)th);
+						P_RemoveThinker(th);
 						sectors[secnum].floordata = NULL;
 						sectors[secnum].floorspeed = 0;
 					}
@@ -3478,7 +3511,7 @@ boolean P_ProcessSpecial(activator_t *activator, INT16 special, INT32 *args, cha
 					}
 
 					mo->player->roundconditions.unlocktriggers |= flag;
-					mo->player->roundconditions.checkthisframe = true;
+					mo->player->roundconditions.checkthisframe |= UCD_TRIGGER;
 				}
 			}
 			break;
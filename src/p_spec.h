@@ -569,6 +569,7 @@ void P_FreeQuake(quake_t *remove);
 
 // at game start
 void P_InitPicAnims(void);
+void P_MarkAnimatedTextures(char *texturepresent);
 
 // at map load (sectors)
 void P_SetupLevelFlatAnims(void);
@@ -916,6 +917,7 @@ struct crumble_t
 	fixed_t floorwasheight; // Height the floor WAS at
 	fixed_t ceilingwasheight; // Height the ceiling WAS at
 	UINT8 flags;
+	crumble_t *next; // in sector->crumblers
 };
 
 struct noenemies_t
@@ -1063,6 +1065,8 @@ void T_MoveElevator(elevator_t *elevator);
 void T_ContinuousFalling(continuousfall_t *faller);
 void T_BounceCheese(bouncecheese_t *bouncer);
 void T_StartCrumble(crumble_t *crumble);
+void P_AddCrumbler(crumble_t *crumble);
+void P_RemoveCrumbler(crumble_t *crumble);
 void T_MarioBlock(mariothink_t *block);
 void T_FloatSector(floatthink_t *floater);
 void T_MarioBlockChecker(mariocheck_t *block);
@@ -454,6 +454,12 @@ void P_UnlinkThinker(thinker_t *thinker)
 		((mobj_t *)thinker)->hnext = mobjcache;
 		mobjcache = (mobj_t *)thinker;
 	}
+	else if (thinker->function.acp1 == (actionf_p1)P_NullPrecipThinker)
+	{
+		// precipmobjs are carved out of larger blocks, see P_SpawnPrecipMobj
+		((precipmobj_t *)thinker)->bnext = precipcache;
+		precipcache = (precipmobj_t *)thinker;
+	}
 	else
 	{
 		Z_Free(thinker);
@@ -921,6 +927,8 @@ void P_Ticker(boolean run)
 
 		ps_lua_mobjhooks = 0;
 		ps_checkposition_calls = 0;
+		ps_sweep_moves = 0;
+		ps_sweep_culled = 0;
 
 		LUA_HOOK(PreThinkFrame);
 
@@ -1359,6 +1367,9 @@ void P_Ticker(boolean run)
 
 	if (run)
 	{
+		P_FlushPrecipRecalc();
+		P_BuildBlockSnapshot();
+
 		R_UpdateLevelInterpolators();
 
 		// Hack: ensure newview is assigned every tic.
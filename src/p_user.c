@@ -470,7 +470,7 @@ INT32 P_GivePlayerRings(player_t *player, INT32 num_rings)
 		&& player->rings < 0)
 	{
 		player->roundconditions.debt_rings = true;
-		player->roundconditions.checkthisframe = true;
+		player->roundconditions.checkthisframe |= UCD_RINGDEBT;
 	}
 
 	return num_rings;
@@ -1231,7 +1231,7 @@ void P_DoPlayerExit(player_t *player, pflags_t flags)
 	if (P_IsPartyPlayer(player) && (!player->spectator && !demo.playback))
 	{
 		legitimateexit = true;
-		player->roundconditions.checkthisframe = true;
+		player->roundconditions.checkthisframe |= UCD_FINISH;
 		gamedata->deferredconditioncheck = true;
 	}
 
@@ -3890,7 +3890,7 @@ void P_DoTimeOver(player_t *player)
 	if (P_IsPartyPlayer(player) && !demo.playback)
 	{
 		legitimateexit = true; // SRB2kart: losing a race is still seeing it through to the end :p
-		player->roundconditions.checkthisframe = true;
+		player->roundconditions.checkthisframe |= UCD_FINISH;
 		gamedata->deferredconditioncheck = true;
 	}
 
@@ -4183,6 +4183,7 @@ void P_PlayerThink(player_t *player)
 		player->respawn.pointz = player->mo->z;
 
 		player->pflags |= PF_LOSTLIFE|PF_ELIMINATED|PF_NOCONTEST;
+		player->roundconditions.checkthisframe |= UCD_FINISH;
 		player->realtime = UINT32_MAX;
 		K_InitPlayerTally(player);
 	}
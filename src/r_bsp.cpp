@@ -15,7 +15,7 @@
 #include <algorithm>
 #include <vector>
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "command.h"
 #include "doomdef.h"
@@ -908,7 +908,7 @@ static void R_Subsector(size_t num)
 	fixed_t floorcenterz, ceilingcenterz;
 	ffloor_t *rover;
 
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	// subsectors added at run-time
 	if (num >= numsubsectors)
@@ -1187,21 +1187,38 @@ void R_PrecacheLevel(void)
 			texturepresent[sides[j].bottomtexture] = 1;
 	}
 
+	// Textures used as flats are drawn from the composite too.
+	for (j = 0; j < numlevelflats; j++)
+	{
+		if (levelflats[j].type == LEVELFLAT_TEXTURE)
+			texturepresent[levelflats[j].u.texture.num] = 1;
+	}
+
 	// Sky texture is always present.
 	// Note that F_SKY1 is the name used to indicate a sky floor/ceiling as a flat,
 	// while the sky texture is stored like a wall texture, with a texture name set by the map.
 	texturepresent[skytexture] = 1;
 
+	// So are the other frames of any animation that is.
+	P_MarkAnimatedTextures(texturepresent);
+
 	texturememory = 0;
-	for (j = 0; j < (unsigned)numtextures; j++)
 	{
-		if (!texturepresent[j])
-			continue;
+		INT32 *texnums = malloc(numtextures * sizeof (*texnums));
+		size_t count = 0;
+
+		if (texnums == NULL) I_Error("%s: Out of memory looking up textures", "R_PrecacheLevel");
+
+		for (j = 0; j < (unsigned)numtextures; j++)
+		{
+			if (texturepresent[j] && !texturecache[j])
+				texnums[count++] = (INT32)j;
+		}
 
-		if (!texturecache[j])
-			R_GenerateTexture(j);
 		// pre-caching individual patches that compose textures became obsolete,
 		// since we cache entire composite textures
+		R_GenerateTextures(texnums, count);
+		free(texnums);
 	}
 	free(texturepresent);
 
@@ -506,6 +506,7 @@ struct sector_t
 	INT32 floorlightsec, ceilinglightsec; // take floor/ceiling light level from another sector
 
 	INT32 crumblestate; // used for crumbling and bobbing
+	crumble_t *crumblers; // T_StartCrumble thinkers for this sector, oldest first
 
 	// list of mobjs that are at least partially in the sector
 	// thinglist is a subset of touching_thinglist
@@ -551,6 +552,7 @@ struct sector_t
 
 	// list of precipitation mobjs in sector
 	mprecipsecnode_t *touching_preciplist;
+	boolean precipdirty; // queued for P_FlushPrecipRecalc
 
 	// Eternity engine slope
 	pslope_t *f_slope; // floor slope
@@ -36,7 +36,7 @@
 #include "hardware/hw_main.h"
 #endif
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 // --------------------------------------------
 // assembly or c drawer routines for 8bpp/16bpp
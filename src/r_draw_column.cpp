@@ -311,7 +311,7 @@ static void R_DrawColumnTemplate(drawcolumndata_t *dc)
 #define DEFINE_COLUMN_FUNC(name, flags) \
 	void name(drawcolumndata_t *dc) \
 	{ \
-		ZoneScoped; \
+		ZoneScopedLeaf; \
 		constexpr DrawColumnType opt = static_cast<DrawColumnType>(flags); \
 		R_DrawColumnTemplate<opt>(dc); \
 	}
@@ -330,7 +330,7 @@ DEFINE_COLUMN_COMBO(R_Draw2sMultiPatchTranslucentColumn, DC_HOLES|DC_TRANSMAP)
 
 void R_DrawFogColumn(drawcolumndata_t *dc)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	INT32 count;
 	UINT8 *dest;
@@ -362,7 +362,7 @@ void R_DrawFogColumn(drawcolumndata_t *dc)
 
 void R_DrawDropShadowColumn(drawcolumndata_t *dc)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	// Hack: A cut-down copy of R_DrawTranslucentColumn_8 that does not read texture
 	// data since something about calculating the texture reading address for drop shadows is broken.
@@ -395,7 +395,7 @@ void R_DrawDropShadowColumn(drawcolumndata_t *dc)
 
 void R_DrawColumn_Flat(drawcolumndata_t *dc)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	INT32 count;
 	UINT8 color = dc->lightmap[dc->r8_flatcolor];
@@ -740,7 +740,7 @@ static void R_DrawTiltedNPO2SpanTemplate(drawspandata_t* ds)
 #define DEFINE_SPAN_FUNC(name, flags, template) \
 	void name(drawspandata_t* ds) \
 	{ \
-		ZoneScoped; \
+		ZoneScopedLeaf; \
 		constexpr DrawSpanType opt = static_cast<DrawSpanType>(flags); \
 		template<opt>(ds); \
 	}
@@ -765,7 +765,7 @@ DEFINE_SPAN_COMBO(R_DrawTranslucentWaterSpan, DS_TRANSMAP|DS_RIPPLE)
 
 void R_DrawFogSpan(drawspandata_t* ds)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	UINT8 *colormap;
 	UINT8 *dest;
@@ -799,7 +799,7 @@ void R_DrawFogSpan(drawspandata_t* ds)
 
 void R_DrawFogSpan_Tilted(drawspandata_t* ds)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	// x1, x2 = ds_x1, ds_x2
 	int width = ds->x2 - ds->x1;
@@ -831,7 +831,7 @@ void R_DrawFogSpan_Tilted(drawspandata_t* ds)
 
 void R_DrawSpan_Flat(drawspandata_t* ds)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	UINT8 *dest = ylookup[ds->y] + columnofs[ds->x1];
 	memset(dest, ds->colormap[ds->r8_flatcolor], (ds->x2 - ds->x1) + 1);
@@ -839,7 +839,7 @@ void R_DrawSpan_Flat(drawspandata_t* ds)
 
 void R_DrawTiltedSpan_Flat(drawspandata_t* ds)
 {
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	// x1, x2 = ds_x1, ds_x2
 	int width = ds->x2 - ds->x1;
@@ -319,7 +319,8 @@ void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjst
 	out->spritexoffset = R_LerpFixed(mobj->old_spritexoffset, mobj->spritexoffset, frac);
 	out->spriteyoffset = R_LerpFixed(mobj->old_spriteyoffset, mobj->spriteyoffset, frac);
 
-	out->subsector = R_PointInSubsector(out->x, out->y);
+	// Precipitation never moves sideways
+	out->subsector = mobj->subsector;
 
 	out->angle = R_LerpAngle(mobj->old_angle, mobj->angle, frac);
 }
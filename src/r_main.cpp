@@ -1127,16 +1127,224 @@ void R_Init(void)
 	framecount = 0;
 }
 
+//
+// Subsector grid
+// A uniform grid over the blockmap, built at level load. Each cell keeps
+// the deepest BSP node (or the subsector) whose partitions do not split
+// it, so point lookups skip straight past the top of the tree.
+//
+
+#define SSGRIDSHIFT (FRACBITS+6) // 64 units per cell
+#define SSGRIDMAXCELLS (1<<20)
+
+static UINT16 *ssgrid;
+static INT32 ssgridshift;
+static fixed_t ssgridorgx, ssgridorgy;
+static INT32 ssgridwidth, ssgridheight;
+
+// Which side R_PointOnSide picks for every point of an inclusive box, given
+// relative to the partition origin and not crossing either of its axes.
+// Returns -1 if the points do not all agree.
+static INT32 R_QuadrantOnNodeSide(const node_t *node, INT64 x0, INT64 y0, INT64 x1, INT64 y1)
+{
+	// R_PointOnSide would overflow here
+	if (x0 < INT32_MIN || x1 > INT32_MAX || y0 < INT32_MIN || y1 > INT32_MAX)
+		return -1;
+
+	// The sign bits are the same for the whole quadrant
+	if ((node->dy ^ node->dx ^ (INT32)x0 ^ (INT32)y0) < 0)
+		return (node->dy ^ (INT32)x0) < 0;
+
+	// Otherwise it compares FixedMul(y, dx) against FixedMul(dy, x), both
+	// rounded down, which is settled by the sign of the exact difference.
+	// That difference is linear, so its range is found at the corners.
+	const INT64 ndx = node->dx>>FRACBITS;
+	const INT64 ndy = node->dy>>FRACBITS;
+	const INT64 corners[4] = {
+		y0 * ndx - ndy * x0,
+		y0 * ndx - ndy * x1,
+		y1 * ndx - ndy * x0,
+		y1 * ndx - ndy * x1,
+	};
+	const INT64 lo = *std::min_element(corners, corners + 4);
+	const INT64 hi = *std::max_element(corners, corners + 4);
+
+	if (lo >= 0)
+		return 1;
+
+	if (hi <= -FRACUNIT)
+		return 0;
+
+	return -1;
+}
+
+static INT32 R_BoxOnNodeSide(const node_t *node, fixed_t x0, fixed_t y0, fixed_t x1, fixed_t y1)
+{
+	if (!node->dx)
+	{
+		if (x1 <= node->x)
+			return node->dy > 0;
+		if (x0 > node->x)
+			return node->dy < 0;
+		return -1;
+	}
+
+	if (!node->dy)
+	{
+		if (y1 <= node->y)
+			return node->dx < 0;
+		if (y0 > node->y)
+			return node->dx > 0;
+		return -1;
+	}
+
+	const INT64 rx[2] = {(INT64)x0 - node->x, (INT64)x1 - node->x};
+	const INT64 ry[2] = {(INT64)y0 - node->y, (INT64)y1 - node->y};
+	INT32 side = -1;
+
+	// Split the box on the partition origin's axes
+	for (INT32 i = 0; i < 2; i++)
+	{
+		const INT64 qx0 = i ? std::max<INT64>(rx[0], 0) : rx[0];
+		const INT64 qx1 = i ? rx[1] : std::min<INT64>(rx[1], -1);
+
+		if (qx0 > qx1)
+			continue;
+
+		for (INT32 j = 0; j < 2; j++)
+		{
+			const INT64 qy0 = j ? std::max<INT64>(ry[0], 0) : ry[0];
+			const INT64 qy1 = j ? ry[1] : std::min<INT64>(ry[1], -1);
+
+			if (qy0 > qy1)
+				continue;
+
+			const INT32 s = R_QuadrantOnNodeSide(node, qx0, qy0, qx1, qy1);
+
+			if (s == -1 || (side != -1 && s != side))
+				return -1;
+
+			side = s;
+		}
+	}
+
+	return side;
+}
+
+static void R_FillSubsectorGrid(INT32 cx0, INT32 cy0, INT32 cx1, INT32 cy1, UINT16 nodenum)
+{
+	// Cells past the edge of fixed_t space get clamped, no point can be there anyway
+	const fixed_t x0 = (fixed_t)std::min<INT64>((INT64)ssgridorgx + ((INT64)cx0 << ssgridshift), INT32_MAX);
+	const fixed_t y0 = (fixed_t)std::min<INT64>((INT64)ssgridorgy + ((INT64)cy0 << ssgridshift), INT32_MAX);
+	const fixed_t x1 = (fixed_t)std::min<INT64>((INT64)ssgridorgx + ((INT64)cx1 << ssgridshift) - 1, INT32_MAX);
+	const fixed_t y1 = (fixed_t)std::min<INT64>((INT64)ssgridorgy + ((INT64)cy1 << ssgridshift) - 1, INT32_MAX);
+
+	while (!(nodenum & NF_SUBSECTOR))
+	{
+		const INT32 side = R_BoxOnNodeSide(&nodes[nodenum], x0, y0, x1, y1);
+
+		if (side == -1)
+			break;
+
+		nodenum = nodes[nodenum].children[side];
+	}
+
+	if ((nodenum & NF_SUBSECTOR) || (cx1 - cx0 == 1 && cy1 - cy0 == 1))
+	{
+		for (INT32 cy = cy0; cy < cy1; cy++)
+			std::fill(&ssgrid[cy * ssgridwidth + cx0], &ssgrid[cy * ssgridwidth + cx1], nodenum);
+		return;
+	}
+
+	// Still undecided, halve the area and carry on from here
+	if (cx1 - cx0 >= cy1 - cy0)
+	{
+		const INT32 mid = (cx0 + cx1) / 2;
+		R_FillSubsectorGrid(cx0, cy0, mid, cy1, nodenum);
+		R_FillSubsectorGrid(mid, cy0, cx1, cy1, nodenum);
+	}
+	else
+	{
+		const INT32 mid = (cy0 + cy1) / 2;
+		R_FillSubsectorGrid(cx0, cy0, cx1, mid, nodenum);
+		R_FillSubsectorGrid(cx0, mid, cx1, cy1, nodenum);
+	}
+}
+
+//
+// R_BuildSubsectorGrid
+// Called after the BSP and blockmap are loaded.
+//
+void R_BuildSubsectorGrid(void)
+{
+	if (ssgrid) // normally already gone with the rest of PU_LEVEL
+		Z_Free(ssgrid);
+
+	if (numnodes == 0 || bmapwidth <= 0 || bmapheight <= 0)
+		return;
+
+	const INT64 w = (INT64)bmapwidth << MAPBLOCKSHIFT;
+	const INT64 h = (INT64)bmapheight << MAPBLOCKSHIFT;
+
+	ssgridshift = SSGRIDSHIFT;
+
+	while (((w >> ssgridshift) + 1) * ((h >> ssgridshift) + 1) > SSGRIDMAXCELLS)
+		ssgridshift++;
+
+	ssgridorgx = bmaporgx;
+	ssgridorgy = bmaporgy;
+	ssgridwidth = (INT32)((w + (1 << ssgridshift) - 1) >> ssgridshift);
+	ssgridheight = (INT32)((h + (1 << ssgridshift) - 1) >> ssgridshift);
+
+	Z_Malloc(ssgridwidth * ssgridheight * sizeof (*ssgrid), PU_LEVEL, &ssgrid);
+
+	R_FillSubsectorGrid(0, 0, ssgridwidth, ssgridheight, numnodes-1);
+}
+
+// Where to start walking the BSP from for this point
+static inline size_t R_SubsectorGridNode(fixed_t x, fixed_t y)
+{
+	if (ssgrid)
+	{
+		const INT64 cx = ((INT64)x - ssgridorgx) >> ssgridshift;
+		const INT64 cy = ((INT64)y - ssgridorgy) >> ssgridshift;
+
+		if (cx >= 0 && cx < ssgridwidth && cy >= 0 && cy < ssgridheight)
+			return ssgrid[cy * ssgridwidth + cx];
+	}
+
+	return numnodes-1;
+}
+
+static size_t R_CheckSubsectorGrid(fixed_t x, fixed_t y, size_t nodenum)
+{
+	size_t bspnum = numnodes-1;
+
+	while (!(bspnum & NF_SUBSECTOR))
+		bspnum = nodes[bspnum].children[R_PointOnSide(x, y, nodes+bspnum)];
+
+	if (bspnum != nodenum)
+	{
+		CONS_Alert(CONS_ERROR, "Subsector grid found subsector %s at (%d, %d), BSP says %s\n",
+			sizeu1(nodenum & ~NF_SUBSECTOR), x>>FRACBITS, y>>FRACBITS, sizeu2(bspnum & ~NF_SUBSECTOR));
+	}
+
+	return bspnum;
+}
+
 //
 // R_PointInSubsector
 //
 subsector_t *R_PointInSubsector(fixed_t x, fixed_t y)
 {
-	size_t nodenum = numnodes-1;
+	size_t nodenum = R_SubsectorGridNode(x, y);
 
 	while (!(nodenum & NF_SUBSECTOR))
 		nodenum = nodes[nodenum].children[R_PointOnSide(x, y, nodes+nodenum)];
 
+	if (cv_debugsubsectorgrid.value && ssgrid)
+		nodenum = R_CheckSubsectorGrid(x, y, nodenum);
+
 	return &subsectors[nodenum & ~NF_SUBSECTOR];
 }
 
@@ -1155,7 +1363,7 @@ subsector_t *R_PointInSubsectorOrNull(fixed_t x, fixed_t y)
 	if (numnodes == 0)
 		return subsectors;
 
-	nodenum = numnodes - 1;
+	nodenum = R_SubsectorGridNode(x, y);
 
 	while (!(nodenum & NF_SUBSECTOR))
 	{
@@ -1509,6 +1717,8 @@ void R_RenderPlayerView(void)
 	framecount++;
 	validcount++;
 
+	R_FinishTextureRequests();
+
 	memset(&g_renderstats, 0, sizeof g_renderstats);
 
 	// Clear buffers.
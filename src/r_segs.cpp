@@ -14,7 +14,7 @@
 
 #include <limits>
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "command.h"
 #include "doomdef.h"
@@ -1828,7 +1828,7 @@ void R_StoreWallRange(INT32 start, INT32 stop)
 	const bool wantremap = encoremap && !(curline->linedef->flags & ML_TFERLINE);
 	drawcolumndata_t dc {0};
 
-	ZoneScoped;
+	ZoneScopedLeaf;
 
 	maskedtextureheight = NULL;
 	//initialize segleft and segright
@@ -297,175 +297,225 @@ static boolean R_CheckTextureLumpLength(texture_t *texture, size_t patch)
 }
 
 //
-// R_GenerateTexture
+// Texture generation
 //
 // Allocate space for full size texture, either single patch or 'composite'
 // Build the full textures from patches.
 // The texture caching system is a little more hungry of memory, but has
 // been simplified for the sake of highcolor (lol), dynamic ligthing, & speed.
 //
-// This is not optimised, but it's supposed to be executed only once
-// per level, when enough memory is available.
+// Generating is split in three so the compositing can run on the thread
+// pool. R_PrepareTextureJob does everything that touches the zone heap or
+// the WAD cache, R_ComposeTextureJob only reads the patches and writes a
+// block of its own, so it is safe on any thread, and R_FinishTextureJob
+// puts the result in texturecache. Generated textures are malloc'd rather
+// than zone allocated and are freed by R_FlushTextureCache.
 //
-UINT8 *R_GenerateTexture(size_t texnum)
+struct texturejob_t
 {
-	UINT8 *block;
-	UINT8 *blocktex;
+	INT32 texnum;
 	texture_t *texture;
-	texpatch_t *patch;
-	softwarepatch_t *realpatch;
-	UINT8 *pdata;
-	int x, x1, x2, i, width, height;
+
+	boolean dummy; // the only patch is too small to be a patch
+	boolean packed; // single patch in Doom format, kept as is if it has holes
+
+	softwarepatch_t **patches; // every patch, in Doom format
+	size_t *lengths;
+	boolean *converted; // patches[i] was converted and has to be freed
+
+	// Output
+	UINT8 *block;
 	size_t blocksize;
-	column_t *patchcol;
-	UINT8 *colofs;
+	size_t colofs; // offset of the column lookup in block
+	boolean holes;
+	UINT8 flip;
+};
 
-	UINT16 wadnum;
-	lumpnum_t lumpnum;
-	size_t lumplength;
+texturejob_t *R_PrepareTextureJob(INT32 texnum)
+{
+	texture_t *texture;
+	texturejob_t *job;
+	size_t n;
+	INT32 i;
 
-	I_Assert(texnum <= (size_t)numtextures);
+	I_Assert(texnum <= numtextures);
 	texture = textures[texnum];
 	I_Assert(texture != NULL);
 
-	// allocate texture column offset lookup
+	n = texture->patchcount;
+	job = calloc(1, sizeof (*job) + n * (sizeof (*job->patches) + sizeof (*job->lengths) + sizeof (*job->converted)));
 
-	// single-patch textures can have holes in them and may be used on
-	// 2sided lines so they need to be kept in 'packed' format
-	// BUT this is wrong for skies and walls with over 255 pixels,
-	// so check if there's holes and if not strip the posts.
-	if (texture->patchcount == 1)
-	{
-		boolean holey = false;
-		patch = texture->patches;
+	if (job == NULL)
+		I_Error("R_PrepareTextureJob: out of memory");
 
-		wadnum = patch->wad;
-		lumpnum = patch->lump;
-		lumplength = W_LumpLengthPwad(wadnum, lumpnum);
+	job->patches = (softwarepatch_t **)(job + 1);
+	job->lengths = (size_t *)(job->patches + n);
+	job->converted = (boolean *)(job->lengths + n);
 
-		// The header does not exist
-		if (R_CheckTextureLumpLength(texture, 0) == false)
-		{
-			block = R_AllocateDummyTextureBlock(texture->width, &texturecache[texnum]);
-			texturecolumnofs[texnum] = (UINT32*)&block[4];
-			textures[texnum]->holes = true;
-			return block;
-		}
+	job->texnum = texnum;
+	job->texture = texture;
+	job->flip = texture->flip;
 
-		pdata = W_CacheLumpNumPwad(wadnum, lumpnum, PU_LEVEL);
-		realpatch = (softwarepatch_t *)pdata;
+	if (texture->patchcount == 1 && R_CheckTextureLumpLength(texture, 0) == false)
+	{
+		job->dummy = true;
+		return job;
+	}
+
+	for (i = 0; i < texture->patchcount; i++)
+	{
+		texpatch_t *patch = &texture->patches[i];
+		UINT8 *pdata = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_LEVEL);
+		size_t lumplength = W_LumpLengthPwad(patch->wad, patch->lump);
+		softwarepatch_t *realpatch = (softwarepatch_t *)pdata;
 
 #ifndef NO_PNG_LUMPS
-		if (Picture_IsLumpPNG((UINT8 *)realpatch, lumplength))
-			goto multipatch;
+		if (Picture_IsLumpPNG(pdata, lumplength))
+		{
+			realpatch = (softwarepatch_t *)Picture_PNGConvert(pdata, PICFMT_DOOMPATCH, NULL, NULL, NULL, NULL, lumplength, NULL, 0);
+			job->converted[i] = true;
+		}
+		else
 #endif
 #ifdef WALLFLATS
 		if (texture->type == TEXTURETYPE_FLAT)
-			goto multipatch;
+		{
+			realpatch = (softwarepatch_t *)Picture_Convert(PICFMT_FLAT, pdata, PICFMT_DOOMPATCH, 0, NULL, texture->width, texture->height, 0, 0, 0);
+			job->converted[i] = true;
+		}
+		else
 #endif
+		{
+			;
+		}
+
+		job->patches[i] = realpatch;
+		job->lengths[i] = lumplength;
+	}
+
+	job->packed = (texture->patchcount == 1 && !job->converted[0]);
+
+	return job;
+}
 
-		// Check the patch for holes.
-		if (texture->width > SHORT(realpatch->width) || texture->height > SHORT(realpatch->height))
-			holey = true;
-		colofs = (UINT8 *)realpatch->columnofs;
-		for (x = 0; x < texture->width && !holey; x++)
+// single-patch textures can have holes in them and may be used on
+// 2sided lines so they need to be kept in 'packed' format
+// BUT this is wrong for skies and walls with over 255 pixels,
+// so check if there's holes and if not strip the posts.
+static boolean R_TexturePatchHasHoles(const texture_t *texture, softwarepatch_t *realpatch)
+{
+	UINT8 *colofs;
+	INT32 x;
+
+	if (texture->width > SHORT(realpatch->width) || texture->height > SHORT(realpatch->height))
+		return true;
+
+	colofs = (UINT8 *)realpatch->columnofs;
+	for (x = 0; x < texture->width; x++)
+	{
+		column_t *col = (column_t *)((UINT8 *)realpatch + LONG(*(UINT32 *)&colofs[x<<2]));
+		INT32 topdelta, prevdelta = -1, y = 0;
+		while (col->topdelta != 0xff)
 		{
-			column_t *col = (column_t *)((UINT8 *)realpatch + LONG(*(UINT32 *)&colofs[x<<2]));
-			INT32 topdelta, prevdelta = -1, y = 0;
-			while (col->topdelta != 0xff)
-			{
-				topdelta = col->topdelta;
-				if (topdelta <= prevdelta)
-					topdelta += prevdelta;
-				prevdelta = topdelta;
-				if (topdelta > y)
-					break;
-				y = topdelta + col->length + 1;
-				col = (column_t *)((UINT8 *)col + col->length + 4);
-			}
-			if (y < texture->height)
-				holey = true; // this texture is HOLEy! D:
+			topdelta = col->topdelta;
+			if (topdelta <= prevdelta)
+				topdelta += prevdelta;
+			prevdelta = topdelta;
+			if (topdelta > y)
+				break;
+			y = topdelta + col->length + 1;
+			col = (column_t *)((UINT8 *)col + col->length + 4);
 		}
+		if (y < texture->height)
+			return true; // this texture is HOLEy! D:
+	}
+
+	return false;
+}
+
+void R_ComposeTextureJob(texturejob_t *job)
+{
+	texture_t *texture = job->texture;
+	texpatch_t *patch;
+	softwarepatch_t *realpatch;
+	UINT8 *block;
+	UINT8 *colofs;
+	int x, x1, x2, i, width, height;
+	column_t *patchcol;
+
+	if (job->dummy)
+	{
+		// Allocate dummy data. Keep 4-bytes aligned.
+		// Column offsets will be initialized to 0, which points to the 0xff byte (empty column flag).
+		job->blocksize = 4 + (texture->width * 4);
+		job->block = block = calloc(1, job->blocksize);
+		if (block == NULL)
+			return;
+
+		block[0] = 0xff;
+		job->colofs = 4;
+		job->holes = true;
+		return;
+	}
+
+	// If the patch uses transparency, we have to save it this way.
+	if (job->packed && R_TexturePatchHasHoles(texture, job->patches[0]))
+	{
+		realpatch = job->patches[0];
+		patch = texture->patches;
 
-		// If the patch uses transparency, we have to save it this way.
-		if (holey)
+		job->holes = true;
+		job->flip = patch->flip;
+		job->blocksize = job->lengths[0];
+		job->block = block = malloc(job->blocksize);
+		if (block == NULL)
+			return;
+
+		M_Memcpy(block, realpatch, job->blocksize);
+
+		// use the patch's column lookup
+		colofs = (block + 8);
+		job->colofs = 8;
+		if (patch->flip & 1) // flip the patch horizontally
 		{
-			texture->holes = true;
-			texture->flip = patch->flip;
-			blocksize = lumplength;
-			block = Z_Calloc(blocksize, PU_LEVEL, // will change tag at end of this function
-				&texturecache[texnum]);
-			M_Memcpy(block, realpatch, blocksize);
-			texturememory += blocksize;
-
-			// use the patch's column lookup
-			colofs = (block + 8);
-			texturecolumnofs[texnum] = (UINT32 *)colofs;
-			blocktex = block;
-			if (patch->flip & 1) // flip the patch horizontally
-			{
-				UINT8 *realcolofs = (UINT8 *)realpatch->columnofs;
-				for (x = 0; x < texture->width; x++)
-					*(UINT32 *)&colofs[x<<2] = realcolofs[( texture->width-1-x )<<2]; // swap with the offset of the other side of the texture
-			}
-			// we can't as easily flip the patch vertically sadly though,
-			//  we have wait until the texture itself is drawn to do that
+			UINT8 *realcolofs = (UINT8 *)realpatch->columnofs;
 			for (x = 0; x < texture->width; x++)
-				*(UINT32 *)&colofs[x<<2] = LONG(LONG(*(UINT32 *)&colofs[x<<2]) + 3);
-			goto done;
+				*(UINT32 *)&colofs[x<<2] = realcolofs[( texture->width-1-x )<<2]; // swap with the offset of the other side of the texture
 		}
-
-		// Otherwise, do multipatch format.
+		// we can't as easily flip the patch vertically sadly though,
+		//  we have wait until the texture itself is drawn to do that
+		for (x = 0; x < texture->width; x++)
+			*(UINT32 *)&colofs[x<<2] = LONG(LONG(*(UINT32 *)&colofs[x<<2]) + 3);
+		return;
 	}
 
 	// multi-patch textures (or 'composite')
-	multipatch:
-	texture->holes = false;
-	texture->flip = 0;
-	blocksize = (texture->width * 4) + (texture->width * texture->height);
-	texturememory += blocksize;
-	block = Z_Malloc(blocksize+1, PU_LEVEL, &texturecache[texnum]);
+	job->holes = false;
+	job->flip = 0;
+	job->blocksize = (texture->width * 4) + (texture->width * texture->height);
+	job->block = block = malloc(job->blocksize+1);
+	if (block == NULL)
+		return;
 
-	memset(block, TRANSPARENTPIXEL, blocksize+1); // Transparency hack
+	memset(block, TRANSPARENTPIXEL, job->blocksize+1); // Transparency hack
 
 	// columns lookup table
 	colofs = block;
-	texturecolumnofs[texnum] = (UINT32 *)colofs;
-
-	// texture data after the lookup table
-	blocktex = block + (texture->width*4);
+	job->colofs = 0;
 
 	// Composite the columns together.
 	for (i = 0, patch = texture->patches; i < texture->patchcount; i++, patch++)
 	{
-		boolean dealloc = true;
-		static void (*ColumnDrawerPointer)(column_t *, UINT8 *, texpatch_t *, INT32, INT32); // Column drawing function pointer.
+		void (*ColumnDrawerPointer)(column_t *, UINT8 *, texpatch_t *, INT32, INT32); // Column drawing function pointer.
 		if (patch->style != AST_COPY)
 			ColumnDrawerPointer = (patch->flip & 2) ? R_DrawBlendFlippedColumnInCache : R_DrawBlendColumnInCache;
 		else
 			ColumnDrawerPointer = (patch->flip & 2) ? R_DrawFlippedColumnInCache : R_DrawColumnInCache;
 
-		wadnum = patch->wad;
-		lumpnum = patch->lump;
-		pdata = W_CacheLumpNumPwad(wadnum, lumpnum, PU_LEVEL);
-		lumplength = W_LumpLengthPwad(wadnum, lumpnum);
-		realpatch = (softwarepatch_t *)pdata;
-		dealloc = true;
+		realpatch = job->patches[i];
 
-#ifndef NO_PNG_LUMPS
-		if (Picture_IsLumpPNG((UINT8 *)realpatch, lumplength))
-			realpatch = (softwarepatch_t *)Picture_PNGConvert((UINT8 *)realpatch, PICFMT_DOOMPATCH, NULL, NULL, NULL, NULL, lumplength, NULL, 0);
-		else
-#endif
-#ifdef WALLFLATS
-		if (texture->type == TEXTURETYPE_FLAT)
-			realpatch = (softwarepatch_t *)Picture_Convert(PICFMT_FLAT, pdata, PICFMT_DOOMPATCH, 0, NULL, texture->width, texture->height, 0, 0, 0);
-		else
-#endif
-		{
-			(void)lumplength;
-			dealloc = false;
-		}
+		if (realpatch == NULL)
+			continue; // failed to convert
 
 		x1 = patch->originx;
 		width = SHORT(realpatch->width);
@@ -473,18 +523,10 @@ UINT8 *R_GenerateTexture(size_t texnum)
 		x2 = x1 + width;
 
 		if (x1 > texture->width || x2 < 0)
-		{
-			if (dealloc)
-				Z_Free(realpatch);
 			continue; // patch not located within texture's x bounds, ignore
-		}
 
 		if (patch->originy > texture->height || (patch->originy + height) < 0)
-		{
-			if (dealloc)
-				Z_Free(realpatch);
 			continue; // patch not located within texture's y bounds, ignore
-		}
 
 		// patch is actually inside the texture!
 		// now check if texture is partly off-screen and adjust accordingly
@@ -510,13 +552,71 @@ UINT8 *R_GenerateTexture(size_t texnum)
 			*(UINT32 *)&colofs[x<<2] = LONG((x * texture->height) + (texture->width*4));
 			ColumnDrawerPointer(patchcol, block + LONG(*(UINT32 *)&colofs[x<<2]), patch, texture->height, height);
 		}
+	}
+}
+
+// Same as what R_GenerateTexture returns
+static UINT8 *R_TextureCacheData(INT32 texnum)
+{
+	const texture_t *texture = textures[texnum];
+
+	if (texture->holes)
+		return texturecache[texnum];
+
+	return texturecache[texnum] + (texture->width * 4);
+}
+
+UINT8 *R_FinishTextureJob(texturejob_t *job)
+{
+	const INT32 texnum = job->texnum;
+	texture_t *texture = job->texture;
+	INT32 i;
 
-		if (dealloc)
-			Z_Free(realpatch);
+	for (i = 0; i < texture->patchcount; i++)
+	{
+		if (job->converted[i])
+			Z_Free(job->patches[i]);
+	}
+
+	if (job->block == NULL)
+		I_Error("R_FinishTextureJob: out of memory generating %.8s", texture->name);
+
+	if (texturecache[texnum])
+	{
+		// Someone else got there first
+		free(job->block);
+	}
+	else
+	{
+		texturememory += job->blocksize;
+		texture->holes = job->holes;
+		texture->flip = job->flip;
+		texturecache[texnum] = job->block;
+		texturecolumnofs[texnum] = (UINT32 *)(job->block + job->colofs);
 	}
 
-done:
-	return blocktex;
+	free(job);
+
+	return R_TextureCacheData(texnum);
+}
+
+//
+// R_GenerateTexture
+//
+// Generates a texture right away, on the calling thread.
+// Must be the main thread.
+//
+UINT8 *R_GenerateTexture(size_t texnum)
+{
+	texturejob_t *job;
+
+	// Already being generated in the background
+	if (R_WaitTextureRequest(texnum))
+		return R_TextureCacheData(texnum);
+
+	job = R_PrepareTextureJob(texnum);
+	R_ComposeTextureJob(job);
+	return R_FinishTextureJob(job);
 }
 
 //
@@ -1114,15 +1214,20 @@ void R_CheckFlatLength(drawspandata_t* ds, size_t size)
 }
 
 //
-// Empty the texture cache (used for load wad at runtime)
+// Empty the texture cache. Generated textures are not in the zone heap,
+// so this has to go along with every PU_LEVEL purge.
 //
 void R_FlushTextureCache(void)
 {
 	INT32 i;
 
-	if (numtextures)
-		for (i = 0; i < numtextures; i++)
-			Z_Free(texturecache[i]);
+	R_WaitTextureRequests();
+
+	for (i = 0; i < numtextures; i++)
+	{
+		free(texturecache[i]);
+		texturecache[i] = NULL;
+	}
 }
 
 // Need these prototypes for later; defining them here instead of r_textures.h so they're "private"
@@ -1469,10 +1574,9 @@ static void R_AllocateTextures(INT32 add)
 
 	for (i = 0; i < numtextures; ++i)
 	{
-		// R_FlushTextureCache relies on the user for
-		// Z_Free, texturecache has been reallocated so the
-		// user is now garbage memory.
-		Z_SetUser(texturecache[i], (void**)&texturecache[i]);
+		// The purge relies on the user for Z_Free,
+		// texturebrightmapcache has been reallocated so
+		// the user is now garbage memory.
 		Z_SetUser(texturebrightmapcache[i], (void**)&texturebrightmapcache[i]);
 	}
 
@@ -96,6 +96,28 @@ boolean R_TextureCanRemap(INT32 texnum);
 void R_CheckTextureCache(INT32 tex);
 void R_ClearTextureNumCache(boolean btell);
 
+// Generating a texture in steps. Only R_ComposeTextureJob
+// may be called off the main thread.
+texturejob_t *R_PrepareTextureJob(INT32 texnum);
+void R_ComposeTextureJob(texturejob_t *job);
+UINT8 *R_FinishTextureJob(texturejob_t *job);
+
+// r_textures_async.cpp
+
+// Generate a batch of textures across the thread pool. Blocks until done.
+void R_GenerateTextures(const INT32 *texnums, size_t count);
+
+// Start generating a texture in the background, if it isn't already.
+void R_RequestTexture(INT32 texnum);
+
+// Put any textures that have finished generating in the cache. Doesn't block.
+void R_FinishTextureRequests(void);
+
+// If texnum is being generated in the background, wait for it and return true.
+boolean R_WaitTextureRequest(INT32 texnum);
+
+void R_WaitTextureRequests(void);
+
 // Retrieve texture data.
 void *R_GetLevelFlat(drawspandata_t* ds, levelflat_t *levelflat);
 UINT8 *R_GetColumn(fixed_t tex, INT32 col);
@@ -0,0 +1,176 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_textures_async.cpp
+/// \brief Texture generation on the thread pool
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/thread_pool.h"
+#include "core/trace.h" // ZoneScoped
+#include "doomdef.h"
+#include "i_video.h" // rendermode
+#include "r_textures.h"
+
+namespace
+{
+
+struct Request
+{
+	texturejob_t* job;
+	std::atomic<bool> done {false};
+};
+
+// Only touched on the main thread. Workers just get the Request.
+std::unordered_map<INT32, std::unique_ptr<Request>> g_requests;
+
+void finish(INT32 texnum, Request& req)
+{
+	R_FinishTextureJob(req.job);
+	g_requests.erase(texnum);
+}
+
+void wait(Request& req)
+{
+	// The job may still be queued, so help out until it's done.
+	while (!req.done.load(std::memory_order_acquire))
+	{
+		srb2::g_main_threadpool->wait_idle();
+		std::this_thread::yield();
+	}
+}
+
+}; // namespace
+
+void R_GenerateTextures(const INT32 *texnums, size_t count)
+{
+	ZoneScoped;
+
+	if (!srb2::g_main_threadpool)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!texturecache[texnums[i]])
+			{
+				R_GenerateTexture(texnums[i]);
+			}
+		}
+		return;
+	}
+
+	std::vector<texturejob_t*> jobs;
+
+	jobs.reserve(count);
+
+	// Everything that touches the zone heap happens here, up front
+	for (size_t i = 0; i < count; i++)
+	{
+		const INT32 texnum = texnums[i];
+
+		if (texturecache[texnum] || R_WaitTextureRequest(texnum))
+		{
+			continue;
+		}
+
+		jobs.push_back(R_PrepareTextureJob(texnum));
+	}
+
+	srb2::g_main_threadpool->begin_sema();
+
+	for (texturejob_t* job : jobs)
+	{
+		srb2::g_main_threadpool->schedule([job] { R_ComposeTextureJob(job); });
+	}
+
+	srb2::ThreadPool::Sema sema = srb2::g_main_threadpool->end_sema();
+	srb2::g_main_threadpool->notify_sema(sema);
+	srb2::g_main_threadpool->wait_sema(sema);
+
+	for (texturejob_t* job : jobs)
+	{
+		R_FinishTextureJob(job);
+	}
+}
+
+void R_RequestTexture(INT32 texnum)
+{
+	if (texnum <= 0 || texnum >= numtextures || texturecache[texnum] || g_requests.count(texnum))
+	{
+		return;
+	}
+
+	// Also covers dedicated servers, which never draw anything.
+	// Without a pool, it'll just be generated when it's drawn.
+	if (rendermode != render_soft || !srb2::g_main_threadpool)
+	{
+		return;
+	}
+
+	auto req = std::make_unique<Request>();
+	Request* ptr = req.get();
+
+	req->job = R_PrepareTextureJob(texnum);
+	g_requests.emplace(texnum, std::move(req));
+
+	srb2::g_main_threadpool->schedule(
+		[ptr]
+		{
+			R_ComposeTextureJob(ptr->job);
+			ptr->done.store(true, std::memory_order_release);
+		}
+	);
+	srb2::g_main_threadpool->notify();
+}
+
+void R_FinishTextureRequests(void)
+{
+	for (auto it = g_requests.begin(); it != g_requests.end();)
+	{
+		Request& req = *it->second;
+
+		if (req.done.load(std::memory_order_acquire))
+		{
+			R_FinishTextureJob(req.job);
+			it = g_requests.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+boolean R_WaitTextureRequest(INT32 texnum)
+{
+	auto it = g_requests.find(texnum);
+
+	if (it == g_requests.end())
+	{
+		return false;
+	}
+
+	wait(*it->second);
+	finish(texnum, *it->second);
+
+	return true;
+}
+
+void R_WaitTextureRequests(void)
+{
+	while (!g_requests.empty())
+	{
+		auto it = g_requests.begin();
+
+		wait(*it->second);
+		finish(it->first, *it->second);
+	}
+}
@@ -41,6 +41,7 @@
 #include "m_cheat.h" // objectplace
 #include "p_local.h" // stplyr
 #include "core/thread_pool.h"
+#include "core/trace.h" // ZoneScoped
 #ifdef HWRENDER
 #include "hardware/hw_md2.h"
 #include "hardware/hw_glob.h"
@@ -2607,12 +2608,6 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	// uncapped/interpolation
 	interpmobjstate_t interp = {0};
 
-	// okay... this is a hack, but weather isn't networked, so it should be ok
-	if (!P_PrecipThinker(thing))
-	{
-		return;
-	}
-
 	// do interpolation
 	if (R_UsingFrameInterpolation() && !paused)
 	{
@@ -2853,9 +2848,12 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 void R_AddPrecipitationSprites(void)
 {
 	const fixed_t drawdist = cv_drawdist_precip.value * mapobjectscale;
+	const fixed_t minz = FixedMul(MINZ, mapobjectscale);
 
 	INT32 xl, xh, yl, yh, bx, by;
-	precipmobj_t *th, *next;
+	precipcell_t *cell;
+	precipmobj_t *th;
+	UINT32 i;
 
 	// no, no infinite draw distance for precipitation. this option at zero is supposed to turn it off
 	if (drawdist == 0)
@@ -2875,13 +2873,30 @@ void R_AddPrecipitationSprites(void)
 	{
 		for (by = yl; by <= yh; by++)
 		{
-			for (th = precipblocklinks[(by * bmapwidth) + bx]; th; th = next)
+			// okay... this is a hack, but weather isn't networked, so it should be ok
+			cell = &precipcells[(by * bmapwidth) + bx];
+			P_PrecipCellThinker(cell);
+
+			for (i = 0; i < cell->count; i++)
 			{
-				// Store this beforehand because R_ProjectPrecipitionSprite may free th (see P_PrecipThinker)
-				next = th->bnext;
+				// R_ProjectPrecipitationSprite's first two checks, without
+				// touching the precipmobj_t. Precipitation never moves
+				// sideways, so x and y need no interpolating.
+				const fixed_t tr_x = cell->x[i] - viewx;
+				const fixed_t tr_y = cell->y[i] - viewy;
+				const fixed_t tz = FixedMul(tr_x, viewcos) + FixedMul(tr_y, viewsin);
+
+				if (tz < minz)
+					continue;
+
+				if (abs(FixedMul(tr_x, viewsin) - FixedMul(tr_y, viewcos)) > FixedMul(tz, fovtan[viewssnum])<<2)
+					continue;
+
+				th = cell->mobjs[i];
 
 				if (R_PrecipThingVisible(th))
 				{
+					P_SyncPrecipMobj(th);
 					R_ProjectPrecipitationSprite(th);
 				}
 			}
@@ -24,6 +24,8 @@
 
 #include <tracy/tracy/Tracy.hpp>
 
+#include "../core/trace.h"
+
 #if defined (__GNUC__) || defined (__unix__)
 #include <unistd.h>
 #endif
@@ -276,6 +278,7 @@ int main(int argc, char **argv)
 	myargv = argv; /// \todo pull out path to exe from this string
 
 	tracy::SetThreadName("Main");
+	srb2::trace::set_thread_name("Main");
 
 #ifdef HAVE_TTF
 #ifdef _WIN32
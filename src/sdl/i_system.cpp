@@ -24,6 +24,8 @@
 /// \file
 /// \brief SRB2 system stuff for SDL
 
+#include <atomic>
+#include <exception>
 #include <thread>
 
 #include <signal.h>
@@ -170,8 +172,10 @@ static char returnWadPath[256];
 #include "../screen.h" //vid.WndParent
 #include "../d_net.h"
 #include "../g_game.h"
+#include "../g_gamedata.h"
 #include "../filesrch.h"
 #include "../s_sound.h"
+#include "../core/log_writer.hpp"
 #include "../core/thread_pool.h"
 #include "endtxt.h"
 #include "sdlmain.h"
@@ -427,6 +431,61 @@ static void I_ReportSignal(int num, int coredumped)
 	);
 }
 
+#ifdef LOGMESSAGES
+// Writes to logstream from its own thread, so printing to the
+// console never waits on the disk. Never deleted: something may
+// still be printing while the game shuts down.
+static srb2::LogWriter *logwriter;
+static std::atomic<bool> logwriteractive;
+#endif
+
+static void I_StartLogWriter(void)
+{
+#ifdef LOGMESSAGES
+	if (!logstream || logwriter || M_CheckParm("-synclog"))
+		return;
+
+	try
+	{
+		logwriter = new srb2::LogWriter(logstream);
+	}
+	catch (const std::exception&)
+	{
+		// No thread, keep writing directly.
+		return;
+	}
+
+	logwriteractive.store(true, std::memory_order_release);
+#endif
+}
+
+static void I_StopLogWriter(void)
+{
+#ifdef LOGMESSAGES
+	if (!logwriter)
+		return;
+
+	logwriteractive.store(false, std::memory_order_release);
+	logwriter->stop();
+
+	const srb2::LogWriter::Stats stats = logwriter->stats();
+
+	if (stats.dropped)
+	{
+		I_OutputMsg("I_StopLogWriter(): %s of %s messages were dropped (%s bytes)\n",
+			sizeu1((size_t)stats.dropped), sizeu2((size_t)(stats.written + stats.dropped)), sizeu3((size_t)stats.dropped_bytes));
+	}
+#endif
+}
+
+static void I_FlushLogWriter(void)
+{
+#ifdef LOGMESSAGES
+	if (logwriter)
+		logwriter->flush();
+#endif
+}
+
 #ifndef NEWSIGNALHANDLER
 FUNCNORETURN static ATTRNORETURN void signal_handler(INT32 num)
 {
@@ -440,8 +499,13 @@ FUNCNORETURN static ATTRNORETURN void signal_handler(INT32 num)
 		exit(-2);
 	}
 
+	// Get whatever was already logged onto disk before anything
+	// else has a chance to fail.
+	I_FlushLogWriter();
+
 	D_QuitNetGame(); // Fix server freezes
 	CL_AbortDownloadResume();
+	G_FinishSaves(); // before the dirty byte, which these would overwrite
 	G_DirtyGameData();
 #ifdef UNIXBACKTRACE
 	write_backtrace(num);
@@ -841,6 +905,7 @@ static void I_RegisterSignals (void)
 #ifdef NEWSIGNALHANDLER
 static void signal_handler_child(INT32 num)
 {
+	I_FlushLogWriter();
 	G_DirtyGameData();
 
 #ifdef UNIXBACKTRACE
@@ -887,7 +952,11 @@ void I_OutputMsg(const char *fmt, ...)
 	len = strlen(txt);
 
 #ifdef LOGMESSAGES
-	if (logstream)
+	if (logwriteractive.load(std::memory_order_acquire))
+	{
+		logwriter->write(txt, len);
+	}
+	else if (logstream)
 	{
 		size_t d = fwrite(txt, len, 1, logstream);
 		fflush(logstream);
@@ -1611,6 +1680,10 @@ INT32 I_StartupSystem(void)
 	if (!M_CheckParm("-nofork"))
 		I_Fork();
 #endif
+	I_StartLogWriter();
+	// Exit funcs run in reverse, so this stops after everything
+	// else has had its last say.
+	I_AddExitFunc(I_StopLogWriter);
 #ifdef HAVE_THREADS
 	I_start_threads();
 	I_AddExitFunc(I_stop_threads);
@@ -1649,6 +1722,7 @@ void I_Quit(void)
 		K_PlayerForfeit(consoleplayer, true);
 
 	G_SaveGameData(); // Tails 12-08-2002
+	G_FlushSaves();
 	//added:16-02-98: when recording a demo, should exit using 'q' key,
 	//        but sometimes we forget and use 'F10'.. so save here too.
 
@@ -1742,6 +1816,7 @@ void I_Error(const char *error, ...)
 			M_SaveConfig(NULL);
 			G_DirtyGameData(); // done first in case an error is in G_SaveGameData
 			G_SaveGameData();
+			G_FlushSaves();
 		}
 		if (errorcount > 20)
 		{
@@ -1779,6 +1854,7 @@ void I_Error(const char *error, ...)
 	M_SaveConfig(NULL); // save game config, cvars..
 	G_DirtyGameData(); // done first in case an error is in G_SaveGameData
 	G_SaveGameData(); // Tails 12-08-2002
+	G_FlushSaves();
 
 	// Shutdown. Here might be other errors.
 
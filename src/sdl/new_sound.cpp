@@ -13,7 +13,7 @@
 #include <memory>
 
 #include <SDL.h>
-#include <tracy/tracy/Tracy.hpp>
+#include "../core/trace.h" // ZoneScoped
 
 #include "../audio/chunk_load.hpp"
 #include "../audio/gain.hpp"
@@ -131,6 +131,7 @@ static const char* kAudio = "Audio";
 void audio_callback(void* userdata, Uint8* buffer, int len)
 {
 	tracy::SetThreadName("SDL Audio Thread");
+	srb2::trace::set_thread_name("SDL Audio Thread");
 	FrameMarkStart(kAudio);
 	ZoneScoped;
 
@@ -362,11 +362,7 @@ new_vertex_slope
 	//slope->refpos = 5;
 
 	// Add to the slope list
-	slope->next = slopelist;
-	slopelist = slope;
-
-	slopecount++;
-	slope->id = slopecount;
+	P_LinkSlope(slope);
 
 	return slope;
 }
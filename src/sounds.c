@@ -20,6 +20,7 @@
 #include "z_zone.h"
 #include "w_wad.h"
 #include "lua_script.h"
+#include "deh_symbols.h" // DEH_InvalidateSfx
 
 //
 // Information about all the sfx
@@ -1592,6 +1593,8 @@ void S_InitRuntimeSounds (void)
 		//strlcpy(S_sfx[i].caption, "", 1);
 		S_sfx[i].caption[0] = '\0';
 	}
+
+	DEH_InvalidateSfx();
 }
 
 sfxenum_t sfxfree = sfx_freeslot0;
@@ -1617,6 +1620,7 @@ sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean
 	if (i < NUMSFX)
 	{
 		strncpy(freeslotnames[i-sfx_freeslot0], name, 6);
+		DEH_InvalidateSfx();
 		S_sfx[i].singularity = singular;
 		S_sfx[i].priority = 60;
 		S_sfx[i].pitch = flags;
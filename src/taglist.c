@@ -332,6 +332,8 @@ void Taglist_InitGlobalTables(void)
 		for (j = 0; j < lines[i].tags.count; j++)
 			Taglist_AddToLines(lines[i].tags.tags[j], i);
 	}
+
+	Taglist_InvalidateLineSpecials();
 }
 
 // Iteration, ingame search.
@@ -346,24 +348,123 @@ INT32 Tag_Iterate_Lines (const mtag_t tag, const size_t p)
 	return Taggroup_Iterate(tags_lines, numlines, tag, p);
 }
 
+// Open-addressed (special, tag) -> first line table for Tag_FindLineSpecial.
+// Every line is also entered under MTAG_GLOBAL, so both kinds of search are a
+// single probe. Line tags are fixed after load, but specials are not: a special
+// being cleared is caught by checking the hit, and anything that gives a line
+// a new special calls Taglist_InvalidateLineSpecials.
+typedef struct
+{
+	UINT32 key;
+	INT32 line;
+} linespecialslot_t;
+
+static linespecialslot_t *linespecials;
+static UINT8 linespecialsbits;
+static boolean linespecialsvalid;
+
+#define LINESPECIALKEY(special, tag) (((UINT32)(UINT16)(special) << 16) | (UINT16)(tag))
+
+static linespecialslot_t *Taglist_LineSpecialSlot(const UINT32 key)
+{
+	const UINT32 mask = (1u << linespecialsbits) - 1;
+	UINT32 i = (UINT32)(key * 2654435769u) >> (32 - linespecialsbits);
+
+	while (linespecials[i].line != -1 && linespecials[i].key != key)
+		i = (i + 1) & mask;
+
+	return &linespecials[i];
+}
+
+static void Taglist_AddLineSpecial(const UINT32 key, const size_t id)
+{
+	linespecialslot_t *slot = Taglist_LineSpecialSlot(key);
+
+	// Lines are added in ascending order, so the first one stays.
+	if (slot->line != -1)
+		return;
+
+	slot->key = key;
+	slot->line = (INT32)id;
+}
+
+static void Taglist_BuildLineSpecials(void)
+{
+	size_t i, j;
+	size_t entries = 0;
+
+	for (i = 0; i < numlines; i++)
+		if (lines[i].special)
+			entries += 1 + lines[i].tags.count;
+
+	// Keep the load factor at or below one half.
+	linespecialsbits = 4;
+	while (((size_t)1 << linespecialsbits) < entries * 2 && linespecialsbits < 31)
+		linespecialsbits++;
+
+	Z_Free(linespecials);
+	Z_Malloc(sizeof(*linespecials) << linespecialsbits, PU_LEVEL, &linespecials);
+
+	for (i = 0; i < ((size_t)1 << linespecialsbits); i++)
+		linespecials[i].line = -1;
+
+	for (i = 0; i < numlines; i++)
+	{
+		if (!lines[i].special)
+			continue;
+
+		Taglist_AddLineSpecial(LINESPECIALKEY(lines[i].special, MTAG_GLOBAL), i);
+
+		for (j = 0; j < lines[i].tags.count; j++)
+			Taglist_AddLineSpecial(LINESPECIALKEY(lines[i].special, lines[i].tags.tags[j]), i);
+	}
+
+	linespecialsvalid = true;
+}
+
+/// Must be called whenever a line is given a new special after Taglist_InitGlobalTables.
+void Taglist_InvalidateLineSpecials(void)
+{
+	linespecialsvalid = false;
+}
+
 INT32 Tag_FindLineSpecial(const INT16 special, const mtag_t tag)
 {
 	size_t i;
+	INT32 line;
 
-	if (tag == MTAG_GLOBAL)
+	if (special == 0)
 	{
-		for (i = 0; i < numlines; i++)
-			if (lines[i].special == special)
-				return i;
+		// Lines without a special are not indexed.
+		if (tag == MTAG_GLOBAL)
+		{
+			for (i = 0; i < numlines; i++)
+				if (lines[i].special == special)
+					return i;
+		}
+		else if (tags_lines[(UINT16)tag])
+		{
+			taggroup_t *tagged = tags_lines[(UINT16)tag];
+			for (i = 0; i < tagged->count; i++)
+				if (lines[tagged->elements[i]].special == special)
+					return tagged->elements[i];
+		}
+		return -1;
 	}
-	else if (tags_lines[(UINT16)tag])
+
+	if (!linespecialsvalid || !linespecials)
+		Taglist_BuildLineSpecials();
+
+	line = Taglist_LineSpecialSlot(LINESPECIALKEY(special, tag))->line;
+
+	if (line != -1 && lines[line].special != special)
 	{
-		taggroup_t *tagged = tags_lines[(UINT16)tag];
-		for (i = 0; i < tagged->count; i++)
-			if (lines[tagged->elements[i]].special == special)
-				return tagged->elements[i];
+		// The first line has since lost its special; look again.
+		Taglist_BuildLineSpecials();
+		line = Taglist_LineSpecialSlot(LINESPECIALKEY(special, tag))->line;
 	}
-	return -1;
+
+	return line;
 }
 
 /// Backwards compatibility iteration function for Lua scripts.
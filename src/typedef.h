@@ -252,6 +252,10 @@ TYPEDEF (midVoteGUI_t);
 TYPEDEF (mapUserProperty_t);
 TYPEDEF (mapUserProperties_t);
 
+// lua_alloc.h
+TYPEDEF (luaallocator_t);
+TYPEDEF (luaallocstats_t);
+
 // lua_hudlib_drawlist.h
 typedef struct huddrawlist_s *huddrawlist_h;
 
@@ -301,10 +305,12 @@ TYPEDEF (BasicFF_t);
 TYPEDEF (divline_t);
 TYPEDEF (intercept_t);
 TYPEDEF (opening_t);
+TYPEDEF (blocksnapthing_t);
 
 // p_mobj.h
 TYPEDEF (mobj_t);
 TYPEDEF (precipmobj_t);
+TYPEDEF (precipcell_t);
 TYPEDEF (actioncache_t);
 
 // p_polyobj.h
@@ -429,6 +435,7 @@ TYPEDEF (sprcache_t);
 // r_textures.h
 TYPEDEF (texpatch_t);
 TYPEDEF (texture_t);
+TYPEDEF (texturejob_t);
 
 // r_things.h
 TYPEDEF (maskcount_t);
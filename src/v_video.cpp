@@ -17,7 +17,7 @@
 #include <cmath>
 #include <optional>
 
-#include <tracy/tracy/Tracy.hpp>
+#include "core/trace.h" // ZoneScoped
 
 #include "doomdef.h"
 #include "r_local.h"
@@ -0,0 +1,630 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  w_filecache.cpp
+/// \brief Persistent addon MD5 cache, and an index of the search directories
+
+#include "w_filecache.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "core/thread_pool.h"
+#include "io/streams.hpp"
+#include "doomdef.h"
+#include "d_main.h" // srb2home, srb2path
+#include "md5.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace
+{
+
+constexpr const char* kCacheName = "addoncache.dat";
+constexpr uint32_t kCacheMagic = 0xADD0CAC4;
+constexpr uint8_t kCacheVersion = 2;
+
+// Same as findfile passes to filesearch: the start directory and 9 below it
+constexpr int kMaxDepth = 10;
+
+struct HashJson final
+{
+	std::string path;
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	std::array<uint8_t, 16> md5 {};
+
+	NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(HashJson, path, size, mtime, md5)
+};
+
+struct EntryJson final
+{
+	std::string name;
+	bool dir = false;
+
+	NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(EntryJson, name, dir)
+};
+
+struct DirJson final
+{
+	std::string path;
+	int64_t mtime = 0;
+	std::vector<EntryJson> entries;
+
+	NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(DirJson, path, mtime, entries)
+};
+
+struct CacheJson final
+{
+	std::vector<HashJson> hashes;
+	std::vector<DirJson> dirs;
+
+	NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(CacheJson, hashes, dirs)
+};
+
+struct FileHash
+{
+	uint64_t size;
+	int64_t mtime;
+	std::array<uint8_t, 16> md5;
+};
+
+struct Entry
+{
+	std::string name;
+	bool dir;
+};
+
+struct Dir
+{
+	int64_t mtime = 0;
+	std::vector<Entry> entries; // in readdir order, which filesearch goes by
+	uint32_t seen = 0; // refresh generation
+};
+
+// Filled in on a worker, stored on the main thread
+struct HashJob
+{
+	std::string path;
+	std::string key;
+	uint64_t size;
+	int64_t mtime;
+	std::array<uint8_t, 16> md5;
+	bool ok;
+};
+
+bool stat_file(const std::string& path, uint64_t& size, int64_t& mtime)
+{
+	std::error_code ec;
+
+	size = fs::file_size(path, ec);
+	if (ec)
+	{
+		return false;
+	}
+
+	mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+	return !ec;
+}
+
+bool hash_file(const std::string& path, std::array<uint8_t, 16>& md5)
+{
+	FILE* f = std::fopen(path.c_str(), "rb");
+
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	const bool ok = md5_stream(f, md5.data()) == 0;
+	std::fclose(f);
+	return ok;
+}
+
+// The same path may be spelled differently by different callers
+std::string path_key(const std::string& path)
+{
+	std::error_code ec;
+	fs::path abs = fs::absolute(path, ec);
+	return ec ? path : abs.lexically_normal().string();
+}
+
+// Same spelling filesearch builds, so completepath results don't change
+std::string join(const std::string& dir, const std::string& name)
+{
+	if (!dir.empty() && dir.back() == PATHSEP[0])
+	{
+		return dir + name;
+	}
+	return dir + PATHSEP + name;
+}
+
+std::string lower(std::string s)
+{
+	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+	return s;
+}
+
+class FileCache
+{
+	std::unordered_map<std::string, FileHash> hashes_; // by path_key
+	std::unordered_map<std::string, Dir> dirs_; // by path as searched
+
+	// Lowercased file name -> every path it's at, in search order
+	std::unordered_map<std::string, std::vector<std::string>> names_;
+	std::vector<std::string> roots_;
+	bool names_valid_ = false;
+
+	uint32_t generation_ = 0;
+	bool loaded_ = false;
+	bool dirty_ = false;
+
+	void store(const std::string& key, const FileHash& hash)
+	{
+		hashes_[key] = hash;
+		dirty_ = true;
+	}
+
+	void read_dir(const std::string& path, Dir& dir, int64_t mtime)
+	{
+		std::error_code ec;
+
+		dir.mtime = mtime;
+		dir.entries.clear();
+
+		for (fs::directory_iterator it {path, ec}, end; !ec && it != end; it.increment(ec))
+		{
+			std::error_code stat_ec;
+			const fs::file_status status = it->status(stat_ec); // follows symlinks, like filesearch
+
+			if (stat_ec || !fs::exists(status))
+			{
+				continue; // was the file (re)moved? can't stat it
+			}
+
+			dir.entries.push_back({it->path().filename().string(), fs::is_directory(status)});
+		}
+	}
+
+	bool scan(const std::string& path, int depth)
+	{
+		std::error_code ec;
+		const int64_t mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+
+		if (ec)
+		{
+			return dirs_.erase(path) > 0;
+		}
+
+		bool changed = false;
+		auto [it, added] = dirs_.try_emplace(path);
+		Dir& dir = it->second; // stays valid while the map grows
+
+		// Adding, removing or renaming anything in a directory changes its
+		// modification time. Its files' contents don't, which is fine here.
+		if (added || dir.mtime != mtime)
+		{
+			read_dir(path, dir, mtime);
+			changed = true;
+		}
+
+		dir.seen = generation_;
+
+		if (depth + 1 < kMaxDepth)
+		{
+			for (const Entry& entry : dir.entries)
+			{
+				if (entry.dir)
+				{
+					changed |= scan(join(path, entry.name), depth + 1);
+				}
+			}
+		}
+
+		return changed;
+	}
+
+	void collect(const std::string& path, int depth)
+	{
+		auto it = dirs_.find(path);
+
+		if (it == dirs_.end())
+		{
+			return;
+		}
+
+		// Like filesearch, a subdirectory is searched as soon as it's
+		// come across, before the entries after it. At the bottom it
+		// only gets a name comparison.
+		for (const Entry& entry : it->second.entries)
+		{
+			if (entry.dir && depth + 1 < kMaxDepth)
+			{
+				collect(join(path, entry.name), depth + 1);
+			}
+			else
+			{
+				names_[lower(entry.name)].push_back(join(path, entry.name));
+			}
+		}
+	}
+
+	std::string cache_path() const { return fmt::format("{}/{}", srb2home, kCacheName); }
+
+	void load()
+	{
+		loaded_ = true;
+
+		CacheJson js;
+
+		try
+		{
+			srb2::io::FileStream file {cache_path(), srb2::io::FileStreamMode::kRead};
+			srb2::io::BufferedInputStream bis {std::move(file)};
+
+			if (srb2::io::read_uint32(bis) != kCacheMagic || srb2::io::read_uint8(bis) != kCacheVersion)
+			{
+				return;
+			}
+
+			std::vector<std::byte> remainder = srb2::io::read_to_vec(bis);
+			tcb::span<uint8_t> remainder_as_u8 = tcb::span((uint8_t*)remainder.data(), remainder.size());
+			js = json::from_ubjson(remainder_as_u8).template get<CacheJson>();
+		}
+		catch (...)
+		{
+			return; // No cache yet, or it's unreadable. Start over.
+		}
+
+		for (HashJson& hash : js.hashes)
+		{
+			uint64_t size;
+			int64_t mtime;
+
+			// Forget anything that's been deleted since
+			if (stat_file(hash.path, size, mtime))
+			{
+				hashes_[std::move(hash.path)] = {hash.size, hash.mtime, hash.md5};
+			}
+		}
+
+		// The next refresh reads whatever's changed since
+		for (DirJson& dir : js.dirs)
+		{
+			Dir& d = dirs_[std::move(dir.path)];
+
+			d.mtime = dir.mtime;
+			d.entries.clear();
+			for (EntryJson& entry : dir.entries)
+			{
+				d.entries.push_back({std::move(entry.name), entry.dir});
+			}
+		}
+	}
+
+	void save()
+	{
+		CacheJson js;
+		const std::string path = cache_path();
+		const std::string tmppath = fmt::format("{}_{}.tmp", path, rand());
+
+		js.hashes.reserve(hashes_.size());
+		for (const auto& [key, hash] : hashes_)
+		{
+			js.hashes.push_back({key, hash.size, hash.mtime, hash.md5});
+		}
+
+		js.dirs.reserve(dirs_.size());
+		for (const auto& [key, dir] : dirs_)
+		{
+			DirJson& out = js.dirs.emplace_back();
+
+			out.path = key;
+			out.mtime = dir.mtime;
+			for (const Entry& entry : dir.entries)
+			{
+				out.entries.push_back({entry.name, entry.dir});
+			}
+		}
+
+		try
+		{
+			srb2::io::FileStream file {tmppath, srb2::io::FileStreamMode::kWrite};
+
+			srb2::io::write(kCacheMagic, file);
+			srb2::io::write(kCacheVersion, file);
+
+			std::vector<uint8_t> ubjson = json::to_ubjson(js);
+			srb2::io::write_exact(file, tcb::as_bytes(tcb::make_span(ubjson)));
+			file.close();
+
+			fs::rename(tmppath, path);
+		}
+		catch (const std::exception& ex)
+		{
+			CONS_Alert(CONS_WARNING, "Couldn't save %s: %s\n", kCacheName, ex.what());
+		}
+		catch (...)
+		{
+			CONS_Alert(CONS_WARNING, "Couldn't save %s\n", kCacheName);
+		}
+
+		// Not worth trying again until something else changes
+		dirty_ = false;
+	}
+
+public:
+	void refresh()
+	{
+		std::vector<std::string> roots;
+		bool changed = false;
+
+		// Same order findfile searches them in
+		const char* const search[] = {srb2home, srb2path, "."};
+
+		for (const char* root : search)
+		{
+			if (std::find(roots.begin(), roots.end(), root) == roots.end())
+			{
+				roots.emplace_back(root);
+			}
+		}
+
+		generation_++;
+
+		for (const std::string& root : roots)
+		{
+			changed |= scan(root, 0);
+		}
+
+		// Anything not reached any more is gone
+		for (auto it = dirs_.begin(); it != dirs_.end();)
+		{
+			if (it->second.seen != generation_)
+			{
+				it = dirs_.erase(it);
+				changed = true;
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if (changed)
+		{
+			dirty_ = true;
+		}
+
+		if (changed || !names_valid_ || roots != roots_)
+		{
+			names_.clear();
+			for (const std::string& root : roots)
+			{
+				collect(root, 0);
+			}
+			roots_ = std::move(roots);
+			names_valid_ = true;
+		}
+	}
+
+	void begin()
+	{
+		if (!loaded_)
+		{
+			load();
+		}
+	}
+
+	void end()
+	{
+		if (dirty_)
+		{
+			save();
+		}
+	}
+
+	bool md5(const std::string& path, UINT8* md5sum)
+	{
+		uint64_t size;
+		int64_t mtime;
+
+		if (!stat_file(path, size, mtime))
+		{
+			return false;
+		}
+
+		const std::string key = path_key(path);
+		auto it = hashes_.find(key);
+
+		if (it == hashes_.end() || it->second.size != size || it->second.mtime != mtime)
+		{
+			FileHash hash {size, mtime, {}};
+
+			if (!hash_file(path, hash.md5))
+			{
+				return false;
+			}
+
+			store(key, hash);
+			it = hashes_.find(key);
+		}
+
+		std::memcpy(md5sum, it->second.md5.data(), 16);
+		return true;
+	}
+
+	void precache(const std::vector<std::string>& paths)
+	{
+		std::vector<HashJob> jobs;
+
+		for (const std::string& path : paths)
+		{
+			uint64_t size;
+			int64_t mtime;
+
+			if (!stat_file(path, size, mtime))
+			{
+				continue;
+			}
+
+			std::string key = path_key(path);
+			auto it = hashes_.find(key);
+
+			if (it != hashes_.end() && it->second.size == size && it->second.mtime == mtime)
+			{
+				continue;
+			}
+
+			auto dup = std::find_if(jobs.begin(), jobs.end(), [&key](const HashJob& job) { return job.key == key; });
+
+			if (dup == jobs.end())
+			{
+				jobs.push_back({path, std::move(key), size, mtime, {}, false});
+			}
+		}
+
+		if (jobs.size() > 1 && srb2::g_main_threadpool)
+		{
+			srb2::g_main_threadpool->begin_sema();
+
+			for (HashJob& job : jobs)
+			{
+				HashJob* ptr = &job;
+				srb2::g_main_threadpool->schedule([ptr] { ptr->ok = hash_file(ptr->path, ptr->md5); });
+			}
+
+			srb2::ThreadPool::Sema sema = srb2::g_main_threadpool->end_sema();
+			srb2::g_main_threadpool->notify_sema(sema);
+			srb2::g_main_threadpool->wait_sema(sema);
+		}
+		else
+		{
+			for (HashJob& job : jobs)
+			{
+				job.ok = hash_file(job.path, job.md5);
+			}
+		}
+
+		for (const HashJob& job : jobs)
+		{
+			if (job.ok)
+			{
+				store(job.key, {job.size, job.mtime, job.md5});
+			}
+		}
+	}
+
+	// Call refresh first
+	const std::vector<std::string>* find(const char* name) const
+	{
+		auto it = names_.find(lower(name));
+		return it != names_.end() ? &it->second : nullptr;
+	}
+};
+
+FileCache g_cache;
+
+}; // namespace
+
+boolean W_CachedFileMD5(const char *filename, UINT8 *md5sum)
+{
+	g_cache.begin();
+	const bool ok = g_cache.md5(filename, md5sum);
+	g_cache.end();
+	return ok;
+}
+
+void W_CacheFileMD5s(const char *const *filenames, size_t count)
+{
+	g_cache.begin();
+	g_cache.precache(std::vector<std::string>(filenames, filenames + count));
+	g_cache.end();
+}
+
+filestatus_t W_FindIndexedFile(char *filename, const UINT8 *wantedmd5sum, boolean completepath)
+{
+	filestatus_t retval = FS_NOTFOUND;
+
+#ifdef NOMD5
+	wantedmd5sum = NULL;
+#endif
+
+	g_cache.begin();
+	g_cache.refresh();
+
+	if (const std::vector<std::string>* paths = g_cache.find(filename))
+	{
+		for (const std::string& path : *paths)
+		{
+			UINT8 md5sum[16];
+
+			if (wantedmd5sum)
+			{
+				if (!g_cache.md5(path, md5sum))
+				{
+					continue;
+				}
+
+				if (std::memcmp(wantedmd5sum, md5sum, 16))
+				{
+					retval = FS_MD5SUMBAD;
+					continue;
+				}
+			}
+
+			if (completepath)
+			{
+				strcpy(filename, path.c_str());
+			}
+			else
+			{
+				strcpy(filename, fs::path(path).filename().string().c_str());
+			}
+
+			retval = FS_FOUND;
+			break;
+		}
+	}
+
+	g_cache.end();
+	return retval;
+}
+
+void W_CacheIndexedMD5s(const char *const *filenames, size_t count)
+{
+	std::vector<std::string> paths;
+
+	g_cache.begin();
+	g_cache.refresh();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (const std::vector<std::string>* found = g_cache.find(filenames[i]))
+		{
+			paths.insert(paths.end(), found->begin(), found->end());
+		}
+	}
+
+	g_cache.precache(paths);
+	g_cache.end();
+}
@@ -0,0 +1,42 @@
+// DR. ROBOTNIK'S RING RACERS
+//-----------------------------------------------------------------------------
+// Copyright (C) 2024 by Kart Krew.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  w_filecache.h
+/// \brief Persistent addon MD5 cache, and an index of the search directories
+
+#ifndef __W_FILECACHE_H__
+#define __W_FILECACHE_H__
+
+#include "doomtype.h"
+#include "d_netfil.h" // filestatus_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Puts filename's MD5 in md5sum. The file is only read if its size or
+// modification time changed since it was last hashed, even in an earlier
+// session. Returns false if it can't be read.
+boolean W_CachedFileMD5(const char *filename, UINT8 *md5sum);
+
+// Hashes whichever of these need it, in parallel on the thread pool, so
+// W_CachedFileMD5 has them ready.
+void W_CacheFileMD5s(const char *const *filenames, size_t count);
+
+// Does what filesearch does over srb2home, srb2path and ".", but from an
+// index of them. Only directories modified since the last search are read.
+filestatus_t W_FindIndexedFile(char *filename, const UINT8 *wantedmd5sum, boolean completepath);
+
+// W_CacheFileMD5s for every file W_FindIndexedFile would check for these.
+void W_CacheIndexedMD5s(const char *const *filenames, size_t count);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
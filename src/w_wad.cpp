@@ -68,6 +68,7 @@
 #include "i_time.h"
 #include "i_system.h"
 #include "md5.h"
+#include "w_filecache.h"
 #include "lua_script.h"
 #include "g_game.h" // G_SetGameModified
 
@@ -296,20 +297,12 @@ static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
 	(void)filename;
 	memset(resblock, 0x00, 16);
 #else
-	FILE *fhandle;
-
-	if ((fhandle = fopen(filename, "rb")) != NULL)
+	tic_t t = I_GetTime();
+	CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",filename);
+	if (W_CachedFileMD5(filename, static_cast<UINT8 *>(resblock)))
 	{
-		tic_t t = I_GetTime();
-		CONS_Debug(DBG_SETUP, "Making MD5 for %s\n",filename);
-		if (md5_stream(fhandle, resblock) == 1)
-		{
-			fclose(fhandle);
-			return 1;
-		}
 		CONS_Debug(DBG_SETUP, "MD5 calc for %s took %f seconds\n",
 			filename, (float)(I_GetTime() - t)/NEWTICRATE);
-		fclose(fhandle);
 		return 0;
 	}
 #endif
@@ -972,6 +965,16 @@ INT32 W_InitMultipleFiles(char **filenames, boolean addons)
 	INT32 rc = 1;
 	INT32 overallrc = 1;
 
+#ifndef NOMD5
+	// Hash whatever changed since last time all at once, instead of one by one in W_InitFile
+	{
+		size_t count = 0;
+		while (filenames[count])
+			count++;
+		W_CacheFileMD5s(filenames, count);
+	}
+#endif
+
 	// will be realloced as lumps are added
 	for (; *filenames; filenames++)
 	{